@@ -0,0 +1,359 @@
+////////////////////////////////////////////////////////////////////////////////
+// Microbenchmarks of the solvers' hot paths
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "graph/edge.hpp"
+#include "graph/edge_cost.hpp"
+#include "graph/factory.hpp"
+#include "graph/graph.hpp"
+#include "graph/manhattan.hpp"
+#include "path.hpp"
+#include "statistics.hpp"
+#include "tsp_solver/factory.hpp"
+#include "tsp_solver/fast.hpp"
+#include "tsp_solver/little/branching_rule.hpp"
+#include "tsp_solver/little/cost_matrix.hpp"
+#include "tsp_solver/little/tree_node.hpp"
+#include "tsp_solver/options.hpp"
+#include "tsp_solver/tsp_solver.hpp"
+#include "util.hpp"
+
+#include <gflags/gflags.h>
+
+using std::chrono::duration;
+using std::chrono::steady_clock;
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::function;
+using std::istringstream;
+using std::max;
+using std::mt19937;
+using std::ofstream;
+using std::ostream;
+using std::ostringstream;
+using std::seed_seq;
+using std::sort;
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+static bool ValidateSizes(const char* flag_name, const string& value);
+static bool ValidatePositive(const char* flag_name, int value);
+static bool ValidateMinTime(const char* flag_name, double value);
+
+DEFINE_string(filter, "",
+		"Only run benchmarks whose names contain this string");
+DEFINE_string(sizes, "8,12,16,32,64,256,1024",
+		"Comma separated numbers of vertices to benchmark with");
+DEFINE_int32(seeds, 3, "Random graphs to benchmark each size with");
+DEFINE_double(min_time, 0.2, "Seconds to repeat each benchmark for");
+DEFINE_string(output, "", "File to write the results to instead of stdout");
+
+const bool sizes_validated{gflags::RegisterFlagValidator(
+		&FLAGS_sizes, &ValidateSizes)};
+const bool seeds_validated{gflags::RegisterFlagValidator(
+		&FLAGS_seeds, &ValidatePositive)};
+const bool min_time_validated{gflags::RegisterFlagValidator(
+		&FLAGS_min_time, &ValidateMinTime)};
+
+namespace {
+
+// the solvers whose Solve is benchmarked, and the most vertices each is given,
+// 0 for no limit, since the exact solvers take exponential time
+struct SolverCase {
+	string type;
+	int max_size;
+};
+const vector<SolverCase> solver_cases_c{
+	{"naive", 12}, {"little", 16}, {"portfolio", 16}, {"fast", 0},
+	{"lk", 0}, {"hilbert", 0}, {"mst", 0}, {"multistart", 0}, {"anneal", 0}};
+
+// The times of the repetitions of one benchmark on one graph. Solve
+// benchmarks also keep the tour length and the solver's statistics of the last
+// repetition, so changes in behavior show up next to changes in speed.
+struct Measurement {
+	string name;
+	int size;
+	unsigned seed;
+	vector<double> seconds;
+	bool has_tour{false};
+	int tour_length{0};
+	Statistics statistics;
+};
+
+// the results of the benchmarked code are added here, so the compiler can't
+// leave the code out
+volatile long long sink;
+
+// Runs the body until min_time seconds have passed, and at least once, timing
+// each repetition on its own. The body returns a value computed from its
+// results.
+Measurement Measure(const string& name, int size, unsigned seed,
+		const function<long long()>& body) {
+	Measurement measurement;
+	measurement.name = name;
+	measurement.size = size;
+	measurement.seed = seed;
+	const steady_clock::time_point start{steady_clock::now()};
+	do {
+		const steady_clock::time_point before{steady_clock::now()};
+		sink = sink + body();
+		measurement.seconds.push_back(
+				duration<double>(steady_clock::now() - before).count());
+	} while (duration<double>(steady_clock::now() - start).count() <
+			FLAGS_min_time);
+	return measurement;
+}
+
+// the input for a graph of size points spread uniformly over a world that
+// grows with them, the same for the same size and seed
+string MakeGraphInput(int size, unsigned seed) {
+	seed_seq seeds{seed, unsigned(size)};
+	mt19937 random{seeds};
+	const int world_size{max(100, 10 * size)};
+	ostringstream output;
+	output << world_size << " " << size;
+	for (int i{0}; i < 2 * size; ++i)
+	{ output << " " << random() % world_size; }
+	return output.str();
+}
+
+// A node that includes the first half of a tour's edges, so AddInclude has
+// subtours to walk along as it would deep in the tree
+TreeNode MakeDeepNode(const Graph& graph, const Path& tour) {
+	TreeNode node{graph};
+	const int size{int(tour.vertices.size())};
+	for (int i{0}; i + 1 < size / 2; ++i)
+	{ node.AddInclude(Edge{tour.vertices[i], tour.vertices[i + 1]}); }
+	return node;
+}
+
+void RunGraphBenchmarks(int size, unsigned seed,
+		vector<Measurement>& measurements) {
+	const string input{MakeGraphInput(size, seed)};
+	auto run = [&](const string& name, const function<long long()>& body) {
+		if (name.find(FLAGS_filter) == string::npos) { return; }
+		cerr << name << " size " << size << " seed " << seed << endl;
+		measurements.push_back(Measure(name, size, seed, body));
+	};
+
+	run("ManhattanGraph", [&] {
+		istringstream stream{input};
+		return ManhattanGraph{stream}.GetNumVertices();
+	});
+	// the matrix of EdgeCosts is built the first time one is asked for
+	run("ManhattanGraph/edges", [&] {
+		istringstream stream{input};
+		const ManhattanGraph graph{stream};
+		return graph(0, size - 1)();
+	});
+
+	istringstream stream{input};
+	const ManhattanGraph graph{stream};
+	TreeNode root{graph};
+	const vector<Edge> no_includes;
+
+	// constructing the matrix is cheap next to the reduction, which fills in
+	// the row and column reductions of a fresh one each time
+	run("CostMatrix::ReduceMatrix", [&] {
+		CostMatrix cost_matrix{graph, no_includes, root.GetExcludes()};
+		return cost_matrix.ReduceMatrix();
+	});
+
+	CostMatrix reduced{graph, no_includes, root.GetExcludes()};
+	reduced.ReduceMatrix();
+	run("FindZerosAndPenalties", [&] {
+		return FindZerosAndPenalties(reduced, -1).size();
+	});
+
+	root.CalcLBAndNextEdge();
+	run("TreeNode::MakeIncludeChild", [&] {
+		return TreeNode::MakeIncludeChild(root).GetIncludes().size();
+	});
+	run("TreeNode::MakeExcludeChild", [&] {
+		return TreeNode::MakeExcludeChild(root).GetExcludes()(0, 0);
+	});
+
+	// AddInclude changes the node, so each repetition adds to a copy, and the
+	// time of the copy alone is measured too
+	const Path tour{FastTSPSolver{}.Solve(graph)};
+	const TreeNode deep{MakeDeepNode(graph, tour)};
+	const Edge next_edge{tour.vertices[size / 2 - 1], tour.vertices[size / 2]};
+	run("TreeNode/copy", [&] {
+		TreeNode copy{deep};
+		return copy.GetIncludes().size();
+	});
+	run("TreeNode::AddInclude", [&] {
+		TreeNode copy{deep};
+		copy.AddInclude(next_edge);
+		return copy.GetIncludes().size();
+	});
+}
+
+void RunSolveBenchmarks(int size, unsigned seed,
+		vector<Measurement>& measurements) {
+	istringstream stream{MakeGraphInput(size, seed)};
+	const ManhattanGraph graph{stream};
+
+	// the heuristics stop after a fixed amount of work instead of a time
+	// budget, so every repetition does the same work
+	SolverOptions options;
+	options.time_budget = 0;
+	options.kicks = size;
+	options.starts = 8;
+	options.rounds = 20;
+	options.seed = seed;
+
+	for (const SolverCase& solver_case : solver_cases_c) {
+		const string name{"Solve/" + solver_case.type};
+		if (name.find(FLAGS_filter) == string::npos) { continue; }
+		if (solver_case.max_size > 0 && size > solver_case.max_size)
+		{ continue; }
+		cerr << name << " size " << size << " seed " << seed << endl;
+		unique_ptr<TSPSolver> solver{CreateTSPSolver(
+				solver_case.type, options)};
+		Path tour;
+		measurements.push_back(Measure(name, size, seed, [&] {
+			tour = solver->Solve(graph);
+			return tour.length;
+		}));
+		measurements.back().has_tour = true;
+		measurements.back().tour_length = tour.length;
+		measurements.back().statistics = solver->GetStatistics();
+	}
+}
+
+// the value at the given fraction of the way through the sorted times
+double Quantile(const vector<double>& sorted, double fraction)
+{ return sorted[int(fraction * (sorted.size() - 1) + 0.5)]; }
+
+void WriteJson(ostream& os, const vector<Measurement>& measurements) {
+	const std::time_t now{std::time(nullptr)};
+	char date[32];
+	std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+#ifdef NDEBUG
+	const char* build_type{"release"};
+#else
+	const char* build_type{"debug"};
+#endif
+
+	os << "{\"context\": {\"date\": \"" << date << "\", \"build\": \""
+		<< build_type << "\", \"min_time\": " << FLAGS_min_time
+		<< "},\n\"benchmarks\": [";
+	bool first{true};
+	for (const Measurement& measurement : measurements) {
+		vector<double> sorted{measurement.seconds};
+		sort(sorted.begin(), sorted.end());
+		double total{0};
+		for (double seconds : sorted) { total += seconds; }
+
+		os << (first ? "\n" : ",\n");
+		first = false;
+		os << "{\"name\": \"" << measurement.name << "\", \"size\": "
+			<< measurement.size << ", \"seed\": " << measurement.seed
+			<< ", \"iterations\": " << sorted.size()
+			<< ", \"mean_ns\": " << 1e9 * total / sorted.size()
+			<< ", \"median_ns\": " << 1e9 * Quantile(sorted, 0.5)
+			<< ", \"min_ns\": " << 1e9 * sorted.front();
+		if (measurement.has_tour) {
+			os << ", \"length\": " << measurement.tour_length
+				<< ", \"statistics\": {";
+			bool first_counter{true};
+			for (const auto& counter : measurement.statistics.GetCounters()) {
+				os << (first_counter ? "" : ", ") << "\"" << counter.first
+					<< "\": " << counter.second;
+				first_counter = false;
+			}
+			os << "}";
+		}
+		os << "}";
+	}
+	os << "\n]}" << endl;
+}
+
+vector<int> ParseSizes(const string& value) {
+	vector<int> sizes;
+	istringstream stream{value};
+	string size;
+	while (getline(stream, size, ',')) {
+		try {
+			size_t end;
+			sizes.push_back(std::stoi(size, &end));
+			if (end != size.size() || sizes.back() < 4) { return {}; }
+		} catch (...) { return {}; }
+	}
+	return sizes;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+	gflags::SetUsageMessage(
+			"Microbenchmarks of littletsp's hot paths.\n"
+			"Usage:\n"
+			"\t--filter\t\tOnly run benchmarks whose names contain this "
+			"(Default: all)\n"
+			"\t--sizes\t\t\tComma separated numbers of vertices, each at "
+			"least 4 (Default: 8,12,16,32,64,256,1024)\n"
+			"\t--seeds\t\t\tRandom graphs per size (Default: 3)\n"
+			"\t--min_time\t\tSeconds to repeat each benchmark for "
+			"(Default: 0.2)\n"
+			"\t--output\t\tWrite the JSON results to this file "
+			"(Default: stdout)\n"
+			"\n"
+			"Example:\n"
+			"\tbenchmark --filter=Solve/ --sizes=10,100 --output=before.json\n");
+	gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+	vector<Measurement> measurements;
+	ofstream output;
+	try {
+		// checked before the run, which can take a while
+		if (!FLAGS_output.empty()) {
+			output.open(FLAGS_output);
+			if (!output) { throw Error{"Couldn't open the output file!"}; }
+		}
+		for (int size : ParseSizes(FLAGS_sizes)) {
+			for (int seed{1}; seed <= FLAGS_seeds; ++seed) {
+				RunGraphBenchmarks(size, unsigned(seed), measurements);
+				RunSolveBenchmarks(size, unsigned(seed), measurements);
+			}
+		}
+	} catch (Error& e) {
+		cerr << "Error: " << e.what() << endl;
+		return 1;
+	} catch (ImplementationError& ie) {
+		cerr << "Implementation Error: " << ie.what() << endl;
+		return 2;
+	}
+
+	if (FLAGS_output.empty()) { WriteJson(cout, measurements); }
+	else {
+		WriteJson(output, measurements);
+		if (!output) {
+			cerr << "Error: Couldn't write the output file!" << endl;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+bool ValidateSizes(const char*, const string& value)
+{ return !ParseSizes(value).empty(); }
+
+bool ValidatePositive(const char*, int value) { return value > 0; }
+
+bool ValidateMinTime(const char*, double value) { return value >= 0; }
@@ -0,0 +1,51 @@
+#ifndef GRAPH_DISTANCE_H
+#define GRAPH_DISTANCE_H
+
+#include <cstdlib>
+
+#include <vector>
+
+#include "graph/graph.hpp"
+#include "util.hpp"
+
+// Distances measure between vertices, or between the Points they give for
+// vertices, which heuristics can store next to their other data about each
+// vertex so their loops don't have to look the vertex up.
+
+// The distance between two vertices of a graph through its virtual interface.
+struct GraphDistance {
+	using Point = int;
+
+	Point GetPoint(int vertex) const { return vertex; }
+	int operator()(int from, int to) const
+	{ return graph.GetDistance(from, to); }
+
+	const Graph& graph;
+};
+
+// The manhattan distance between two vertices computed from their points,
+// which the compiler can inline into the loops of a heuristic.
+struct PointDistance {
+	using Point = Coordinate;
+
+	Point GetPoint(int vertex) const { return points[vertex]; }
+	int operator()(int from, int to) const
+	{ return operator()(points[from], points[to]); }
+	int operator()(const Point& from, const Point& to) const
+	{ return std::abs(from.x - to.x) + std::abs(from.y - to.y); }
+
+	const std::vector<Coordinate>& points;
+};
+
+// Calls the function with the fastest distance the graph allows, a
+// PointDistance if the graph has coordinates and a GraphDistance if not, so
+// heuristics can be written once as templates over the distance.
+template <typename Function>
+auto WithDistance(const Graph& graph, Function function)
+		-> decltype(function(GraphDistance{graph})) {
+	const std::vector<Coordinate>* points{graph.GetCoordinates()};
+	if (points) { return function(PointDistance{*points}); }
+	return function(GraphDistance{graph});
+}
+
+#endif  // GRAPH_DISTANCE_H
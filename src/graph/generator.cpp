@@ -0,0 +1,206 @@
+#include "graph/generator.hpp"
+
+#include <cmath>
+#include <cstdint>
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "graph/instance.hpp"
+#include "util.hpp"
+
+using std::max;
+using std::min;
+using std::mt19937_64;
+using std::ostream;
+using std::seed_seq;
+using std::string;
+using std::uint64_t;
+using std::unique_ptr;
+using std::vector;
+
+// the duplicates distribution repeats one of at most this many earlier points
+const int duplicate_pool_size_c{4096};
+const double pi_c{3.14159265358979323846};
+
+namespace {
+
+// The standard library's distributions are allowed to differ between
+// implementations, so the same seed would give different instances on
+// different platforms. These are built straight on mt19937_64, whose output
+// the standard fixes.
+class Random {
+public:
+	explicit Random(unsigned seed) {
+		seed_seq seeds{seed};
+		engine_.seed(seeds);
+	}
+
+	// uniformly from 0 to n inclusive, with a bias too small to matter
+	int Int(int n) { return int(engine_() % (uint64_t(n) + 1)); }
+	// uniformly from [0, 1)
+	double Real() { return (engine_() >> 11) * (1.0 / (uint64_t{1} << 53)); }
+	// from the standard normal distribution, by the Box-Muller transform
+	double Normal() {
+		const double radius{std::sqrt(-2 * std::log(1 - Real()))};
+		return radius * std::cos(2 * pi_c * Real());
+	}
+
+private:
+	mt19937_64 engine_;
+};
+
+int Clamp(double value, int world_size)
+{ return int(min(max(std::lround(value), 0L), long(world_size))); }
+
+class UniformGenerator : public PointGenerator {
+public:
+	explicit UniformGenerator(const InstanceSpec& spec) :
+		random_{spec.seed}, world_size_{spec.world_size} {}
+
+	Coordinate Next() override {
+		const int x{random_.Int(world_size_)};
+		return Coordinate{x, random_.Int(world_size_)};
+	}
+
+private:
+	Random random_;
+	int world_size_;
+};
+
+// points normally distributed around centers spread uniformly over the world,
+// like deliveries around towns
+class ClusteredGenerator : public PointGenerator {
+public:
+	explicit ClusteredGenerator(const InstanceSpec& spec) :
+			random_{spec.seed}, world_size_{spec.world_size},
+			deviation_{spec.spread * spec.world_size} {
+		for (int i{0}; i < max(1, spec.clusters); ++i) {
+			const int x{random_.Int(world_size_)};
+			centers_.push_back(Coordinate{x, random_.Int(world_size_)});
+		}
+	}
+
+	Coordinate Next() override {
+		const Coordinate& center{
+			centers_[random_.Int(int(centers_.size()) - 1)]};
+		const double x{center.x + deviation_ * random_.Normal()};
+		return Coordinate{Clamp(x, world_size_),
+			Clamp(center.y + deviation_ * random_.Normal(), world_size_)};
+	}
+
+private:
+	Random random_;
+	int world_size_;
+	double deviation_;
+	vector<Coordinate> centers_;
+};
+
+// one point near the center of each cell of a square grid, visiting the cells
+// in a scrambled order so the order of the points doesn't give away a tour
+class GridGenerator : public PointGenerator {
+public:
+	explicit GridGenerator(const InstanceSpec& spec) :
+			random_{spec.seed}, world_size_{spec.world_size},
+			num_points_{max(1, spec.num_points)},
+			side_{int(std::ceil(std::sqrt(double(num_points_))))},
+			cell_size_{double(spec.world_size) / side_},
+			jitter_{spec.jitter * cell_size_}, next_{0} {
+		// i -> (multiplier * i + offset) mod num_points is a permutation of
+		// the cells when the multiplier and num_points are coprime
+		multiplier_ = uint64_t(random_.Int(num_points_ - 1)) | 1;
+		while (Gcd(multiplier_, num_points_) != 1) { ++multiplier_; }
+		offset_ = uint64_t(random_.Int(num_points_ - 1));
+	}
+
+	Coordinate Next() override {
+		const int cell{int((multiplier_ * next_ + offset_) % num_points_)};
+		next_ = (next_ + 1) % num_points_;
+		const double x{(cell % side_ + 0.5) * cell_size_ +
+			jitter_ * (2 * random_.Real() - 1)};
+		const double y{(cell / side_ + 0.5) * cell_size_ +
+			jitter_ * (2 * random_.Real() - 1)};
+		return Coordinate{Clamp(x, world_size_), Clamp(y, world_size_)};
+	}
+
+private:
+	static uint64_t Gcd(uint64_t a, uint64_t b) {
+		while (b) {
+			const uint64_t remainder{a % b};
+			a = b;
+			b = remainder;
+		}
+		return a;
+	}
+
+	Random random_;
+	int world_size_;
+	int num_points_;
+	int side_;  // cells along each side of the grid
+	double cell_size_;
+	double jitter_;
+	uint64_t multiplier_, offset_;
+	uint64_t next_;
+};
+
+// uniform points, each repeated by later points with the given probability,
+// like several deliveries to one address
+class DuplicatesGenerator : public PointGenerator {
+public:
+	explicit DuplicatesGenerator(const InstanceSpec& spec) :
+		random_{spec.seed}, world_size_{spec.world_size},
+		duplicate_fraction_{spec.duplicate_fraction} {}
+
+	Coordinate Next() override {
+		if (!pool_.empty() && random_.Real() < duplicate_fraction_)
+		{ return pool_[random_.Int(int(pool_.size()) - 1)]; }
+
+		const int x{random_.Int(world_size_)};
+		const Coordinate point{x, random_.Int(world_size_)};
+		// once the pool is full, new points replace old ones, so memory stays
+		// constant however many points are made
+		if (int(pool_.size()) < duplicate_pool_size_c) {
+			pool_.push_back(point);
+		} else {
+			pool_[random_.Int(duplicate_pool_size_c - 1)] = point;
+		}
+		return point;
+	}
+
+private:
+	Random random_;
+	int world_size_;
+	double duplicate_fraction_;
+	vector<Coordinate> pool_;
+};
+
+}  // namespace
+
+bool IsValidDistribution(const string& distribution) {
+	return distribution == "uniform" || distribution == "clustered" ||
+		distribution == "grid" || distribution == "duplicates";
+}
+
+unique_ptr<PointGenerator> CreatePointGenerator(const InstanceSpec& spec) {
+	if (spec.distribution == "uniform")
+	{ return unique_ptr<PointGenerator>{new UniformGenerator{spec}}; }
+	if (spec.distribution == "clustered")
+	{ return unique_ptr<PointGenerator>{new ClusteredGenerator{spec}}; }
+	if (spec.distribution == "grid")
+	{ return unique_ptr<PointGenerator>{new GridGenerator{spec}}; }
+	if (spec.distribution == "duplicates")
+	{ return unique_ptr<PointGenerator>{new DuplicatesGenerator{spec}}; }
+	throw Error{"Not a valid distribution!"};
+}
+
+void WriteInstance(ostream& os, const InstanceSpec& spec,
+		const string& format) {
+	unique_ptr<PointGenerator> generator{CreatePointGenerator(spec)};
+	InstanceWriter writer{os, format, spec.world_size, spec.num_points};
+	for (int i{0}; i < spec.num_points; ++i) { writer.Write(generator->Next()); }
+	writer.Flush();
+}
@@ -0,0 +1,51 @@
+#ifndef GRAPH_GENERATOR_H
+#define GRAPH_GENERATOR_H
+
+#include <iosfwd>
+#include <memory>
+#include <string>
+
+#include "util.hpp"
+
+// "uniform", "clustered", "grid" or "duplicates"
+bool IsValidDistribution(const std::string& distribution);
+
+// Describes a random instance. The same description always gives the same
+// points.
+struct InstanceSpec {
+	// how the points are spread, see IsValidDistribution
+	std::string distribution{"uniform"};
+	int num_points{10};
+	// coordinates are from 0 to world_size
+	int world_size{100};
+	unsigned seed{1};
+	// clustered points are normally distributed around this many centers,
+	// with a standard deviation of spread times the world size
+	int clusters{8};
+	double spread{0.05};
+	// grid points are moved from the centers of their cells by up to this
+	// fraction of the cell size in each direction
+	double jitter{0.25};
+	// duplicates repeat an earlier point with this probability
+	double duplicate_fraction{0.5};
+};
+
+/* Makes the points of an instance one at a time in constant memory, so
+ * instances of millions of points can be streamed out as they are made.
+ */
+class PointGenerator {
+public:
+	virtual ~PointGenerator() {}
+
+	// the next point, which is in [0, world_size] in both coordinates
+	virtual Coordinate Next() = 0;
+};
+
+// throws Error if the distribution isn't valid
+std::unique_ptr<PointGenerator> CreatePointGenerator(const InstanceSpec& spec);
+
+// writes the instance in the given format, see IsValidInstanceFormat
+void WriteInstance(std::ostream& os, const InstanceSpec& spec,
+		const std::string& format);
+
+#endif  // GRAPH_GENERATOR_H
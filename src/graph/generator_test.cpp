@@ -0,0 +1,127 @@
+#include "graph/generator.hpp"
+
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "graph/factory.hpp"
+#include "graph/graph.hpp"
+#include "util.hpp"
+
+#include "gtest/gtest.h"
+
+using std::istringstream;
+using std::ostringstream;
+using std::pair;
+using std::set;
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+const vector<string> distributions{"uniform", "clustered", "grid", "duplicates"};
+
+static string Write(const InstanceSpec& spec, const string& format) {
+	ostringstream output;
+	WriteInstance(output, spec, format);
+	return output.str();
+}
+
+TEST(GeneratorTest, SameInstanceFromSameSeed) {
+	for (const string& distribution : distributions) {
+		InstanceSpec spec;
+		spec.distribution = distribution;
+		spec.num_points = 200;
+		EXPECT_EQ(Write(spec, "text"), Write(spec, "text")) << distribution;
+		const string first{Write(spec, "text")};
+		spec.seed = 2;
+		EXPECT_NE(first, Write(spec, "text")) << distribution;
+	}
+}
+
+TEST(GeneratorTest, TextAndBinaryGiveSameGraph) {
+	for (const string& distribution : distributions) {
+		InstanceSpec spec;
+		spec.distribution = distribution;
+		spec.num_points = 300;
+		spec.world_size = 1000;
+		istringstream text{Write(spec, "text")};
+		istringstream binary{Write(spec, "binary")};
+		unique_ptr<Graph> text_graph{CreateGraph("manhattan", text)};
+		unique_ptr<Graph> binary_graph{CreateGraph("manhattan", binary)};
+
+		ASSERT_EQ(300, text_graph->GetNumVertices());
+		ASSERT_EQ(300, binary_graph->GetNumVertices());
+		const vector<Coordinate>& points{*text_graph->GetCoordinates()};
+		const vector<Coordinate>& binary_points{
+			*binary_graph->GetCoordinates()};
+		for (int i{0}; i < 300; ++i) {
+			EXPECT_EQ(points[i].x, binary_points[i].x);
+			EXPECT_EQ(points[i].y, binary_points[i].y);
+			EXPECT_GE(points[i].x, 0);
+			EXPECT_LE(points[i].x, 1000);
+			EXPECT_GE(points[i].y, 0);
+			EXPECT_LE(points[i].y, 1000);
+		}
+	}
+}
+
+TEST(GeneratorTest, BadBinaryInstances) {
+	InstanceSpec spec;
+	spec.num_points = 20000;
+	const string instance{Write(spec, "binary")};
+	istringstream whole{instance};
+	EXPECT_EQ(20000, CreateGraph("manhattan", whole)->GetNumVertices());
+
+	istringstream truncated{instance.substr(0, instance.size() - 4)};
+	EXPECT_THROW(CreateGraph("manhattan", truncated), Error);
+
+	// a header that claims more points than fit in memory
+	string huge{instance.substr(0, 16)};
+	huge[12] = huge[13] = huge[14] = '\xff';
+	huge[15] = '\x7f';
+	istringstream huge_input{huge};
+	EXPECT_THROW(CreateGraph("manhattan", huge_input), Error);
+	huge[15] = '\x3f';
+	istringstream large_input{huge};
+	EXPECT_THROW(CreateGraph("manhattan", large_input), Error);
+}
+
+TEST(GeneratorTest, Distributions) {
+	InstanceSpec spec;
+	spec.num_points = 1000;
+	spec.world_size = 10000;
+	auto distinct = [&spec](const string& distribution) {
+		spec.distribution = distribution;
+		unique_ptr<PointGenerator> generator{CreatePointGenerator(spec)};
+		set<pair<int, int>> points;
+		for (int i{0}; i < spec.num_points; ++i) {
+			const Coordinate point{generator->Next()};
+			points.insert({point.x, point.y});
+		}
+		return int(points.size());
+	};
+	// about half of the duplicates points repeat others
+	EXPECT_LT(distinct("duplicates"), 600);
+	EXPECT_GT(distinct("duplicates"), 400);
+
+	// every cell of the grid gets one point, in no particular order
+	spec.distribution = "grid";
+	spec.jitter = 0;
+	spec.num_points = 100;
+	unique_ptr<PointGenerator> generator{CreatePointGenerator(spec)};
+	set<pair<int, int>> cells;
+	bool in_order{true};
+	for (int i{0}; i < 100; ++i) {
+		const Coordinate point{generator->Next()};
+		cells.insert({point.x / 1000, point.y / 1000});
+		in_order = in_order && point.x / 1000 == i % 10;
+	}
+	EXPECT_EQ(100, int(cells.size()));
+	EXPECT_FALSE(in_order);
+
+	spec.distribution = "normal";
+	EXPECT_THROW(CreatePointGenerator(spec), Error);
+}
@@ -2,8 +2,13 @@
 
 #include <iostream>
 
+#include "graph/edge_cost.hpp"
+
 using std::ostream;
 
+int Graph::GetDistance(int from, int to) const
+{ return operator()(from, to)(); }
+
 ostream& operator<<(ostream& os, const Graph& graph) {
 	os << graph.Describe();
 	return os;
@@ -2,7 +2,9 @@
 #define GRAPH_H
 
 #include <iosfwd>
+#include <vector>
 
+struct Coordinate;
 struct Edge;
 struct EdgeCost;
 
@@ -18,6 +20,16 @@ public:
 	virtual EdgeCost& operator()(const Edge& e) = 0;
 	virtual int GetNumVertices() const = 0;
 
+	// the cost of the edge as a plain integer, which graphs can compute without
+	// storing an EdgeCost for every edge, so heuristics for large graphs should
+	// use this instead of the operators
+	virtual int GetDistance(int from, int to) const;
+
+	// the point each vertex is at, if the distances are the manhattan
+	// distances between them, null otherwise
+	virtual const std::vector<Coordinate>* GetCoordinates() const
+	{ return nullptr; }
+
 	// output information about the graph
 	virtual std::string Describe() const = 0;
 };
@@ -0,0 +1,136 @@
+#include "graph/instance.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "util.hpp"
+
+using std::int32_t;
+using std::istream;
+using std::min;
+using std::numeric_limits;
+using std::ostream;
+using std::string;
+using std::vector;
+
+const char instance_magic_c[]{"LTSI"};
+const int instance_magic_size_c{4};
+const int32_t instance_version_c{1};
+// points are written out once the buffer holds about this many bytes
+const int buffer_size_c{1 << 16};
+
+static void AppendInt(vector<char>& buffer, int32_t value);
+static void AppendNumber(vector<char>& buffer, int value);
+static int32_t ReadInt(istream& is);
+
+bool IsValidInstanceFormat(const string& format)
+{ return format == "text" || format == "binary"; }
+
+InstanceWriter::InstanceWriter(ostream& os, const string& format,
+		int world_size, int num_points) : os_(os), binary_{format == "binary"} {
+	if (!IsValidInstanceFormat(format))
+	{ throw Error{"Not a valid instance format!"}; }
+	buffer_.reserve(buffer_size_c + 32);
+	if (binary_) {
+		buffer_.insert(buffer_.end(), instance_magic_c,
+				instance_magic_c + instance_magic_size_c);
+		AppendInt(buffer_, instance_version_c);
+		AppendInt(buffer_, world_size);
+		AppendInt(buffer_, num_points);
+	} else {
+		AppendNumber(buffer_, world_size);
+		buffer_.push_back('\n');
+		AppendNumber(buffer_, num_points);
+		buffer_.push_back('\n');
+	}
+}
+
+InstanceWriter::~InstanceWriter() {
+	// a destructor can't report a failed stream, so Flush should be called
+	// first by anyone who wants to know
+	try { Flush(); } catch (...) {}
+}
+
+void InstanceWriter::Write(const Coordinate& point) {
+	if (binary_) {
+		AppendInt(buffer_, point.x);
+		AppendInt(buffer_, point.y);
+	} else {
+		// formatting by hand is several times faster than through the stream
+		AppendNumber(buffer_, point.x);
+		buffer_.push_back(' ');
+		AppendNumber(buffer_, point.y);
+		buffer_.push_back('\n');
+	}
+	if (int(buffer_.size()) >= buffer_size_c) { Flush(); }
+}
+
+void InstanceWriter::Flush() {
+	os_.write(buffer_.data(), buffer_.size());
+	buffer_.clear();
+	if (!os_) { throw Error{"Couldn't write the instance!"}; }
+}
+
+bool IsBinaryInstance(istream& is)
+{ return is.peek() == instance_magic_c[0]; }
+
+void ReadBinaryInstance(istream& is, int& world_size,
+		vector<Coordinate>& points) {
+	char magic[instance_magic_size_c];
+	is.read(magic, instance_magic_size_c);
+	if (!is || std::memcmp(magic, instance_magic_c, instance_magic_size_c))
+	{ throw Error{"Not a binary instance!"}; }
+	if (ReadInt(is) != instance_version_c)
+	{ throw Error{"Unsupported binary instance version!"}; }
+	world_size = ReadInt(is);
+	const int num_points{ReadInt(is)};
+	if (num_points < 0 || num_points > numeric_limits<int>::max() / 2)
+	{ throw Error{"Couldn't read number of vertices"}; }
+
+	// the header isn't trusted with the size of the points, they're read a
+	// buffer at a time so a truncated instance fails before much is allocated
+	points.clear();
+	vector<int32_t> values(buffer_size_c / sizeof(int32_t));
+	const int chunk_points{int(values.size()) / 2};
+	for (int first{0}; first < num_points; first += chunk_points) {
+		const int count{min(chunk_points, num_points - first)};
+		is.read(reinterpret_cast<char*>(values.data()),
+				2 * count * sizeof(int32_t));
+		if (!is) { throw Error{"Fewer coordinates than vertices!"}; }
+		for (int i{0}; i < count; ++i)
+		{ points.push_back(Coordinate{values[2 * i], values[2 * i + 1]}); }
+	}
+}
+
+void AppendInt(vector<char>& buffer, int32_t value) {
+	const char* bytes{reinterpret_cast<const char*>(&value)};
+	buffer.insert(buffer.end(), bytes, bytes + sizeof(value));
+}
+
+void AppendNumber(vector<char>& buffer, int value) {
+	long long magnitude{value};
+	if (magnitude < 0) {
+		buffer.push_back('-');
+		magnitude = -magnitude;
+	}
+	char digits[16];
+	int num_digits{0};
+	do {
+		digits[num_digits++] = char('0' + magnitude % 10);
+		magnitude /= 10;
+	} while (magnitude);
+	while (num_digits) { buffer.push_back(digits[--num_digits]); }
+}
+
+int32_t ReadInt(istream& is) {
+	int32_t value;
+	is.read(reinterpret_cast<char*>(&value), sizeof(value));
+	if (!is) { throw Error{"Binary instance ended early!"}; }
+	return value;
+}
@@ -0,0 +1,44 @@
+#ifndef GRAPH_INSTANCE_H
+#define GRAPH_INSTANCE_H
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "util.hpp"
+
+// "text" is the format described in the README, "binary" is a magic number
+// "LTSI" and version, followed by the world size, the number of points and
+// their coordinates as 32-bit integers in the host's byte order
+bool IsValidInstanceFormat(const std::string& format);
+
+/* Writes the points of an instance one at a time, so instances too large to
+ * keep in memory can be streamed. Points are buffered and written in blocks.
+ */
+class InstanceWriter {
+public:
+	InstanceWriter(std::ostream& os, const std::string& format, int world_size,
+			int num_points);
+	// writes whatever is still buffered
+	~InstanceWriter();
+
+	InstanceWriter(const InstanceWriter&) = delete;
+	InstanceWriter& operator=(const InstanceWriter&) = delete;
+
+	void Write(const Coordinate& point);
+	// writes the buffered points out, throws Error if the stream failed
+	void Flush();
+
+private:
+	std::ostream& os_;
+	bool binary_;
+	std::vector<char> buffer_;
+};
+
+// whether the stream starts with a binary instance, without reading from it
+bool IsBinaryInstance(std::istream& is);
+// reads a binary instance, throws Error if the stream doesn't hold one
+void ReadBinaryInstance(std::istream& is, int& world_size,
+		std::vector<Coordinate>& points);
+
+#endif  // GRAPH_INSTANCE_H
@@ -1,16 +1,20 @@
 #include "graph/manhattan.hpp"
 
 #include <iostream>
+#include <mutex>
 #include <string>
 #include <sstream>
 #include <vector>
 
 #include "graph/edge.hpp"
 #include "graph/edge_cost.hpp"
+#include "graph/instance.hpp"
+#include "profile.hpp"
 #include "util.hpp"
 
 using std::cin;
 using std::endl;
+using std::call_once;
 using std::istream;
 using std::ostream;
 using std::string;
@@ -18,8 +22,15 @@ using std::stringstream;
 using std::vector;
 
 ManhattanGraph::ManhattanGraph(istream& input = cin) {
+	PROFILE_SCOPE(kGraphParse);
+	// instances written by tspgen --format=binary
+	if (IsBinaryInstance(input)) {
+		ReadBinaryInstance(input, world_size_, vertices_);
+		num_vertices_ = int(vertices_.size());
+		return;
+	}
+
 	int line_num{0};
-	vector<Coordinate> vertices;
 
 	// read the map in
 	while (true) {
@@ -29,7 +40,6 @@ ManhattanGraph::ManhattanGraph(istream& input = cin) {
 			if (!input) { throw Error{"Couldn't read the world size"}; }
 		} else if (line_num == 1) {
 			input >> num_vertices_;
-			edges_.SetSize(num_vertices_);
 			if (!input) { throw Error{"Couldn't read number of vertices"}; }
 		} else {
 		// otherwise, get the coordinates
@@ -43,39 +53,38 @@ ManhattanGraph::ManhattanGraph(istream& input = cin) {
 			// if we've reached the end of the file, assume we've read all
 			// vertices
 			} else if (!input) { break; }
-			vertices.push_back(Coordinate{coord1, coord2});
+			vertices_.push_back(Coordinate{coord1, coord2});
 		}
 		line_num++;
 	}
 
-	// make and store EdgeCosts
-	for (int row{0}; row < GetNumVertices(); ++row) {
-		for (int column{0}; column < GetNumVertices(); ++column) {
-			edges_(row, column) = EdgeCost{
-				abs(vertices[row].x - vertices[column].x) +
-					abs(vertices[row].y - vertices[column].y),
-					Edge{row, column}};
-		}
-	}
+	if (int(vertices_.size()) < num_vertices_)
+	{ throw Error{"Fewer coordinates than vertices!"}; }
+	// coordinates past the number of vertices are ignored
+	vertices_.resize(num_vertices_);
 }
 
 const EdgeCost& ManhattanGraph::operator()(int from, int to) const {
 	ValidateEdge(from, to);
+	BuildEdges();
 	return edges_(from, to);
 }
 
 EdgeCost& ManhattanGraph::operator()(int from, int to) {
 	ValidateEdge(from, to);
+	BuildEdges();
 	return edges_(from, to);
 }
 
 const EdgeCost& ManhattanGraph::operator()(const Edge& e) const {
 	ValidateEdge(e.u, e.v);
+	BuildEdges();
 	return edges_(e.u, e.v);
 }
 
 EdgeCost& ManhattanGraph::operator()(const Edge& e) {
 	ValidateEdge(e.u, e.v);
+	BuildEdges();
 	return edges_(e.u, e.v);
 }
 
@@ -100,6 +109,20 @@ string ManhattanGraph::Describe() const {
 	return ss.str();
 }
 
+void ManhattanGraph::BuildEdges() const {
+	// solvers on several threads may ask at once
+	call_once(edges_built_, [this] {
+		PROFILE_SCOPE(kGraphEdges);
+		edges_.SetSize(num_vertices_);
+		for (int row{0}; row < num_vertices_; ++row) {
+			for (int column{0}; column < num_vertices_; ++column) {
+				edges_(row, column) =
+					EdgeCost{GetDistance(row, column), Edge{row, column}};
+			}
+		}
+	});
+}
+
 void ManhattanGraph::ValidateEdge(int from, int to) const {
 	if (from < 0 || from > num_vertices_ || to < 0 || to > num_vertices_) {
 		stringstream msg;
@@ -1,12 +1,16 @@
 #ifndef MANHATTAN_GRAPH_H
 #define MANHATTAN_GRAPH_H
 
+#include <cstdlib>
+
 #include <iosfwd>
+#include <mutex>
 #include <sstream>
 #include <vector>
 
 #include "graph.hpp"
 #include "matrix.hpp"
+#include "util.hpp"
 
 struct Edge;
 struct EdgeCost;
@@ -22,6 +26,12 @@ public:
 	EdgeCost& operator()(const Edge& e) override;
 	const EdgeCost& operator()(const Edge& e) const override;
 	int GetNumVertices() const override { return num_vertices_; }
+	int GetDistance(int from, int to) const override {
+		return std::abs(vertices_[from].x - vertices_[to].x) +
+			std::abs(vertices_[from].y - vertices_[to].y);
+	}
+	const std::vector<Coordinate>* GetCoordinates() const override
+	{ return &vertices_; }
 
 	// outputs size of wold, number of vertices, and then the graph itself
 	std::string Describe() const override;
@@ -30,9 +40,15 @@ private:
 	// helper to make sure edges are in bounds
 	void ValidateEdge(int from, int to) const;
 
+	// fills in edges_ the first time an EdgeCost is asked for, so solvers that
+	// only need distances work on graphs too large for a matrix of them
+	void BuildEdges() const;
+
 	int world_size_;
 	int num_vertices_;
-	Matrix<EdgeCost> edges_;
+	std::vector<Coordinate> vertices_;
+	mutable std::once_flag edges_built_;
+	mutable Matrix<EdgeCost> edges_;
 };
 
 #endif  // MANHATTAN_GRAPH_H
@@ -0,0 +1,38 @@
+#include "graph/manhattan.hpp"
+
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include "graph/edge.hpp"
+#include "graph/factory.hpp"
+#include "graph/graph.hpp"
+#include "graph/neighbors.hpp"
+#include "graph/spanning_tree.hpp"
+#include "util.hpp"
+
+#include "gtest/gtest.h"
+
+using std::istringstream;
+using std::unique_ptr;
+using std::vector;
+
+TEST(ManhattanGraphTest, IgnoresTrailingCoordinates) {
+	istringstream input{"100 4 0 0 10 0 10 10 0 10 50 50 60 60"};
+	unique_ptr<Graph> graph{CreateGraph("manhattan", input)};
+	ASSERT_EQ(4, graph->GetNumVertices());
+	ASSERT_EQ(4u, graph->GetCoordinates()->size());
+
+	for (const vector<int>& neighbors : NearestNeighbors(*graph, 5)) {
+		EXPECT_EQ(3u, neighbors.size());
+		for (int neighbor : neighbors) { EXPECT_LT(neighbor, 4); }
+	}
+	const vector<Edge> tree{MinimumSpanningTree(*graph)};
+	EXPECT_EQ(3u, tree.size());
+	EXPECT_EQ(30, SpanningTreeLowerBound(*graph));
+}
+
+TEST(ManhattanGraphTest, FewerCoordinatesThanVertices) {
+	istringstream input{"10 3 1 2"};
+	EXPECT_THROW(CreateGraph("manhattan", input), Error);
+}
@@ -0,0 +1,64 @@
+#include "graph/neighbors.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include "graph/distance.hpp"
+#include "graph/graph.hpp"
+#include "graph/spatial_index.hpp"
+#include "util.hpp"
+
+using std::min;
+using std::vector;
+
+template <typename Distance>
+static vector<vector<int>> FindNearest(int num_vertices, int count,
+		const Distance& distance);
+
+vector<vector<int>> NearestNeighbors(const Graph& graph, int count) {
+	const int num_vertices{graph.GetNumVertices()};
+	count = min(count, num_vertices - 1);
+	if (count <= 0) { return vector<vector<int>>(num_vertices); }
+
+	const vector<Coordinate>* points{graph.GetCoordinates()};
+	if (points) {
+		const SpatialIndex index{*points};
+		vector<vector<int>> neighbors;
+		for (int vertex{0}; vertex < num_vertices; ++vertex)
+		{ neighbors.push_back(index.Nearest((*points)[vertex], count, vertex)); }
+		return neighbors;
+	}
+	return WithDistance(graph, [&](const auto& distance)
+			{ return FindNearest(num_vertices, count, distance); });
+}
+
+template <typename Distance>
+vector<vector<int>> FindNearest(int num_vertices, int count,
+		const Distance& distance) {
+	vector<typename Distance::Point> points;
+	for (int vertex{0}; vertex < num_vertices; ++vertex)
+	{ points.push_back(distance.GetPoint(vertex)); }
+
+	vector<vector<int>> neighbors(num_vertices);
+	// the nearest vertices found so far and their distances, kept sorted by
+	// insertion, since most vertices are farther than all of them
+	vector<int> nearest(count);
+	vector<int> distances(count);
+	for (int vertex{0}; vertex < num_vertices; ++vertex) {
+		int found{0};
+		for (int other{0}; other < num_vertices; ++other) {
+			if (other == vertex) { continue; }
+			const int to_other{distance(points[vertex], points[other])};
+			if (found == count && to_other >= distances[count - 1]) { continue; }
+			int i{found == count ? count - 1 : found++};
+			for (; i > 0 && distances[i - 1] > to_other; --i) {
+				nearest[i] = nearest[i - 1];
+				distances[i] = distances[i - 1];
+			}
+			nearest[i] = other;
+			distances[i] = to_other;
+		}
+		neighbors[vertex] = nearest;
+	}
+	return neighbors;
+}
@@ -0,0 +1,15 @@
+#ifndef GRAPH_NEIGHBORS_H
+#define GRAPH_NEIGHBORS_H
+
+#include <vector>
+
+class Graph;
+
+// For each vertex, the count vertices nearest to it, nearest first, or all the
+// other vertices if there are fewer. Local search only tries moves that add an
+// edge to one of these, which keeps each pass close to linear in the number of
+// vertices. Takes O(N log N) time with a SpatialIndex if the graph has
+// coordinates, and O(N^2) time if not.
+std::vector<std::vector<int>> NearestNeighbors(const Graph& graph, int count);
+
+#endif  // GRAPH_NEIGHBORS_H
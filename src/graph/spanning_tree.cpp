@@ -0,0 +1,160 @@
+#include "graph/spanning_tree.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <vector>
+
+#include "graph/distance.hpp"
+#include "graph/edge.hpp"
+#include "graph/graph.hpp"
+#include "util.hpp"
+
+using std::greater;
+using std::iota;
+using std::map;
+using std::numeric_limits;
+using std::sort;
+using std::swap;
+using std::vector;
+
+// an edge that may be in the tree, with its length
+struct CandidateEdge {
+	int length;
+	Edge edge;
+};
+
+static vector<CandidateEdge> FindOctantEdges(vector<Coordinate> points);
+static vector<Edge> Kruskal(int num_vertices, vector<CandidateEdge>& edges);
+template <typename Distance>
+static vector<Edge> Prim(int num_vertices, const Distance& distance);
+
+vector<Edge> MinimumSpanningTree(const Graph& graph) {
+	const int num_vertices{graph.GetNumVertices()};
+	const vector<Coordinate>* points{graph.GetCoordinates()};
+	if (points) {
+		vector<CandidateEdge> edges{FindOctantEdges(*points)};
+		return Kruskal(num_vertices, edges);
+	}
+	return Prim(num_vertices, GraphDistance{graph});
+}
+
+int SpanningTreeLowerBound(const Graph& graph) {
+	int length{0};
+	for (const Edge& edge : MinimumSpanningTree(graph))
+	{ length += graph.GetDistance(edge.u, edge.v); }
+	return length;
+}
+
+// For each point, the nearest point in each octant around it. Each pass
+// handles one octant: it visits the points in order of x + y, and keeps the
+// points that have not found their nearest point in the octant yet in a map
+// by y. The points in the map that the visited point lies in the octant of
+// are together in it, and the visited point is the nearest to all of them, so
+// they are taken out. The points are then reflected so the next pass handles
+// the next octant, and the opposite octants are covered by the edges found
+// from the other end.
+vector<CandidateEdge> FindOctantEdges(vector<Coordinate> points) {
+	vector<int> order(points.size());
+	iota(order.begin(), order.end(), 0);
+	vector<CandidateEdge> edges;
+	for (int pass{0}; pass < 4; ++pass) {
+		sort(order.begin(), order.end(), [&points](int a, int b) {
+			return points[a].x + points[a].y < points[b].x + points[b].y;
+		});
+		// the points waiting for their nearest point, by y, highest first
+		map<int, int, greater<int>> waiting;
+		for (int point : order) {
+			const Coordinate& visited{points[point]};
+			auto it = waiting.lower_bound(visited.y);
+			auto first = it;
+			for (; it != waiting.end(); ++it) {
+				const Coordinate& other{points[it->second]};
+				const int dx{visited.x - other.x};
+				const int dy{visited.y - other.y};
+				if (dy > dx) { break; }
+				edges.push_back(CandidateEdge{dx + dy, Edge{point, it->second}});
+			}
+			waiting.erase(first, it);
+			waiting[visited.y] = point;
+		}
+		for (Coordinate& point : points) {
+			if (pass % 2) { point.x = -point.x; }
+			else { swap(point.x, point.y); }
+		}
+	}
+	return edges;
+}
+
+// Takes the shortest edges that join two parts of the tree built so far, with
+// the parts kept in a union-find forest.
+vector<Edge> Kruskal(int num_vertices, vector<CandidateEdge>& edges) {
+	sort(edges.begin(), edges.end(),
+			[](const CandidateEdge& a, const CandidateEdge& b)
+			{ return a.length < b.length; });
+
+	vector<int> parents(num_vertices);
+	iota(parents.begin(), parents.end(), 0);
+	auto find_root = [&parents](int vertex) {
+		while (parents[vertex] != vertex) {
+			parents[vertex] = parents[parents[vertex]];
+			vertex = parents[vertex];
+		}
+		return vertex;
+	};
+
+	vector<Edge> tree;
+	for (const CandidateEdge& candidate : edges) {
+		const int u{find_root(candidate.edge.u)};
+		const int v{find_root(candidate.edge.v)};
+		if (u == v) { continue; }
+		parents[u] = v;
+		tree.push_back(candidate.edge);
+		if (int(tree.size()) == num_vertices - 1) { break; }
+	}
+	if (num_vertices > 0 && int(tree.size()) != num_vertices - 1)
+	{ throw ImplementationError{"The octant edges don't span the graph!"}; }
+	return tree;
+}
+
+// Grows the tree from vertex 0, adding the vertex nearest to it each time.
+template <typename Distance>
+vector<Edge> Prim(int num_vertices, const Distance& distance) {
+	vector<Edge> tree;
+	if (num_vertices == 0) { return tree; }
+
+	// the vertices not in the tree, with the nearest vertex in the tree to
+	// each one and the distance to it at the same index
+	vector<int> remaining;
+	vector<int> nearest;
+	vector<int> distances;
+	for (int vertex{1}; vertex < num_vertices; ++vertex) {
+		remaining.push_back(vertex);
+		nearest.push_back(0);
+		distances.push_back(numeric_limits<int>::max());
+	}
+
+	int added{0};
+	while (!remaining.empty()) {
+		int chosen{0};
+		for (int i{0}; i < int(remaining.size()); ++i) {
+			const int to_added{distance(added, remaining[i])};
+			if (to_added < distances[i]) {
+				distances[i] = to_added;
+				nearest[i] = added;
+			}
+			if (distances[i] < distances[chosen]) { chosen = i; }
+		}
+		added = remaining[chosen];
+		tree.push_back(Edge{nearest[chosen], added});
+		remaining[chosen] = remaining.back();
+		remaining.pop_back();
+		nearest[chosen] = nearest.back();
+		nearest.pop_back();
+		distances[chosen] = distances.back();
+		distances.pop_back();
+	}
+	return tree;
+}
@@ -0,0 +1,21 @@
+#ifndef GRAPH_SPANNING_TREE_H
+#define GRAPH_SPANNING_TREE_H
+
+#include <vector>
+
+#include "graph/edge.hpp"
+
+class Graph;
+
+// The edges of a minimum spanning tree of the graph, which is taken to be
+// undirected. On a graph with coordinates this takes O(N log N) time: only the
+// edge from each point to the nearest point in each of the eight octants
+// around it can be in the tree, and a sweep over the points finds them without
+// looking at every pair. Otherwise it is Prim's algorithm in O(N^2) time.
+std::vector<Edge> MinimumSpanningTree(const Graph& graph);
+
+// The length of a minimum spanning tree of the graph. Removing any edge from a
+// tour leaves a spanning tree, so no tour is shorter than this.
+int SpanningTreeLowerBound(const Graph& graph);
+
+#endif  // GRAPH_SPANNING_TREE_H
@@ -0,0 +1,52 @@
+#include "graph/spanning_tree.hpp"
+
+#include <memory>
+#include <vector>
+
+#include "graph/edge.hpp"
+#include "graph/graph.hpp"
+#include "test_util.hpp"
+
+#include "gtest/gtest.h"
+
+using std::unique_ptr;
+using std::vector;
+
+// the length of a minimum spanning tree found by trying every edge
+static int SlowSpanningTreeLength(const Graph& graph) {
+	const int num_vertices{graph.GetNumVertices()};
+	vector<char> in_tree(num_vertices, false);
+	in_tree[0] = true;
+	int length{0};
+	for (int added{1}; added < num_vertices; ++added) {
+		int best{-1};
+		int best_length{0};
+		for (int from{0}; from < num_vertices; ++from) {
+			if (!in_tree[from]) { continue; }
+			for (int to{0}; to < num_vertices; ++to) {
+				if (in_tree[to]) { continue; }
+				const int distance{graph.GetDistance(from, to)};
+				if (best == -1 || distance < best_length) {
+					best = to;
+					best_length = distance;
+				}
+			}
+		}
+		in_tree[best] = true;
+		length += best_length;
+	}
+	return length;
+}
+
+TEST(SpanningTreeTest, OctantSweepIsMinimum) {
+	// a small world, so many points are as far from a point as each other,
+	// and some are in the same place
+	for (unsigned seed{1}; seed <= 5; ++seed) {
+		unique_ptr<Graph> graph{MakeRandomGraph(150, 30, seed)};
+
+		const vector<Edge> tree{MinimumSpanningTree(*graph)};
+		EXPECT_EQ(149, int(tree.size()));
+		EXPECT_EQ(SlowSpanningTreeLength(*graph),
+				SpanningTreeLowerBound(*graph));
+	}
+}
@@ -0,0 +1,152 @@
+#include "graph/spatial_index.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include "util.hpp"
+
+using std::abs;
+using std::copy;
+using std::max;
+using std::min;
+using std::nth_element;
+using std::swap;
+using std::vector;
+
+// subtrees with at most this many points are scanned instead of split
+const int leaf_size_c{8};
+
+static int Distance(const Coordinate& from, const Coordinate& to)
+{ return abs(from.x - to.x) + abs(from.y - to.y); }
+
+SpatialIndex::SpatialIndex(const vector<Coordinate>& points) :
+		points_{points}, split_by_y_(points.size(), false) {
+	for (int index{0}; index < int(points.size()); ++index)
+	{ indices_.push_back(index); }
+	Build(0, int(points_.size()));
+}
+
+vector<int> SpatialIndex::Nearest(const Coordinate& point, int count,
+		int exclude) const {
+	vector<Found> found;
+	if (count > 0) {
+		SearchNearest(0, int(points_.size()), point, count, exclude, found);
+	}
+	vector<int> nearest;
+	for (const Found& near : found) { nearest.push_back(near.index); }
+	return nearest;
+}
+
+vector<int> SpatialIndex::WithinDistance(const Coordinate& point,
+		int radius) const {
+	vector<int> within;
+	SearchWithin(0, int(points_.size()), point, radius, within);
+	return within;
+}
+
+void SpatialIndex::Build(int begin, int end) {
+	if (end - begin <= leaf_size_c) { return; }
+
+	// split along the axis the points are most spread out on, at the median
+	int min_x{points_[begin].x};
+	int max_x{min_x};
+	int min_y{points_[begin].y};
+	int max_y{min_y};
+	for (int i{begin + 1}; i < end; ++i) {
+		min_x = min(min_x, points_[i].x);
+		max_x = max(max_x, points_[i].x);
+		min_y = min(min_y, points_[i].y);
+		max_y = max(max_y, points_[i].y);
+	}
+	const int middle{begin + (end - begin) / 2};
+	const bool by_y{max_y - min_y > max_x - min_x};
+	split_by_y_[middle] = by_y;
+
+	// sort the indices along with the points, so they stay together
+	vector<int> order;
+	for (int i{begin}; i < end; ++i) { order.push_back(i); }
+	nth_element(order.begin(), order.begin() + (middle - begin), order.end(),
+			[this, by_y](int a, int b) {
+				return by_y ? points_[a].y < points_[b].y :
+					points_[a].x < points_[b].x;
+			});
+	vector<Coordinate> points;
+	vector<int> indices;
+	for (int i : order) {
+		points.push_back(points_[i]);
+		indices.push_back(indices_[i]);
+	}
+	copy(points.begin(), points.end(), points_.begin() + begin);
+	copy(indices.begin(), indices.end(), indices_.begin() + begin);
+
+	Build(begin, middle);
+	Build(middle + 1, end);
+}
+
+void SpatialIndex::SearchNearest(int begin, int end, const Coordinate& point,
+		int count, int exclude, vector<Found>& found) const {
+	// keep the count nearest points, sorted by distance then index
+	const auto consider = [&](int i) {
+		if (indices_[i] == exclude) { return; }
+		const Found candidate{Distance(point, points_[i]), indices_[i]};
+		const auto comes_before = [](const Found& a, const Found& b) {
+			return a.distance < b.distance ||
+				(a.distance == b.distance && a.index < b.index);
+		};
+		if (int(found.size()) == count) {
+			if (!comes_before(candidate, found.back())) { return; }
+			found.pop_back();
+		}
+		found.push_back(candidate);
+		for (int j{int(found.size()) - 1};
+				j > 0 && comes_before(found[j], found[j - 1]); --j)
+		{ swap(found[j], found[j - 1]); }
+	};
+
+	if (end - begin <= leaf_size_c) {
+		for (int i{begin}; i < end; ++i) { consider(i); }
+		return;
+	}
+
+	const int middle{begin + (end - begin) / 2};
+	const int offset{split_by_y_[middle] ? point.y - points_[middle].y :
+		point.x - points_[middle].x};
+	consider(middle);
+	// search the side the point is on first, then the other side if it can
+	// hold a point at least as near as the farthest found, which is at least
+	// the offset away
+	const bool left_first{offset < 0};
+	if (left_first) {
+		SearchNearest(begin, middle, point, count, exclude, found);
+	} else {
+		SearchNearest(middle + 1, end, point, count, exclude, found);
+	}
+	if (int(found.size()) < count || abs(offset) <= found.back().distance) {
+		if (left_first) {
+			SearchNearest(middle + 1, end, point, count, exclude, found);
+		} else {
+			SearchNearest(begin, middle, point, count, exclude, found);
+		}
+	}
+}
+
+void SpatialIndex::SearchWithin(int begin, int end, const Coordinate& point,
+		int radius, vector<int>& within) const {
+	if (end - begin <= leaf_size_c) {
+		for (int i{begin}; i < end; ++i) {
+			if (Distance(point, points_[i]) <= radius)
+			{ within.push_back(indices_[i]); }
+		}
+		return;
+	}
+
+	const int middle{begin + (end - begin) / 2};
+	const int offset{split_by_y_[middle] ? point.y - points_[middle].y :
+		point.x - points_[middle].x};
+	if (Distance(point, points_[middle]) <= radius)
+	{ within.push_back(indices_[middle]); }
+	if (offset <= radius) { SearchWithin(begin, middle, point, radius, within); }
+	if (-offset <= radius)
+	{ SearchWithin(middle + 1, end, point, radius, within); }
+}
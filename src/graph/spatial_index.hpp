@@ -0,0 +1,47 @@
+#ifndef GRAPH_SPATIAL_INDEX_H
+#define GRAPH_SPATIAL_INDEX_H
+
+#include <vector>
+
+#include "util.hpp"
+
+/* A k-d tree over points, for finding the points near one under the manhattan
+ * distance without looking at all of them. Building it takes O(N log N) time,
+ * and a query about O(log N) time plus the number of points it returns, for
+ * points that aren't unusually spread out. The tree is implicit: the points
+ * are reordered so that each subtree is a range of them, split at its middle.
+ */
+class SpatialIndex {
+public:
+	explicit SpatialIndex(const std::vector<Coordinate>& points);
+
+	// The indices of the count points nearest to the given one, nearest first,
+	// leaving out the point with index exclude. Points as near as each other
+	// come lowest index first.
+	std::vector<int> Nearest(const Coordinate& point, int count,
+			int exclude = -1) const;
+	// the indices of the points at most radius away from the given one, in no
+	// particular order
+	std::vector<int> WithinDistance(const Coordinate& point, int radius) const;
+
+private:
+	// the best points found so far by a Nearest query
+	struct Found {
+		int distance;
+		int index;
+	};
+
+	void Build(int begin, int end);
+	void SearchNearest(int begin, int end, const Coordinate& point, int count,
+			int exclude, std::vector<Found>& found) const;
+	void SearchWithin(int begin, int end, const Coordinate& point, int radius,
+			std::vector<int>& within) const;
+
+	// the points and their indices, in the order of the tree
+	std::vector<Coordinate> points_;
+	std::vector<int> indices_;
+	// whether the subtree split at each position is split by y instead of x
+	std::vector<char> split_by_y_;
+};
+
+#endif  // GRAPH_SPATIAL_INDEX_H
@@ -0,0 +1,63 @@
+#include "graph/spatial_index.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "util.hpp"
+
+#include "gtest/gtest.h"
+
+using std::abs;
+using std::mt19937;
+using std::sort;
+using std::vector;
+
+const int num_points{500};
+
+class SpatialIndexTest : public ::testing::Test {
+public:
+	SpatialIndexTest() {
+		// a small world, so many points are as far from a point as each other
+		mt19937 random{5};
+		for (int i{0}; i < num_points; ++i) {
+			points.push_back(Coordinate{int(random() % 50), int(random() % 50)});
+		}
+	}
+
+protected:
+	int Distance(int from, int to) const {
+		return abs(points[from].x - points[to].x) +
+			abs(points[from].y - points[to].y);
+	}
+
+	vector<Coordinate> points;
+};
+
+TEST_F(SpatialIndexTest, Nearest) {
+	const SpatialIndex index{points};
+	for (int point{0}; point < num_points; ++point) {
+		vector<int> expected;
+		for (int other{0}; other < num_points; ++other)
+		{ if (other != point) { expected.push_back(other); } }
+		sort(expected.begin(), expected.end(), [&](int a, int b) {
+			return Distance(point, a) < Distance(point, b) ||
+				(Distance(point, a) == Distance(point, b) && a < b);
+		});
+		expected.resize(10);
+		EXPECT_EQ(expected, index.Nearest(points[point], 10, point));
+	}
+}
+
+TEST_F(SpatialIndexTest, WithinDistance) {
+	const SpatialIndex index{points};
+	for (int point{0}; point < num_points; point += 7) {
+		vector<int> expected;
+		for (int other{0}; other < num_points; ++other)
+		{ if (Distance(point, other) <= 6) { expected.push_back(other); } }
+		vector<int> within{index.WithinDistance(points[point], 6)};
+		sort(within.begin(), within.end());
+		EXPECT_EQ(expected, within);
+	}
+}
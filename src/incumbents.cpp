@@ -0,0 +1,71 @@
+#include "incumbents.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+#include "path.hpp"
+#include "util.hpp"
+
+using std::chrono::duration;
+using std::chrono::duration_cast;
+using std::chrono::steady_clock;
+using std::fixed;
+using std::flush;
+using std::lock_guard;
+using std::mutex;
+using std::ostream;
+using std::ostringstream;
+using std::setprecision;
+using std::string;
+
+const string text_format_c{"text"};
+const string json_format_c{"json"};
+
+bool IsValidIncumbentFormat(const string& format)
+{ return format == text_format_c || format == json_format_c; }
+
+IncumbentWriter::IncumbentWriter(ostream& os, const string& format) : os_(os),
+		json_{format == json_format_c}, start_{steady_clock::now()},
+		written_{false}, written_length_{0} {
+	if (!IsValidIncumbentFormat(format))
+	{ throw Error{"Not a valid incumbent format!"}; }
+}
+
+void IncumbentWriter::Write(const Path& tour) {
+	lock_guard<mutex> lock{mutex_};
+	if (written_ && tour.length >= written_length_) { return; }
+	written_ = true;
+	written_length_ = tour.length;
+	WriteLine("incumbent", tour);
+}
+
+void IncumbentWriter::WriteFinal(const Path& tour, bool optimal) {
+	lock_guard<mutex> lock{mutex_};
+	WriteLine(optimal ? "optimal" : "final", tour);
+}
+
+void IncumbentWriter::WriteLine(const char* type, const Path& tour) {
+	const double seconds{
+		duration_cast<duration<double>>(steady_clock::now() - start_).count()};
+
+	// build the line first, so the stream's formatting is left alone
+	ostringstream line;
+	line << fixed << setprecision(3);
+	if (json_) {
+		line << "{\"type\":\"" << type << "\",\"seconds\":" << seconds <<
+			",\"length\":" << tour.length << ",\"tour\":[";
+		for (int i{0}; i < int(tour.vertices.size()); ++i)
+		{ line << (i ? "," : "") << tour.vertices[i]; }
+		line << "]}";
+	} else {
+		line << type << " " << seconds << " " << tour.length;
+		for (int vertex : tour.vertices) { line << " " << vertex; }
+	}
+	line << '\n';
+	// flushed right away, since the reader may be waiting on it
+	os_ << line.str() << flush;
+}
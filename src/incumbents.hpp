@@ -0,0 +1,49 @@
+#ifndef INCUMBENTS_H
+#define INCUMBENTS_H
+
+#include <chrono>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+
+struct Path;
+
+// whether the format is one IncumbentWriter can write: "text" or "json"
+bool IsValidIncumbentFormat(const std::string& format);
+
+/* Writes tours to a stream the moment a solver finds them, one line each, so
+ * whoever reads the stream can use a good tour before the search ends. Each
+ * line gives the seconds since the writer was created, the tour's length and
+ * its vertices. In the "text" format a line looks like
+ *
+ * incumbent 0.012 606 0 4 1 3 2
+ *
+ * and in the "json" format like
+ *
+ * {"type":"incumbent","seconds":0.012,"length":606,"tour":[0,4,1,3,2]}
+ *
+ * The last line holds the tour the solver returned, with the type "optimal" if
+ * it is proven optimal and "final" if not.
+ */
+class IncumbentWriter {
+public:
+	IncumbentWriter(std::ostream& os, const std::string& format);
+
+	// write a tour, unless it doesn't beat one written before, may be called
+	// from any thread
+	void Write(const Path& tour);
+	// write the tour the solver returned as the last line
+	void WriteFinal(const Path& tour, bool optimal);
+
+private:
+	void WriteLine(const char* type, const Path& tour);
+
+	std::ostream& os_;
+	bool json_;
+	std::chrono::steady_clock::time_point start_;
+	std::mutex mutex_;
+	bool written_;
+	int written_length_;  // the length of the last tour written
+};
+
+#endif  // INCUMBENTS_H
@@ -0,0 +1,47 @@
+#include "incumbents.hpp"
+
+#include <sstream>
+#include <vector>
+
+#include "path.hpp"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using std::ostringstream;
+using std::vector;
+
+using ::testing::MatchesRegex;
+
+static Path MakePath(int length, const vector<int>& vertices) {
+	Path path;
+	path.length = length;
+	path.vertices = vertices;
+	return path;
+}
+
+TEST(IncumbentWriterTest, Text) {
+	ostringstream os;
+	IncumbentWriter writer{os, "text"};
+	writer.Write(MakePath(12, {0, 2, 1}));
+	// not shorter than the tour before, so not written
+	writer.Write(MakePath(12, {0, 1, 2}));
+	writer.Write(MakePath(10, {0, 1, 2}));
+	writer.WriteFinal(MakePath(10, {0, 1, 2}), true);
+	EXPECT_THAT(os.str(), MatchesRegex(
+				"incumbent [0-9]+\\.[0-9]{3} 12 0 2 1\n"
+				"incumbent [0-9]+\\.[0-9]{3} 10 0 1 2\n"
+				"optimal [0-9]+\\.[0-9]{3} 10 0 1 2\n"));
+}
+
+TEST(IncumbentWriterTest, JSON) {
+	ostringstream os;
+	IncumbentWriter writer{os, "json"};
+	writer.Write(MakePath(12, {0, 2, 1}));
+	writer.WriteFinal(MakePath(12, {0, 2, 1}), false);
+	EXPECT_THAT(os.str(), MatchesRegex(
+				"\\{\"type\":\"incumbent\",\"seconds\":[0-9]+\\.[0-9]{3},"
+				"\"length\":12,\"tour\":\\[0,2,1\\]\\}\n"
+				"\\{\"type\":\"final\",\"seconds\":[0-9]+\\.[0-9]{3},"
+				"\"length\":12,\"tour\":\\[0,2,1\\]\\}\n"));
+}
@@ -8,9 +8,18 @@
 
 #include "graph/factory.hpp"
 #include "graph/graph.hpp"
+#include "incumbents.hpp"
 #include "path.hpp"
+#include "perf_counters.hpp"
+#include "profile.hpp"
+#include "statistics.hpp"
+#include "tsp_solver/async.hpp"
 #include "tsp_solver/factory.hpp"
-#include "tsp_solver/tsp_solver.hpp"
+#include "tsp_solver/fast.hpp"
+#include "tsp_solver/little/branching_rule.hpp"
+#include "tsp_solver/little/exact_leaf.hpp"
+#include "tsp_solver/options.hpp"
+#include "tsp_solver/portfolio.hpp"
 #include "util.hpp"
 
 #include <gflags/gflags.h>
@@ -24,14 +33,122 @@ using std::unique_ptr;
 
 static bool ValidateGraph(const char* flag_name, const string& value);
 static bool ValidateSolver(const char* flag_name, const string& value);
+static bool ValidateExactLeafSize(const char* flag_name, int value);
+static bool ValidateNonNegative(const char* flag_name, int value);
+static bool ValidateGap(const char* flag_name, double value);
+static bool ValidateTimeLimit(const char* flag_name, double value);
+static bool ValidateBranching(const char* flag_name, const string& value);
+static bool ValidatePositive(const char* flag_name, int value);
+static bool ValidatePortfolio(const char* flag_name, const string& value);
+static bool ValidateIncumbents(const char* flag_name, const string& value);
+static bool ValidateInsertion(const char* flag_name, const string& value);
 
 DEFINE_string(graph, "manhattan", "Type of graph to construct");
 DEFINE_string(solver, "little", "Type of solver to use");
+DEFINE_int32(exact_leaf_size, SolverOptions{}.exact_leaf_size,
+		"Rows left at which Little's algorithm solves a node exactly");
+DEFINE_int32(dive_frequency, SolverOptions{}.dive_frequency,
+		"Nodes Little's algorithm expands between heuristic dives");
+DEFINE_bool(eliminate_edges, SolverOptions{}.eliminate_edges,
+		"Exclude edges Little's root reduced costs rule out");
+DEFINE_double(gap, SolverOptions{}.gap,
+		"Fraction of the upper bound Little's algorithm may fall short by");
+DEFINE_string(branching, SolverOptions{}.branching,
+		"Rule Little's algorithm uses to choose the edge to branch on");
+DEFINE_int32(branching_candidates, SolverOptions{}.branching_candidates,
+		"Zeros per node whose children the branching rule may evaluate");
+DEFINE_int32(reliability_threshold, SolverOptions{}.reliability_threshold,
+		"Observations after which an edge's pseudocosts are trusted");
+DEFINE_string(checkpoint, SolverOptions{}.checkpoint_file,
+		"File Little's algorithm periodically saves its search to");
+DEFINE_int32(checkpoint_interval, SolverOptions{}.checkpoint_interval,
+		"Seconds between checkpoints");
+DEFINE_bool(resume, SolverOptions{}.resume,
+		"Resume the search saved in the checkpoint file");
+DEFINE_string(trace, SolverOptions{}.trace_file,
+		"File to write the events of Little's search tree to");
+DEFINE_int32(trace_sample, SolverOptions{}.trace_sample,
+		"Trace the events of one in this many nodes");
+DEFINE_int64(trace_limit, SolverOptions{}.trace_limit,
+		"Most events to write to the trace");
+DEFINE_int32(processes, SolverOptions{}.processes,
+		"Processes Little's algorithm splits its tree among");
+DEFINE_int32(threads, SolverOptions{}.threads,
+		"Threads Little's algorithm splits its tree among");
+DEFINE_double(time_limit, SolveRequest{}.time_limit,
+		"Seconds after which the solver stops with the best tour it has");
+DEFINE_string(insertion, SolverOptions{}.insertion,
+		"How the fast solver picks the vertex to insert next");
+DEFINE_int32(neighbors, SolverOptions{}.neighbors,
+		"Nearest neighbors local search tries joining each vertex to");
+DEFINE_bool(improve_hilbert, SolverOptions{}.improve_hilbert,
+		"Improve the hilbert solver's tour with --neighbors moves");
+DEFINE_double(time_budget, SolverOptions{}.time_budget,
+		"Seconds the lk, multistart and anneal solvers spend on their tours");
+DEFINE_int32(kicks, SolverOptions{}.kicks,
+		"Kicks after which the lk solver stops");
+DEFINE_int32(starts, SolverOptions{}.starts,
+		"Starts after which the multistart solver stops");
+DEFINE_int32(replicas, SolverOptions{}.replicas,
+		"Tours the anneal solver anneals at different temperatures");
+DEFINE_int32(rounds, SolverOptions{}.rounds,
+		"Rounds of moves after which the anneal solver stops");
+DEFINE_uint64(seed, SolverOptions{}.seed,
+		"Seed for the random choices of heuristics");
+DEFINE_string(portfolio, SolverOptions{}.portfolio,
+		"Comma separated solvers the portfolio solver races");
+DEFINE_string(incumbents, "",
+		"Format to print each shorter tour found in: text or json");
+DEFINE_bool(stats, false, "Print solver statistics to standard error");
+DEFINE_bool(profile, false,
+		"Print the time spent in each phase of the solve to standard error");
+DEFINE_bool(perf_counters, false,
+		"Print hardware performance counts of the solve to standard error");
 
 const bool graph_validated{gflags::RegisterFlagValidator(
 		&FLAGS_graph, &ValidateGraph)};
 const bool solver_validated{gflags::RegisterFlagValidator(
 		&FLAGS_solver, &ValidateSolver)};
+const bool exact_leaf_size_validated{gflags::RegisterFlagValidator(
+		&FLAGS_exact_leaf_size, &ValidateExactLeafSize)};
+const bool dive_frequency_validated{gflags::RegisterFlagValidator(
+		&FLAGS_dive_frequency, &ValidateNonNegative)};
+const bool gap_validated{gflags::RegisterFlagValidator(
+		&FLAGS_gap, &ValidateGap)};
+const bool branching_validated{gflags::RegisterFlagValidator(
+		&FLAGS_branching, &ValidateBranching)};
+const bool branching_candidates_validated{gflags::RegisterFlagValidator(
+		&FLAGS_branching_candidates, &ValidatePositive)};
+const bool reliability_threshold_validated{gflags::RegisterFlagValidator(
+		&FLAGS_reliability_threshold, &ValidateNonNegative)};
+const bool checkpoint_interval_validated{gflags::RegisterFlagValidator(
+		&FLAGS_checkpoint_interval, &ValidatePositive)};
+const bool trace_sample_validated{gflags::RegisterFlagValidator(
+		&FLAGS_trace_sample, &ValidatePositive)};
+const bool processes_validated{gflags::RegisterFlagValidator(
+		&FLAGS_processes, &ValidatePositive)};
+const bool threads_validated{gflags::RegisterFlagValidator(
+		&FLAGS_threads, &ValidatePositive)};
+const bool time_limit_validated{gflags::RegisterFlagValidator(
+		&FLAGS_time_limit, &ValidateTimeLimit)};
+const bool insertion_validated{gflags::RegisterFlagValidator(
+		&FLAGS_insertion, &ValidateInsertion)};
+const bool neighbors_validated{gflags::RegisterFlagValidator(
+		&FLAGS_neighbors, &ValidateNonNegative)};
+const bool time_budget_validated{gflags::RegisterFlagValidator(
+		&FLAGS_time_budget, &ValidateTimeLimit)};
+const bool kicks_validated{gflags::RegisterFlagValidator(
+		&FLAGS_kicks, &ValidateNonNegative)};
+const bool starts_validated{gflags::RegisterFlagValidator(
+		&FLAGS_starts, &ValidateNonNegative)};
+const bool replicas_validated{gflags::RegisterFlagValidator(
+		&FLAGS_replicas, &ValidatePositive)};
+const bool rounds_validated{gflags::RegisterFlagValidator(
+		&FLAGS_rounds, &ValidateNonNegative)};
+const bool portfolio_validated{gflags::RegisterFlagValidator(
+		&FLAGS_portfolio, &ValidatePortfolio)};
+const bool incumbents_validated{gflags::RegisterFlagValidator(
+		&FLAGS_incumbents, &ValidateIncumbents)};
 
 int main(int argc, char* argv[]) {
 	// parse and validate flags
@@ -41,19 +158,192 @@ int main(int argc, char* argv[]) {
 			"\t--graph\t\t\tSet the type of graph to use (Default: manhattan, "
 			"options: manhattan)\n"
 			"\t--solver\t\tSet the type of solver to use (Default: little, "
-			"options: little, naive, fast)\n"
+			"options: little, naive, fast, lk, hilbert, mst, multistart, "
+			"anneal, portfolio)\n"
+			"\t--exact_leaf_size\tSolve Little nodes with at most this many "
+			"rows left exactly (Default: 12, 0 disables, at most 16)\n"
+			"\t--dive_frequency\tDive for a better tour every this many "
+			"Little nodes (Default: 100, 0 disables)\n"
+			"\t--[no]eliminate_edges\tExclude edges that the root reduced costs "
+			"rule out of any better tour (Default: true)\n"
+			"\t--gap\t\t\tReturn a Little tour within 1 + gap of the optimum "
+			"and print a lower bound on it (Default: 0)\n"
+			"\t--branching\t\tSet the rule Little's algorithm branches with "
+			"(Default: penalty, options: penalty, strong, reliability)\n"
+			"\t--branching_candidates\tEvaluate the children of at most this "
+			"many zeros per node with strong or reliability branching "
+			"(Default: 4)\n"
+			"\t--reliability_threshold\tTrust an edge's pseudocosts after this "
+			"many observations (Default: 4)\n"
+			"\t--checkpoint\t\tSave Little's search to this file "
+			"periodically and when it finishes (Default: off)\n"
+			"\t--checkpoint_interval\tSeconds between checkpoints "
+			"(Default: 60)\n"
+			"\t--resume\t\tResume the search saved in the --checkpoint file\n"
+			"\t--trace\t\t\tWrite the nodes Little's algorithm makes, "
+			"evaluates and prunes and the tours it finds to this file, which "
+			"tracejson converts for Perfetto (Default: off)\n"
+			"\t--trace_sample\t\tTrace one in this many nodes (Default: 1)\n"
+			"\t--trace_limit\t\tMost events to trace (Default: 1000000)\n"
+			"\t--processes\t\tSplit Little's tree among this many worker "
+			"processes (Default: 1)\n"
+			"\t--threads\t\tSplit Little's tree, the naive solver's tours, "
+			"the hilbert solver's sort, the multistart solver's starts or the "
+			"anneal solver's replicas among this many threads (Default: 1)\n"
+			"\t--time_limit\t\tStop after this many seconds with the best "
+			"tour found and print a lower bound (Default: 0, no limit)\n"
+			"\t--insertion\t\tInsert the vertex nearest to the fast "
+			"solver's tour, farthest from it, or cheapest to insert next "
+			"(Default: farthest, options: nearest, farthest, cheapest)\n"
+			"\t--neighbors\t\tImprove fast, mst and multistart "
+			"tours with 2-opt and Or-opt moves to this many nearest "
+			"neighbors of each vertex (Default: 10, 0 disables)\n"
+			"\t--improve_hilbert\tImprove hilbert tours with the --neighbors "
+			"moves too, which takes far longer than the curve (Default: off)\n"
+			"\t--time_budget\t\tSeconds the lk solver kicks and improves its "
+			"tour for, the multistart solver starts new tours for, or the "
+			"anneal solver anneals for (Default: 1, 0 for no limit)\n"
+			"\t--kicks\t\t\tStop the lk solver after this many kicks "
+			"(Default: 0, no limit)\n"
+			"\t--starts\t\tStop the multistart solver after this many "
+			"starts (Default: 0, no limit)\n"
+			"\t--replicas\t\tAnneal this many tours, each at its own "
+			"temperature (Default: 4)\n"
+			"\t--rounds\t\tStop the anneal solver after this many rounds "
+			"of moves (Default: 0, no limit)\n"
+			"\t--seed\t\t\tSeed the random choices of heuristics "
+			"(Default: 1)\n"
+			"\t--portfolio\t\tSolvers the portfolio solver races, a little "
+			"solver may name a branching rule after a colon and a fast solver "
+			"an insertion (Default: fast,little,little:reliability)\n"
+			"\t--incumbents\t\tPrint each shorter tour as it is found, then "
+			"the tour returned, one line each, as text or json (Default: "
+			"off)\n"
+			"\t--stats\t\t\tPrint solver statistics to standard error\n"
+			"\t--profile\t\tPrint the count, total, p50 and p99 time of each "
+			"phase of the solve to standard error, if built with "
+			"-Dprofiling=ON\n"
+			"\t--perf_counters\t\tPrint the cycles, instructions, cache misses "
+			"and branch misses of reading the graph and of the solve, per node "
+			"evaluated too, and of each phase with --profile\n"
 			"\n"
 			"Example:\n"
 			"\tlittletsp --graph=manhattan --solver=naive < input_graph.txt\n"
 			"\tlittletsp --graph manhattan --solver little < input_graph.txt\n");
 	gflags::ParseCommandLineFlags(&argc, &argv, true);
+	if (FLAGS_resume && FLAGS_checkpoint.empty()) {
+		cerr << "--resume needs a --checkpoint file to resume from" << endl;
+		return 1;
+	}
+	if ((FLAGS_processes > 1 || FLAGS_threads > 1) &&
+			!FLAGS_checkpoint.empty()) {
+		cerr << "--checkpoint only works with --processes=1 and --threads=1"
+			<< endl;
+		return 1;
+	}
+	if (!FLAGS_trace.empty() && (FLAGS_solver != "little" ||
+				FLAGS_processes > 1 || FLAGS_threads > 1)) {
+		cerr << "--trace only works with --solver=little, --processes=1 and "
+			"--threads=1" << endl;
+		return 1;
+	}
+	if (FLAGS_processes > 1 && FLAGS_threads > 1) {
+		cerr << "--processes and --threads can't both be more than 1" << endl;
+		return 1;
+	}
 
-	unique_ptr<Graph> graph{CreateGraph(FLAGS_graph, cin)};
-	unique_ptr<TSPSolver> tsp_solver{CreateTSPSolver(FLAGS_solver)};
+	// counters that can't be opened, as in many containers, are reported and
+	// then left out
+	unique_ptr<PerfCounters> counters;
+	PerfCounts start_counts, graph_counts;
+	if (FLAGS_perf_counters) {
+		counters.reset(new PerfCounters{true});
+		if (!counters->IsAvailable()) {
+			cerr << "Performance counters unavailable: " << counters->GetError()
+				<< endl;
+			counters.reset();
+		} else if (FLAGS_profile && IsProfilingEnabled())
+		{ EnableProfileCounters(); }
+	}
+
+	SolveRequest request;
+	request.solver = FLAGS_solver;
+	request.time_limit = FLAGS_time_limit;
+	SolverOptions& options{request.options};
+	options.exact_leaf_size = FLAGS_exact_leaf_size;
+	options.dive_frequency = FLAGS_dive_frequency;
+	options.eliminate_edges = FLAGS_eliminate_edges;
+	options.gap = FLAGS_gap;
+	options.branching = FLAGS_branching;
+	options.branching_candidates = FLAGS_branching_candidates;
+	options.reliability_threshold = FLAGS_reliability_threshold;
+	options.checkpoint_file = FLAGS_checkpoint;
+	options.checkpoint_interval = FLAGS_checkpoint_interval;
+	options.resume = FLAGS_resume;
+	options.trace_file = FLAGS_trace;
+	options.trace_sample = FLAGS_trace_sample;
+	options.trace_limit = FLAGS_trace_limit;
+	options.processes = FLAGS_processes;
+	options.threads = FLAGS_threads;
+	options.insertion = FLAGS_insertion;
+	options.neighbors = FLAGS_neighbors;
+	options.improve_hilbert = FLAGS_improve_hilbert;
+	options.time_budget = FLAGS_time_budget;
+	options.kicks = FLAGS_kicks;
+	options.starts = FLAGS_starts;
+	options.replicas = FLAGS_replicas;
+	options.rounds = FLAGS_rounds;
+	options.seed = unsigned(FLAGS_seed);
+	options.portfolio = FLAGS_portfolio;
+	unique_ptr<IncumbentWriter> incumbents;
+	if (!FLAGS_incumbents.empty()) {
+		incumbents.reset(new IncumbentWriter{cout, FLAGS_incumbents});
+		options.incumbent =
+			[&incumbents](const Path& tour) { incumbents->Write(tour); };
+	}
 
-	// solve the graph
+	// read and solve the graph
 	try {
-		cout << tsp_solver->Solve(*graph) << endl;
+		if (counters) { start_counts = counters->Read(); }
+		unique_ptr<Graph> graph{CreateGraph(FLAGS_graph, cin)};
+		if (counters) { graph_counts = counters->Read(); }
+		SolveResult result{Solve(*graph, request)};
+		PerfCounts solve_counts;
+		if (counters) { solve_counts = counters->Read() - graph_counts; }
+		if (incumbents) { incumbents->WriteFinal(result.tour, result.optimal); }
+		else { cout << result.tour << endl; }
+		const Statistics& statistics{result.statistics};
+		// an optimal tour is its own lower bound
+		if (!result.optimal && statistics.GetCounters().count("lower_bound")) {
+			const long long lower_bound{statistics.Get("lower_bound")};
+			cerr << "Lower bound: " << lower_bound << endl;
+			if (lower_bound > 0 && !result.tour.vertices.empty()) {
+				cerr << "Gap: " << 100.0 * (result.tour.length - lower_bound) /
+					lower_bound << "%" << endl;
+			}
+		}
+		if (FLAGS_stats) { cerr << statistics; }
+		if (counters) {
+			WritePerfCountsHeader(cerr);
+			WritePerfCounts(cerr, "graph_parse", "run",
+					graph_counts - start_counts, 1);
+			WritePerfCounts(cerr, "solve", "run", solve_counts, 1);
+			if (statistics.GetCounters().count("nodes_expanded") &&
+					statistics.Get("nodes_expanded") > 0) {
+				WritePerfCounts(cerr, "solve", "node", solve_counts,
+						statistics.Get("nodes_expanded"));
+			}
+		}
+		if (FLAGS_profile) {
+			if (IsProfilingEnabled()) { WriteProfileReport(cerr); }
+			else {
+				cerr << "littletsp was built without profiling, configure "
+					"with -Dprofiling=ON" << endl;
+			}
+		}
+	} catch (Error& e) {
+		cerr << "Error: " << e.what() << endl;
+		return 1;
 	} catch (ImplementationError& ie) {
 		cerr << "Implementation Error: " << ie.what() << endl;
 		return 2;
@@ -70,3 +360,26 @@ bool ValidateGraph(const char*, const string& value)
 
 bool ValidateSolver(const char*, const string& value)
 { return IsValidTSPSolverType(value); }
+
+bool ValidateExactLeafSize(const char*, int value)
+{ return value >= 0 && value <= max_exact_leaf_size; }
+
+bool ValidateNonNegative(const char*, int value) { return value >= 0; }
+
+bool ValidateGap(const char*, double value) { return value >= 0; }
+
+bool ValidateTimeLimit(const char*, double value) { return value >= 0; }
+
+bool ValidateBranching(const char*, const string& value)
+{ return IsValidBranchingRuleType(value); }
+
+bool ValidatePositive(const char*, int value) { return value > 0; }
+
+bool ValidatePortfolio(const char*, const string& value)
+{ return IsValidPortfolio(value); }
+
+bool ValidateInsertion(const char*, const string& value)
+{ return IsValidInsertionType(value); }
+
+bool ValidateIncumbents(const char*, const string& value)
+{ return value.empty() || IsValidIncumbentFormat(value); }
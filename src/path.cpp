@@ -1,9 +1,13 @@
 #include "path.hpp"
 
 #include <iostream>
+#include <vector>
+
+#include "graph/graph.hpp"
 
 using std::ostream;
 using std::endl;
+using std::vector;
 
 ostream& operator<<(ostream& os, const Path& p)
 {
@@ -21,3 +25,10 @@ ostream& operator<<(ostream& os, const Path& p)
 	return os;
 }
 
+int CalculatePathLength(const Graph& graph, const vector<int>& vertices) {
+	int length{0};
+	for (int i{0}; i < int(vertices.size()); ++i)
+	{ length += graph.GetDistance(vertices[i],
+			vertices[(i + 1) % vertices.size()]); }
+	return length;
+}
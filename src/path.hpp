@@ -4,6 +4,8 @@
 #include <iosfwd>
 #include <vector>
 
+class Graph;
+
 // a struct for representing a path through a set of vertices
 struct Path {
 	Path() : length{0} {}
@@ -19,4 +21,7 @@ struct Path {
 	int length;
 };
 
+// length of the cycle through the vertices in the given order
+int CalculatePathLength(const Graph& graph, const std::vector<int>& vertices);
+
 #endif // PATH_H
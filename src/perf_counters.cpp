@@ -0,0 +1,162 @@
+#include "perf_counters.hpp"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using std::endl;
+using std::ostream;
+using std::setw;
+using std::string;
+using std::uint64_t;
+using std::vector;
+
+static const char* const event_names_c[kNumPerfEvents]{
+	"cycles", "instructions", "cache_misses", "branch_misses"};
+
+// a count scaled up by the fraction of the time the event was counted
+static long long Scale(uint64_t value, uint64_t enabled, uint64_t running) {
+	if (running == 0) { return enabled == 0 ? 0 : -1; }
+	if (running >= enabled) { return (long long)value; }
+	return (long long)(double(value) * double(enabled) / double(running));
+}
+
+PerfCounts operator-(const PerfCounts& end, const PerfCounts& start) {
+	PerfCounts difference;
+	for (int event{0}; event < kNumPerfEvents; ++event) {
+		difference[event] = end[event] < 0 || start[event] < 0 ? -1 :
+			end[event] - start[event];
+	}
+	return difference;
+}
+
+#ifdef __linux__
+
+static const uint64_t event_configs_c[kNumPerfEvents]{
+	PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+	PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+PerfCounters::PerfCounters(bool inherit) : inherit_{inherit}, num_open_{0} {
+	fds_.fill(-1);
+	int leader{-1};
+	for (int event{0}; event < kNumPerfEvents; ++event) {
+		perf_event_attr attr;
+		std::memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = event_configs_c[event];
+		// a group starts once its leader is enabled
+		attr.disabled = !inherit && leader == -1 ? 1 : 0;
+		attr.inherit = inherit ? 1 : 0;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+			PERF_FORMAT_TOTAL_TIME_RUNNING;
+		if (!inherit) { attr.read_format |= PERF_FORMAT_GROUP; }
+
+		// this thread, on any CPU
+		const int fd{int(syscall(SYS_perf_event_open, &attr, 0, -1,
+					inherit ? -1 : leader, 0))};
+		if (fd == -1) {
+			if (error_.empty()) {
+				error_ = string{"perf_event_open failed for "} +
+					event_names_c[event] + ": " + std::strerror(errno);
+			}
+			continue;
+		}
+		fds_[event] = fd;
+		++num_open_;
+		if (leader == -1) { leader = fd; }
+	}
+
+	if (!inherit && leader != -1)
+	{ ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP); }
+}
+
+PerfCounters::~PerfCounters() {
+	for (int fd : fds_) { if (fd != -1) { close(fd); } }
+}
+
+PerfCounts PerfCounters::Read() const {
+	PerfCounts counts;
+	counts.fill(-1);
+	if (!num_open_) { return counts; }
+
+	if (inherit_) {
+		for (int event{0}; event < kNumPerfEvents; ++event) {
+			if (fds_[event] == -1) { continue; }
+			uint64_t values[3];  // value, time enabled, time running
+			if (read(fds_[event], values, sizeof(values)) ==
+					ssize_t(sizeof(values)))
+			{ counts[event] = Scale(values[0], values[1], values[2]); }
+		}
+		return counts;
+	}
+
+	// the group's members are read at once, in the order they were opened
+	int leader{-1};
+	for (int fd : fds_) { if (fd != -1) { leader = fd; break; } }
+	vector<uint64_t> values(3 + num_open_);
+	const ssize_t size{ssize_t(values.size() * sizeof(uint64_t))};
+	if (read(leader, values.data(), size) != size) { return counts; }
+	int member{0};
+	for (int event{0}; event < kNumPerfEvents; ++event) {
+		if (fds_[event] == -1) { continue; }
+		counts[event] = Scale(values[3 + member++], values[1], values[2]);
+	}
+	return counts;
+}
+
+#else
+
+PerfCounters::PerfCounters(bool inherit) :
+		inherit_{inherit}, num_open_{0},
+		error_{"performance counters are only supported on Linux"} {
+	fds_.fill(-1);
+}
+
+PerfCounters::~PerfCounters() {}
+
+PerfCounts PerfCounters::Read() const {
+	PerfCounts counts;
+	counts.fill(-1);
+	return counts;
+}
+
+#endif  // __linux__
+
+const char* GetPerfEventName(PerfEvent event) { return event_names_c[event]; }
+
+void WritePerfCountsHeader(ostream& os) {
+	os << std::left << setw(16) << "phase" << setw(8) << "per" << std::right;
+	for (const char* name : event_names_c) { os << setw(20) << name; }
+	os << setw(8) << "ipc" << endl;
+}
+
+void WritePerfCounts(ostream& os, const string& phase, const string& unit,
+		const PerfCounts& counts, long long units) {
+	os << std::left << setw(16) << phase << setw(8) << unit << std::right
+		<< std::fixed << std::setprecision(1);
+	for (long long count : counts) {
+		if (count < 0 || units <= 0) { os << setw(20) << "n/a"; }
+		else { os << setw(20) << double(count) / units; }
+	}
+	if (counts[kCycles] > 0 && counts[kInstructions] >= 0) {
+		os << setw(8) << std::setprecision(2) <<
+			double(counts[kInstructions]) / counts[kCycles];
+	} else { os << setw(8) << "n/a"; }
+	os.unsetf(std::ios::floatfield);
+	os << std::setprecision(6) << endl;
+}
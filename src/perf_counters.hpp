@@ -0,0 +1,67 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <array>
+#include <iosfwd>
+#include <string>
+
+// the hardware events counted, in the order of PerfCounts
+enum PerfEvent {
+	kCycles,
+	kInstructions,
+	kCacheMisses,
+	kBranchMisses,
+	kNumPerfEvents
+};
+
+// Counts of the hardware events, -1 for events that can't be counted. Counts
+// are scaled up to make up for time the kernel spent counting other events.
+using PerfCounts = std::array<long long, kNumPerfEvents>;
+
+// the counts of the events between two readings
+PerfCounts operator-(const PerfCounts& end, const PerfCounts& start);
+
+/* Hardware performance counters read through Linux's perf_event_open. Only
+ * user space is counted, which works with the default perf_event_paranoid.
+ * Where the counters can't be opened, such as in containers without access to
+ * them, on virtual machines without a PMU or on other systems, the counters
+ * are unavailable and every count reads -1.
+ */
+class PerfCounters {
+public:
+	// Counts the calling thread. With inherit, threads and processes it
+	// starts afterwards are counted too, though each event then has to be read
+	// on its own instead of in one group.
+	explicit PerfCounters(bool inherit);
+	~PerfCounters();
+
+	PerfCounters(const PerfCounters&) = delete;
+	PerfCounters& operator=(const PerfCounters&) = delete;
+
+	// whether any event is counted
+	bool IsAvailable() const { return num_open_ > 0; }
+	// why the counters aren't available
+	const std::string& GetError() const { return error_; }
+
+	PerfCounts Read() const;
+
+private:
+	bool inherit_;
+	// file descriptors of the events, -1 for those that couldn't be opened,
+	// without inherit the first one opened leads the group
+	std::array<int, kNumPerfEvents> fds_;
+	int num_open_;
+	std::string error_;
+};
+
+// name of each event as printed in reports
+const char* GetPerfEventName(PerfEvent event);
+
+// Prints a row of counts for a phase: each event divided by units, and the
+// instructions per cycle. unit names what was counted units of, such as
+// "node" for the nodes evaluated in the phase.
+void WritePerfCountsHeader(std::ostream& os);
+void WritePerfCounts(std::ostream& os, const std::string& phase,
+		const std::string& unit, const PerfCounts& counts, long long units);
+
+#endif  // PERF_COUNTERS_H
@@ -0,0 +1,57 @@
+#include "perf_counters.hpp"
+
+#include <sstream>
+#include <string>
+
+#include "gtest/gtest.h"
+
+using std::istringstream;
+using std::ostringstream;
+using std::string;
+
+TEST(PerfCountersTest, Difference) {
+	const PerfCounts start{{10, 20, -1, 5}};
+	const PerfCounts end{{110, 420, 7, -1}};
+	const PerfCounts expected{{100, 400, -1, -1}};
+	EXPECT_EQ(expected, end - start);
+}
+
+TEST(PerfCountersTest, Counts) {
+	PerfCounters counters{false};
+	if (!counters.IsAvailable()) {
+		// there's no error when the counters are there
+		EXPECT_FALSE(counters.GetError().empty());
+		const PerfCounts unavailable{{-1, -1, -1, -1}};
+		EXPECT_EQ(unavailable, counters.Read());
+		return;
+	}
+
+	const PerfCounts start{counters.Read()};
+	volatile long long sum{0};
+	for (int i{0}; i < 1000000; ++i) { sum += i; }
+	const PerfCounts counts{counters.Read() - start};
+	// some events may be missing, but the counted ones only go up
+	for (long long count : counts) { EXPECT_GE(count, -1); }
+	if (counts[kInstructions] >= 0) { EXPECT_GT(counts[kInstructions], 1000000); }
+}
+
+TEST(PerfCountersTest, Report) {
+	ostringstream output;
+	WritePerfCountsHeader(output);
+	WritePerfCounts(output, "solve", "node", PerfCounts{{400, 800, -1, 20}}, 4);
+	istringstream report{output.str()};
+	string line;
+	getline(report, line);
+	getline(report, line);
+	istringstream fields{line};
+	string phase, unit, cycles, instructions, cache_misses, branch_misses, ipc;
+	fields >> phase >> unit >> cycles >> instructions >> cache_misses >>
+		branch_misses >> ipc;
+	EXPECT_EQ("solve", phase);
+	EXPECT_EQ("node", unit);
+	EXPECT_EQ("100.0", cycles);
+	EXPECT_EQ("200.0", instructions);
+	EXPECT_EQ("n/a", cache_misses);
+	EXPECT_EQ("5.0", branch_misses);
+	EXPECT_EQ("2.00", ipc);
+}
@@ -0,0 +1,219 @@
+#include "profile.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "perf_counters.hpp"
+
+using std::array;
+using std::atomic;
+using std::endl;
+using std::lock_guard;
+using std::max;
+using std::mutex;
+using std::ostream;
+using std::setw;
+using std::unique_ptr;
+using std::vector;
+
+namespace {
+
+// each power of two is split into this many buckets, so a bucket spans at most
+// 2^(1/4) of its lower end, about 19%
+const int sub_buckets_log_c{2};
+const int sub_buckets_c{1 << sub_buckets_log_c};
+const int num_buckets_c{64 * sub_buckets_c};
+
+const char* const phase_names_c[kNumProfilePhases]{
+	"graph_parse", "graph_edges", "root_reduction", "evaluate_node",
+	"make_child", "extract_path"};
+
+struct Histogram {
+	long long count{0};
+	long long total{0};
+	long long maximum{0};
+	array<long long, num_buckets_c> buckets{};
+	// runs whose hardware events were counted, and the events, -1 for events
+	// that weren't counted in every one of them
+	long long counted{0};
+	PerfCounts counts{};
+
+	void AddCounts(const PerfCounts& other) {
+		for (int event{0}; event < kNumPerfEvents; ++event) {
+			counts[event] = counts[event] < 0 || other[event] < 0 ? -1 :
+				counts[event] + other[event];
+		}
+	}
+
+	void Add(const Histogram& other) {
+		count += other.count;
+		total += other.total;
+		maximum = max(maximum, other.maximum);
+		for (int i{0}; i < num_buckets_c; ++i) { buckets[i] += other.buckets[i]; }
+		if (other.counted) {
+			counted += other.counted;
+			AddCounts(other.counts);
+		}
+	}
+};
+
+using Histograms = array<Histogram, kNumProfilePhases>;
+
+// values below sub_buckets_c get buckets of their own, and the rest are
+// bucketed by their highest bit and the sub_buckets_log_c bits after it
+int BucketOf(long long value) {
+	if (value < sub_buckets_c) { return int(max(value, 0LL)); }
+	int high_bit{63};
+	while (!(value >> high_bit)) { --high_bit; }
+	const int sub_bucket{int(value >> (high_bit - sub_buckets_log_c)) &
+		(sub_buckets_c - 1)};
+	return (high_bit - sub_buckets_log_c + 1) * sub_buckets_c + sub_bucket;
+}
+
+// the middle of the values the bucket holds
+double BucketValue(int bucket) {
+	if (bucket < sub_buckets_c) { return bucket; }
+	const int shift{bucket / sub_buckets_c - 1};
+	const double low{double((sub_buckets_c + bucket % sub_buckets_c)) *
+		double(1LL << shift)};
+	return low + double(1LL << shift) / 2;
+}
+
+// the value below which the given fraction of the timings fall
+double Percentile(const Histogram& histogram, double fraction) {
+	const long long rank{max(1LL,
+			(long long)(fraction * histogram.count + 0.5))};
+	long long seen{0};
+	for (int bucket{0}; bucket < num_buckets_c; ++bucket) {
+		seen += histogram.buckets[bucket];
+		if (seen >= rank)
+		{ return std::min(BucketValue(bucket), double(histogram.maximum)); }
+	}
+	return double(histogram.maximum);
+}
+
+// the histograms of the threads that exited, and those of the threads that are
+// running, which are only read while writing a report
+mutex registry_mutex;
+Histograms& Retired() {
+	static Histograms retired;
+	return retired;
+}
+vector<const Histograms*>& Live() {
+	static vector<const Histograms*> live;
+	return live;
+}
+
+class ThreadHistograms {
+public:
+	ThreadHistograms() {
+		lock_guard<mutex> lock{registry_mutex};
+		Live().push_back(&histograms);
+	}
+	~ThreadHistograms() {
+		lock_guard<mutex> lock{registry_mutex};
+		for (int phase{0}; phase < kNumProfilePhases; ++phase)
+		{ Retired()[phase].Add(histograms[phase]); }
+		Live().erase(std::find(Live().begin(), Live().end(), &histograms));
+	}
+
+	Histograms histograms;
+};
+
+ThreadHistograms& GetThreadHistograms() {
+	thread_local ThreadHistograms thread_histograms;
+	return thread_histograms;
+}
+
+// whether the timers read the hardware performance counters too
+atomic<bool> counters_enabled{false};
+
+}  // namespace
+
+bool IsProfilingEnabled() {
+#ifdef LITTLETSP_PROFILE
+	return true;
+#else
+	return false;
+#endif
+}
+
+void RecordProfile(ProfilePhase phase, long long nanoseconds) {
+	Histogram& histogram{GetThreadHistograms().histograms[phase]};
+	++histogram.count;
+	histogram.total += nanoseconds;
+	histogram.maximum = max(histogram.maximum, nanoseconds);
+	++histogram.buckets[BucketOf(nanoseconds)];
+}
+
+bool EnableProfileCounters() {
+	if (!PerfCounters{false}.IsAvailable()) { return false; }
+	counters_enabled = true;
+	return true;
+}
+
+bool AreProfileCountersEnabled()
+{ return counters_enabled.load(std::memory_order_relaxed); }
+
+PerfCounts ReadThreadCounters() {
+	// each thread counts itself, so its counters are read as one group
+	thread_local unique_ptr<PerfCounters> counters{new PerfCounters{false}};
+	return counters->Read();
+}
+
+void RecordProfileCounts(ProfilePhase phase, const PerfCounts& counts) {
+	Histogram& histogram{GetThreadHistograms().histograms[phase]};
+	++histogram.counted;
+	histogram.AddCounts(counts);
+}
+
+void WriteProfileReport(ostream& os) {
+	Histograms merged;
+	{
+		// threads that are still running are expected to be idle, as the
+		// threads of a finished solve are
+		lock_guard<mutex> lock{registry_mutex};
+		merged = Retired();
+		for (const Histograms* live : Live()) {
+			for (int phase{0}; phase < kNumProfilePhases; ++phase)
+			{ merged[phase].Add((*live)[phase]); }
+		}
+	}
+
+	os << std::left << setw(16) << "phase" << std::right << setw(12) << "count"
+		<< setw(12) << "total_ms" << setw(12) << "mean_us" << setw(12)
+		<< "p50_us" << setw(12) << "p99_us" << setw(12) << "max_us" << endl;
+	os << std::fixed << std::setprecision(3);
+	for (int phase{0}; phase < kNumProfilePhases; ++phase) {
+		const Histogram& histogram{merged[phase]};
+		if (!histogram.count) { continue; }
+		os << std::left << setw(16) << phase_names_c[phase] << std::right
+			<< setw(12) << histogram.count
+			<< setw(12) << histogram.total / 1e6
+			<< setw(12) << histogram.total / 1e3 / histogram.count
+			<< setw(12) << Percentile(histogram, 0.5) / 1e3
+			<< setw(12) << Percentile(histogram, 0.99) / 1e3
+			<< setw(12) << histogram.maximum / 1e3 << endl;
+	}
+	os.unsetf(std::ios::floatfield);
+	os << std::setprecision(6);
+
+	bool any_counted{false};
+	for (const Histogram& histogram : merged)
+	{ any_counted = any_counted || histogram.counted > 0; }
+	if (!any_counted) { return; }
+	os << endl;
+	WritePerfCountsHeader(os);
+	for (int phase{0}; phase < kNumProfilePhases; ++phase) {
+		const Histogram& histogram{merged[phase]};
+		if (!histogram.counted) { continue; }
+		WritePerfCounts(os, phase_names_c[phase], "call", histogram.counts,
+				histogram.counted);
+	}
+}
@@ -0,0 +1,89 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <iosfwd>
+
+#include "perf_counters.hpp"
+
+// Scoped timers around the phases of a solve. They are compiled in only when
+// LITTLETSP_PROFILE is defined (configure with -Dprofiling=ON), and otherwise
+// PROFILE_SCOPE expands to nothing, so the hot paths pay nothing for them.
+//
+// Each thread records its timings in histograms of its own, with buckets that
+// grow geometrically, so recording takes no locks. A thread's histograms are
+// merged into the global ones when it exits, and the report merges those with
+// the histograms of the threads still running.
+
+enum ProfilePhase {
+	kGraphParse,     // reading a graph's points
+	kGraphEdges,     // building a graph's matrix of edge costs
+	kRootReduction,  // reducing the root's costs for the EdgeEliminator
+	kEvaluateNode,   // TreeNode::CalcLBAndNextEdge
+	kMakeChild,      // making an include or exclude child
+	kExtractPath,    // TreeNode::GetTSPPath
+	kNumProfilePhases
+};
+
+// whether the timers were compiled in
+bool IsProfilingEnabled();
+
+// add a timing of the phase, in nanoseconds, to this thread's histograms
+void RecordProfile(ProfilePhase phase, long long nanoseconds);
+
+// Makes the timers read each thread's hardware performance counters too,
+// which costs two reads of them per scope. Returns false, leaving them off,
+// if the counters are unavailable.
+bool EnableProfileCounters();
+bool AreProfileCountersEnabled();
+// the counts of this thread's counters, opening them on first use
+PerfCounts ReadThreadCounters();
+// add the counts of hardware events during a run of the phase
+void RecordProfileCounts(ProfilePhase phase, const PerfCounts& counts);
+
+// prints the count, total, mean, p50, p99 and maximum of each phase that was
+// timed, with the percentiles accurate to within a few percent, and the
+// hardware events per run of each phase if they were counted
+void WriteProfileReport(std::ostream& os);
+
+#ifdef LITTLETSP_PROFILE
+
+#include <chrono>
+
+class ProfileScope {
+public:
+	explicit ProfileScope(ProfilePhase phase) :
+			phase_{phase}, counting_{AreProfileCountersEnabled()} {
+		if (counting_) { start_counts_ = ReadThreadCounters(); }
+		start_ = std::chrono::steady_clock::now();
+	}
+	~ProfileScope() {
+		RecordProfile(phase_, std::chrono::duration_cast<
+				std::chrono::nanoseconds>(
+					std::chrono::steady_clock::now() - start_).count());
+		if (counting_)
+		{ RecordProfileCounts(phase_, ReadThreadCounters() - start_counts_); }
+	}
+
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+	ProfilePhase phase_;
+	bool counting_;
+	PerfCounts start_counts_;
+	std::chrono::steady_clock::time_point start_;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+// times the rest of the enclosing block as the given phase
+#define PROFILE_SCOPE(phase) \
+	const ProfileScope PROFILE_CONCAT(profile_scope_, __LINE__){phase}
+
+#else
+
+#define PROFILE_SCOPE(phase) static_cast<void>(0)
+
+#endif  // LITTLETSP_PROFILE
+
+#endif  // PROFILE_H
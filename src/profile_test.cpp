@@ -0,0 +1,44 @@
+#include "profile.hpp"
+
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+using std::istringstream;
+using std::ostringstream;
+using std::string;
+using std::thread;
+
+TEST(ProfileTest, Percentiles) {
+	// the timings of a thread that has exited are still reported
+	thread recorder{[] {
+		for (int i{1}; i <= 1000; ++i) { RecordProfile(kExtractPath, i * 1000); }
+	}};
+	recorder.join();
+
+	ostringstream output;
+	WriteProfileReport(output);
+	istringstream report{output.str()};
+	string line;
+	bool found{false};
+	while (getline(report, line)) {
+		istringstream fields{line};
+		string phase;
+		long long count;
+		double total_ms, mean_us, p50_us, p99_us, max_us;
+		fields >> phase;
+		if (phase != "extract_path") { continue; }
+		found = true;
+		fields >> count >> total_ms >> mean_us >> p50_us >> p99_us >> max_us;
+		EXPECT_EQ(1000, count);
+		EXPECT_NEAR(500.5, total_ms, 0.001);
+		EXPECT_NEAR(500.5, mean_us, 0.001);
+		// buckets are at most a fifth as wide as the values in them
+		EXPECT_NEAR(500, p50_us, 100);
+		EXPECT_NEAR(990, p99_us, 200);
+		EXPECT_NEAR(1000, max_us, 0.001);
+	}
+	EXPECT_TRUE(found);
+}
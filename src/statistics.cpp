@@ -0,0 +1,20 @@
+#include "statistics.hpp"
+
+#include <iostream>
+#include <string>
+
+using std::endl;
+using std::ostream;
+using std::string;
+
+long long Statistics::Get(const string& name) const {
+	auto counter_it = counters_.find(name);
+	if (counter_it == counters_.end()) { return 0; }
+	return counter_it->second;
+}
+
+ostream& operator<<(ostream& os, const Statistics& s) {
+	for (const auto& counter : s.counters_)
+	{ os << counter.first << ": " << counter.second << endl; }
+	return os;
+}
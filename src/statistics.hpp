@@ -0,0 +1,31 @@
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include <iosfwd>
+#include <map>
+#include <string>
+
+// Named counters a solver fills in about its last solve, such as how many
+// nodes it evaluated. Counters are kept sorted by name so output is stable.
+class Statistics {
+public:
+	void Clear() { counters_.clear(); }
+
+	void Set(const std::string& name, long long value)
+	{ counters_[name] = value; }
+	void Add(const std::string& name, long long value)
+	{ counters_[name] += value; }
+	// counters that were never set read as 0
+	long long Get(const std::string& name) const;
+
+	const std::map<std::string, long long>& GetCounters() const
+	{ return counters_; }
+
+	// prints one "name: value" line per counter
+	friend std::ostream& operator<<(std::ostream& os, const Statistics& s);
+
+private:
+	std::map<std::string, long long> counters_;
+};
+
+#endif  // STATISTICS_H
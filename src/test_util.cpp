@@ -0,0 +1,49 @@
+#include "test_util.hpp"
+
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include "graph/factory.hpp"
+#include "graph/generator.hpp"
+#include "graph/graph.hpp"
+#include "path.hpp"
+
+#include "gtest/gtest.h"
+
+using std::stringstream;
+using std::unique_ptr;
+using std::vector;
+
+unique_ptr<Graph> MakeRandomGraph(int num_points, int world_size,
+		unsigned seed) {
+	InstanceSpec spec;
+	spec.num_points = num_points;
+	spec.world_size = world_size;
+	spec.seed = seed;
+	stringstream instance;
+	WriteInstance(instance, spec, "text");
+	return CreateGraph("manhattan", instance);
+}
+
+::testing::AssertionResult IsValidTour(const Graph& graph, const Path& tour) {
+	const int num_vertices{graph.GetNumVertices()};
+	if (int(tour.vertices.size()) != num_vertices) {
+		return ::testing::AssertionFailure() << "the tour has "
+			<< tour.vertices.size() << " vertices, not " << num_vertices;
+	}
+	vector<bool> visited(num_vertices, false);
+	for (int vertex : tour.vertices) {
+		if (vertex < 0 || vertex >= num_vertices || visited[vertex]) {
+			return ::testing::AssertionFailure() << "vertex " << vertex
+				<< " is out of range or visited twice";
+		}
+		visited[vertex] = true;
+	}
+	const int length{CalculatePathLength(graph, tour.vertices)};
+	if (length != tour.length) {
+		return ::testing::AssertionFailure() << "the tour's length is "
+			<< tour.length << ", but its vertices are " << length << " long";
+	}
+	return ::testing::AssertionSuccess();
+}
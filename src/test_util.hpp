@@ -0,0 +1,21 @@
+#ifndef TEST_UTIL_H
+#define TEST_UTIL_H
+
+#include <memory>
+
+#include "gtest/gtest.h"
+
+class Graph;
+class Path;
+
+// A manhattan graph of uniformly random points with coordinates from 0 to
+// world_size, made by the instance generator, so the same arguments always
+// give the same graph.
+std::unique_ptr<Graph> MakeRandomGraph(int num_points, int world_size,
+		unsigned seed);
+
+// whether the tour visits every vertex of the graph once and has the length
+// of its vertices, for EXPECT_TRUE and ASSERT_TRUE
+::testing::AssertionResult IsValidTour(const Graph& graph, const Path& tour);
+
+#endif  // TEST_UTIL_H
@@ -0,0 +1,63 @@
+////////////////////////////////////////////////////////////////////////////////
+// Converter of littletsp's search traces to the Chrome trace event format
+////////////////////////////////////////////////////////////////////////////////
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "tsp_solver/little/trace.hpp"
+#include "util.hpp"
+
+#include <gflags/gflags.h>
+
+using std::cerr;
+using std::cin;
+using std::cout;
+using std::endl;
+using std::ifstream;
+using std::ofstream;
+using std::string;
+
+DEFINE_string(input, "", "Trace to convert instead of standard input");
+DEFINE_string(output, "", "File to write instead of standard output");
+
+int main(int argc, char** argv) {
+	gflags::SetUsageMessage(
+			"Converts a trace written by littletsp --trace to JSON that "
+			"Perfetto (ui.perfetto.dev) and chrome://tracing open.\n"
+			"Usage:\n"
+			"\t--input\t\tTrace to convert (Default: standard input)\n"
+			"\t--output\tFile to write the JSON to (Default: standard "
+			"output)\n"
+			"\n"
+			"Example:\n"
+			"\tlittletsp --trace=search.trace < input_graph.txt\n"
+			"\ttracejson --input=search.trace --output=search.json\n");
+	gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+	try {
+		Trace trace;
+		if (FLAGS_input.empty()) { trace = ReadTrace(cin); }
+		else {
+			ifstream input{FLAGS_input, ifstream::binary};
+			if (!input) { throw Error{"Couldn't open the trace!"}; }
+			trace = ReadTrace(input);
+		}
+		if (trace.dropped) {
+			cerr << trace.dropped << " events past the trace limit weren't "
+				"written" << endl;
+		}
+
+		if (FLAGS_output.empty()) { WriteChromeTrace(cout, trace); }
+		else {
+			ofstream output{FLAGS_output};
+			if (!output) { throw Error{"Couldn't open the output file!"}; }
+			WriteChromeTrace(output, trace);
+		}
+	} catch (Error& e) {
+		cerr << "Error: " << e.what() << endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,327 @@
+#include "tsp_solver/anneal.hpp"
+
+#include <cmath>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "graph/distance.hpp"
+#include "graph/graph.hpp"
+#include "graph/neighbors.hpp"
+#include "path.hpp"
+#include "statistics.hpp"
+#include "tsp_solver/array_tour.hpp"
+#include "tsp_solver/cancellation.hpp"
+#include "tsp_solver/double_tree.hpp"
+#include "tsp_solver/local_search.hpp"
+#include "tsp_solver/neighbor_moves.hpp"
+#include "tsp_solver/progress.hpp"
+#include "tsp_solver/two_level_tour.hpp"
+#include "util.hpp"
+
+using std::condition_variable;
+using std::exp;
+using std::function;
+using std::lock_guard;
+using std::mt19937;
+using std::mutex;
+using std::pow;
+using std::seed_seq;
+using std::swap;
+using std::thread;
+using std::uniform_int_distribution;
+using std::unique_lock;
+using std::uniform_real_distribution;
+using std::unique_ptr;
+using std::vector;
+
+// the temperatures run from these fractions of the start tour's average edge
+// length, coldest to hottest
+const double coldest_c{0.02};
+const double hottest_c{0.3};
+
+namespace {
+
+/* Threads that are started once and then run one round of work at a time, so
+ * short rounds don't pay for starting threads. The calling thread takes part
+ * 0 of each round and waits for the workers to finish theirs.
+ */
+class RoundWorkers {
+public:
+	RoundWorkers(int num_parts, function<void(int)> work) :
+			work_{work}, round_{0}, running_{0}, stopped_{false} {
+		for (int part{1}; part < num_parts; ++part)
+		{ threads_.emplace_back(&RoundWorkers::Work, this, part); }
+	}
+	~RoundWorkers() {
+		{
+			lock_guard<mutex> lock{mutex_};
+			stopped_ = true;
+		}
+		started_.notify_all();
+		for (thread& t : threads_) { t.join(); }
+	}
+
+	RoundWorkers(const RoundWorkers&) = delete;
+	RoundWorkers& operator=(const RoundWorkers&) = delete;
+
+	// run every part of one round, returning once they have all finished
+	void RunRound() {
+		{
+			lock_guard<mutex> lock{mutex_};
+			++round_;
+			running_ = int(threads_.size());
+		}
+		started_.notify_all();
+		work_(0);
+		unique_lock<mutex> lock{mutex_};
+		finished_.wait(lock, [this] { return running_ == 0; });
+	}
+
+private:
+	void Work(int part) {
+		long long round{0};
+		while (true) {
+			{
+				unique_lock<mutex> lock{mutex_};
+				started_.wait(lock,
+						[&] { return stopped_ || round_ > round; });
+				if (stopped_) { return; }
+				round = round_;
+			}
+			work_(part);
+			lock_guard<mutex> lock{mutex_};
+			if (--running_ == 0) { finished_.notify_one(); }
+		}
+	}
+
+	function<void(int)> work_;
+	mutex mutex_;
+	condition_variable started_;
+	condition_variable finished_;
+	long long round_;
+	int running_;  // workers that haven't finished the round
+	bool stopped_;
+	vector<thread> threads_;
+};
+
+}  // namespace
+
+// One tour being annealed, with its own random generator.
+template <typename Distance, typename Tour>
+class Replica {
+public:
+	Replica(const Distance& distance, const vector<vector<int>>& neighbors,
+			const Path& start, unsigned seed, int number) :
+			distance_(distance), neighbors_(neighbors), tour_{start.vertices},
+			moves_{distance, neighbors, tour_}, length_{start.length} {
+		seed_seq seeds{seed, unsigned(number)};
+		random_.seed(seeds);
+	}
+
+	// propose the given number of moves at the temperature, half of them 2-opt
+	// moves and half Or-opt moves
+	void Run(long long num_moves, double temperature) {
+		for (long long move{0}; move < num_moves; ++move) {
+			if (move % 2) { TryOrOpt(temperature); }
+			else { TryTwoOpt(temperature); }
+		}
+	}
+
+	int GetLength() const { return length_; }
+	vector<int> GetVertices() const { return tour_.GetVertices(0); }
+
+private:
+	bool Accept(int delta, double temperature) {
+		return delta <= 0 ||
+			uniform_real_distribution<double>{}(random_) <
+			exp(-delta / temperature);
+	}
+
+	int RandomVertex()
+	{ return uniform_int_distribution<int>{0, tour_.size() - 1}(random_); }
+
+	int RandomNeighbor(int vertex) {
+		const vector<int>& neighbors{neighbors_[vertex]};
+		return neighbors[uniform_int_distribution<int>{
+			0, int(neighbors.size()) - 1}(random_)];
+	}
+
+	// replace the edge from a to the vertex after or before it and the
+	// matching edge from one of a's neighbors with one joining a to the
+	// neighbor
+	void TryTwoOpt(double temperature) {
+		const int a{RandomVertex()};
+		const int c{RandomNeighbor(a)};
+		const bool forward{random_() % 2 == 0};
+		const int b{forward ? tour_.Next(a) : tour_.Prev(a)};
+		const int d{forward ? tour_.Next(c) : tour_.Prev(c)};
+		if (c == b || d == a) { return; }
+		const int delta{distance_(a, c) + distance_(b, d) - distance_(a, b) -
+			distance_(c, d)};
+		if (!Accept(delta, temperature)) { return; }
+		tour_.TwoOptMove(a, b, c, d);
+		length_ += delta;
+	}
+
+	// move a segment of one to three vertices that a ends to between one of
+	// a's neighbors and the vertex next to it, joining a to the neighbor
+	void TryOrOpt(double temperature) {
+		using Moves = NeighborMoves<Distance, Tour>;
+		const int length{1 + int(random_() % Moves::max_segment_length)};
+		if (tour_.size() < length + 3) { return; }
+		const int a{RandomVertex()};
+		const bool forward{random_() % 2 == 0};
+		int first{a};
+		int last{a};
+		for (int i{1}; i < length; ++i) {
+			if (forward) { last = tour_.Next(last); }
+			else { first = tour_.Prev(first); }
+		}
+		const int c{RandomNeighbor(a)};
+		if (moves_.InSegment(c, first, last)) { return; }
+		// the segment goes between x and the vertex y after it, one of which
+		// is c
+		const int x{random_() % 2 == 0 ? c : tour_.Prev(c)};
+		const int y{tour_.Next(x)};
+		if (moves_.InSegment(x, first, last) ||
+				moves_.InSegment(y, first, last)) { return; }
+
+		const int before{tour_.Prev(first)};
+		const int after{tour_.Next(last)};
+		const int other_end{a == first ? last : first};
+		const int o{x == c ? y : x};
+		const int delta{distance_(a, c) + distance_(other_end, o) +
+			distance_(before, after) - distance_(before, first) -
+			distance_(last, after) - distance_(x, y)};
+		if (!Accept(delta, temperature)) { return; }
+		moves_.MoveSegment(first, last, x, y, (x == c) == (a == first));
+		length_ += delta;
+	}
+
+	const Distance& distance_;
+	const vector<vector<int>>& neighbors_;
+	Tour tour_;
+	NeighborMoves<Distance, Tour> moves_;
+	int length_;
+	mt19937 random_;
+};
+
+template <typename Tour, typename Distance>
+static Path Temper(const Distance& distance,
+		const vector<vector<int>>& neighbors, const Path& start,
+		const SolverOptions& options, Statistics& statistics);
+
+AnnealTSPSolver::AnnealTSPSolver(const SolverOptions& options) :
+		TSPSolver{false}, options_{options} {
+	if (options_.neighbors <= 0)
+	{ throw Error{"The anneal solver needs at least one neighbor!"}; }
+	if (options_.replicas <= 0)
+	{ throw Error{"The anneal solver needs at least one replica!"}; }
+}
+
+Path AnnealTSPSolver::Solve(const Graph& graph) const {
+	statistics_.Clear();
+	// catch the case with 0 vertices
+	if (graph.GetNumVertices() == 0) { return Path{}; }
+
+	// the neighbor lists are only found once, for the replicas and ImproveTour
+	const vector<vector<int>> neighbors{
+		NearestNeighbors(graph, options_.neighbors)};
+	SolverOptions start_options{options_};
+	start_options.neighbors = 0;
+	const DoubleTreeTSPSolver double_tree{start_options};
+	const Path start{ImproveTour(graph, double_tree.Solve(graph), neighbors)};
+	statistics_.Set("lower_bound",
+			double_tree.GetStatistics().Get("lower_bound"));
+	if (start.vertices.size() < 5) { return start; }
+
+	Path path{WithDistance(graph, [&](const auto& distance) {
+		if (graph.GetNumVertices() >= two_level_tour_size_c) {
+			return Temper<TwoLevelTour>(distance, neighbors, start, options_,
+					statistics_);
+		}
+		return Temper<ArrayTour>(distance, neighbors, start, options_,
+				statistics_);
+	})};
+	path = ImproveTour(graph, path, neighbors);
+	ShareTour(path, options_);
+	return path;
+}
+
+// Runs rounds of moves on every replica, each round split among the threads,
+// and lets the replicas swap temperatures between rounds.
+template <typename Tour, typename Distance>
+Path Temper(const Distance& distance, const vector<vector<int>>& neighbors,
+		const Path& start, const SolverOptions& options,
+		Statistics& statistics) {
+	using AnnealReplica = Replica<Distance, Tour>;
+	const int num_vertices{int(start.vertices.size())};
+	const int num_replicas{options.replicas};
+	// held by pointer, since each one's moves refer to its tour
+	vector<unique_ptr<AnnealReplica>> replicas;
+	for (int number{0}; number < num_replicas; ++number) {
+		replicas.emplace_back(new AnnealReplica{distance, neighbors, start,
+				options.seed, number});
+	}
+
+	// the temperature of each place in the ladder, coldest first, and the
+	// replica at each place
+	const double edge_length{double(start.length) / num_vertices};
+	vector<double> temperatures;
+	vector<int> ladder;
+	for (int place{0}; place < num_replicas; ++place) {
+		const double fraction{num_replicas == 1 ? 0 :
+			double(place) / (num_replicas - 1)};
+		temperatures.push_back(edge_length * coldest_c *
+				pow(hottest_c / coldest_c, fraction));
+		ladder.push_back(place);
+	}
+
+	CancellationToken budget{options.cancellation, options.time_budget};
+	mt19937 random{options.seed};
+	Path best{start};
+	const int num_threads{options.threads < num_replicas ?
+		options.threads : num_replicas};
+	// each thread runs every num_threads-th place in the ladder
+	RoundWorkers workers{num_threads, [&](int first_place) {
+		for (int place{first_place}; place < num_replicas;
+				place += num_threads)
+		{ replicas[ladder[place]]->Run(num_vertices, temperatures[place]); }
+	}};
+	long long rounds{0};
+	long long exchanges{0};
+	while ((options.rounds == 0 || rounds < options.rounds) &&
+			!budget.IsCancelled()) {
+		++rounds;
+		workers.RunRound();
+
+		for (const unique_ptr<AnnealReplica>& replica : replicas) {
+			if (replica->GetLength() >= best.length) { continue; }
+			best.vertices = replica->GetVertices();
+			best.length = replica->GetLength();
+			ShareTour(best, options);
+		}
+		// a hotter replica with a shorter tour always moves down, and one with
+		// a longer tour does with the probability it would get there by moves
+		for (int place{0}; place + 1 < num_replicas; ++place) {
+			const int colder{replicas[ladder[place]]->GetLength()};
+			const int hotter{replicas[ladder[place + 1]]->GetLength()};
+			const double exponent{(colder - hotter) *
+				(1 / temperatures[place] - 1 / temperatures[place + 1])};
+			if (exponent >= 0 ||
+					uniform_real_distribution<double>{}(random) < exp(exponent)) {
+				swap(ladder[place], ladder[place + 1]);
+				++exchanges;
+			}
+		}
+	}
+	statistics.Set("rounds", rounds);
+	statistics.Set("exchanges", exchanges);
+	return best;
+}
@@ -0,0 +1,34 @@
+#ifndef TSP_SOLVER_ANNEAL_H
+#define TSP_SOLVER_ANNEAL_H
+
+#include "tsp_solver/options.hpp"
+#include "tsp_solver/tsp_solver.hpp"
+
+/* Solves the TSP with parallel tempering, a heuristic that may not be optimal.
+ * options.replicas copies of the mst solver's tour each make random 2-opt and
+ * Or-opt moves that join a vertex to one of its options.neighbors nearest
+ * neighbors, keeping every move that shortens its tour and a move that
+ * lengthens it by delta with probability exp(-delta / T). Each replica has its
+ * own temperature T, from one that keeps almost only shortening moves to one
+ * that wanders far, and after each round of moves replicas next to each other
+ * in temperature swap temperatures by the usual Metropolis rule, so good tours
+ * found by the hot replicas cool down and are refined. options.threads threads
+ * run the rounds until options.time_budget seconds have passed or
+ * options.rounds rounds are done. Each replica is seeded with options.seed and
+ * its number, so a run limited only by options.rounds makes the same tour
+ * with any number of threads. The shortest tour seen between rounds is
+ * improved with ImproveTour and returned. The minimum spanning tree's length is
+ * recorded as the "lower_bound" statistic.
+ */
+class AnnealTSPSolver : public TSPSolver {
+public:
+	AnnealTSPSolver() : AnnealTSPSolver{SolverOptions{}} {}
+	explicit AnnealTSPSolver(const SolverOptions& options);
+
+	Path Solve(const Graph&) const override;
+
+private:
+	SolverOptions options_;
+};
+
+#endif  // TSP_SOLVER_ANNEAL_H
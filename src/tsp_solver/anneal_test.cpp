@@ -0,0 +1,27 @@
+#include "tsp_solver/anneal.hpp"
+
+#include <memory>
+
+#include "graph/graph.hpp"
+#include "path.hpp"
+#include "test_util.hpp"
+#include "tsp_solver/double_tree.hpp"
+#include "tsp_solver/options.hpp"
+
+#include "gtest/gtest.h"
+
+using std::unique_ptr;
+
+TEST(AnnealTest, RandomPoints) {
+	unique_ptr<Graph> graph{MakeRandomGraph(400, 1000, 9)};
+
+	// runs without a time budget, so they make the same tour every time
+	SolverOptions options;
+	options.time_budget = 0;
+	options.rounds = 50;
+	const AnnealTSPSolver solver{options};
+	const Path tour{solver.Solve(*graph)};
+	EXPECT_EQ(50, solver.GetStatistics().Get("rounds"));
+	EXPECT_TRUE(IsValidTour(*graph, tour));
+	EXPECT_LE(tour.length, DoubleTreeTSPSolver{}.Solve(*graph).length);
+}
@@ -0,0 +1,46 @@
+#include "tsp_solver/array_tour.hpp"
+
+#include <algorithm>
+#include <vector>
+
+using std::swap;
+using std::vector;
+
+ArrayTour::ArrayTour(const vector<int>& vertices) : vertices_{vertices},
+		positions_(vertices.size()) {
+	for (int i{0}; i < size(); ++i) { positions_[vertices_[i]] = i; }
+}
+
+void ArrayTour::TwoOptMove(int a, int b, int c, int) {
+	if (Next(a) == b) { Reverse(b, c); }
+	else { Reverse(c, b); }
+}
+
+vector<int> ArrayTour::GetVertices(int first) const {
+	vector<int> vertices;
+	vertices.insert(vertices.end(), vertices_.begin() + positions_[first],
+			vertices_.end());
+	vertices.insert(vertices.end(), vertices_.begin(),
+			vertices_.begin() + positions_[first]);
+	return vertices;
+}
+
+void ArrayTour::Reverse(int first, int last) {
+	int i{positions_[first]};
+	int j{positions_[last]};
+	int length{(j - i + size()) % size() + 1};
+	// reversing the rest of the tour gives the same cycle
+	if (2 * length > size()) {
+		const int rest_first{j + 1 == size() ? 0 : j + 1};
+		j = i == 0 ? size() - 1 : i - 1;
+		i = rest_first;
+		length = size() - length;
+	}
+	for (int swaps{0}; swaps < length / 2; ++swaps) {
+		swap(vertices_[i], vertices_[j]);
+		positions_[vertices_[i]] = i;
+		positions_[vertices_[j]] = j;
+		i = i + 1 == size() ? 0 : i + 1;
+		j = j == 0 ? size() - 1 : j - 1;
+	}
+}
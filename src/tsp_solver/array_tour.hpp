@@ -0,0 +1,40 @@
+#ifndef TSP_SOLVER_ARRAY_TOUR_H
+#define TSP_SOLVER_ARRAY_TOUR_H
+
+#include <vector>
+
+/* A tour kept as an array of its vertices and the position of each vertex in
+ * it, for local search. Finding the vertices next to one is O(1), and
+ * reversing part of the tour reverses whichever side of it is shorter, so it
+ * moves at most half the vertices. Which way around the tour "next" goes can
+ * change with each reversal, so moves should be written in terms of the edges
+ * they remove and add.
+ */
+class ArrayTour {
+public:
+	explicit ArrayTour(const std::vector<int>& vertices);
+
+	int Next(int vertex) const
+	{ return vertices_[positions_[vertex] + 1 == size() ? 0 :
+		positions_[vertex] + 1]; }
+	int Prev(int vertex) const
+	{ return vertices_[positions_[vertex] == 0 ? size() - 1 :
+		positions_[vertex] - 1]; }
+	int size() const { return int(vertices_.size()); }
+
+	// remove the edges (a, b) and (c, d) and add (a, c) and (b, d), where b
+	// follows a if and only if d follows c
+	void TwoOptMove(int a, int b, int c, int d);
+
+	// the vertices in tour order, starting with the given one
+	std::vector<int> GetVertices(int first) const;
+
+private:
+	// reverse the vertices from first to last, going forward
+	void Reverse(int first, int last);
+
+	std::vector<int> vertices_;
+	std::vector<int> positions_;
+};
+
+#endif  // TSP_SOLVER_ARRAY_TOUR_H
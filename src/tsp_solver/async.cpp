@@ -0,0 +1,37 @@
+#include "tsp_solver/async.hpp"
+
+#include <future>
+#include <memory>
+
+#include "graph/graph.hpp"
+#include "path.hpp"
+#include "statistics.hpp"
+#include "tsp_solver/cancellation.hpp"
+#include "tsp_solver/factory.hpp"
+#include "tsp_solver/options.hpp"
+#include "tsp_solver/tsp_solver.hpp"
+
+using std::async;
+using std::future;
+using std::launch;
+using std::unique_ptr;
+
+SolveResult Solve(const Graph& graph, const SolveRequest& request) {
+	CancellationToken cancellation{request.options.cancellation,
+		request.time_limit};
+	SolverOptions options{request.options};
+	options.cancellation = &cancellation;
+
+	unique_ptr<TSPSolver> solver{CreateTSPSolver(request.solver, options)};
+	SolveResult result;
+	result.tour = solver->Solve(graph, request.upper_bound);
+	result.statistics = solver->GetStatistics();
+	result.optimal = solver->is_optimal() && options.gap == 0 &&
+		!result.statistics.Get("cancelled");
+	return result;
+}
+
+future<SolveResult> SolveAsync(const Graph& graph, SolveRequest request) {
+	return async(launch::async,
+			[&graph, request] { return Solve(graph, request); });
+}
@@ -0,0 +1,45 @@
+#ifndef TSP_SOLVER_ASYNC_H
+#define TSP_SOLVER_ASYNC_H
+
+#include <future>
+#include <limits>
+#include <string>
+
+#include "path.hpp"
+#include "statistics.hpp"
+#include "tsp_solver/options.hpp"
+
+class Graph;
+
+// Everything needed to solve one graph, for programs that embed the solvers.
+// Threads, progress callbacks and cancellation are set in the options.
+struct SolveRequest {
+	// the type of solver to use, see IsValidTSPSolverType
+	std::string solver{"little"};
+	SolverOptions options;
+	// only tours shorter than this are looked for
+	int upper_bound{std::numeric_limits<int>::max()};
+	// seconds after which the solver stops with the best tour it has, 0 for no
+	// limit
+	double time_limit{0};
+};
+
+struct SolveResult {
+	// empty if no tour beat the upper bound
+	Path tour;
+	Statistics statistics;
+	// whether no tour is shorter than this one, or than the upper bound if it
+	// is empty: the solver is exact, ran to the end and had no gap
+	bool optimal{false};
+};
+
+// Solve the graph on the calling thread, so requests can be run on any
+// executor. A solver that was cancelled or ran out of time still returns the
+// best tour it found.
+SolveResult Solve(const Graph& graph, const SolveRequest& request);
+
+// Solve the graph on a new thread. The graph, and anything the options point
+// to, must outlive the future.
+std::future<SolveResult> SolveAsync(const Graph& graph, SolveRequest request);
+
+#endif  // TSP_SOLVER_ASYNC_H
@@ -0,0 +1,87 @@
+#include "tsp_solver/async.hpp"
+
+#include <future>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include "graph/factory.hpp"
+#include "graph/graph.hpp"
+#include "tsp_solver/cancellation.hpp"
+#include "tsp_solver/progress.hpp"
+
+#include "gtest/gtest.h"
+
+using std::future;
+using std::istringstream;
+using std::unique_ptr;
+using std::vector;
+
+// 16 points on a manhattan grid, the shortest tour has length 534
+const char* const graph_input{
+	"100 16 17 72 97 8 32 15 63 97 57 60 83 48 100 26 12 62 3 49 55 77 97 98 "
+	"0 89 57 34 92 29 75 13 40 3"};
+
+class SolveAsyncTest : public ::testing::Test {
+public:
+	SolveAsyncTest() {
+		istringstream input{graph_input};
+		graph = CreateGraph("manhattan", input);
+	}
+
+protected:
+	unique_ptr<Graph> graph;
+};
+
+TEST_F(SolveAsyncTest, FindsOptimum) {
+	future<SolveResult> result{SolveAsync(*graph, SolveRequest{})};
+	SolveResult solved{result.get()};
+	EXPECT_EQ(534, solved.tour.length);
+	EXPECT_EQ(16, int(solved.tour.vertices.size()));
+	EXPECT_TRUE(solved.optimal);
+}
+
+TEST_F(SolveAsyncTest, Threads) {
+	SolveRequest request;
+	request.options.threads = 2;
+	SolveResult solved{SolveAsync(*graph, request).get()};
+	EXPECT_EQ(534, solved.tour.length);
+	EXPECT_TRUE(solved.optimal);
+	EXPECT_EQ(2, solved.statistics.Get("threads"));
+}
+
+TEST_F(SolveAsyncTest, Cancelled) {
+	CancellationToken cancellation;
+	cancellation.Cancel();
+	SolveRequest request;
+	request.options.cancellation = &cancellation;
+	SolveResult solved{SolveAsync(*graph, request).get()};
+	EXPECT_FALSE(solved.optimal);
+	EXPECT_EQ(1, solved.statistics.Get("cancelled"));
+	EXPECT_LE(solved.statistics.Get("lower_bound"), 534);
+}
+
+TEST_F(SolveAsyncTest, TimeLimit) {
+	SolveRequest request;
+	request.time_limit = 1e-9;
+	SolveResult solved{Solve(*graph, request)};
+	EXPECT_FALSE(solved.optimal);
+	EXPECT_EQ(1, solved.statistics.Get("cancelled"));
+}
+
+TEST_F(SolveAsyncTest, Progress) {
+	vector<SolveProgress> reports;
+	SolveRequest request;
+	request.options.progress_interval = 0;
+	request.options.progress =
+		[&reports](const SolveProgress& progress)
+		{ reports.push_back(progress); };
+	SolveResult solved{Solve(*graph, request)};
+	EXPECT_EQ(534, solved.tour.length);
+	ASSERT_FALSE(reports.empty());
+	for (const SolveProgress& progress : reports) {
+		EXPECT_LE(progress.lower_bound, 534);
+		EXPECT_GE(progress.upper_bound, 534);
+	}
+	EXPECT_EQ(534, reports.back().upper_bound);
+}
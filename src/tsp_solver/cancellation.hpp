@@ -0,0 +1,50 @@
+#ifndef TSP_SOLVER_CANCELLATION_H
+#define TSP_SOLVER_CANCELLATION_H
+
+#include <atomic>
+#include <chrono>
+
+// Lets one thread ask solvers running on others to stop early. Solvers check
+// the token in their main loops and return the best tour they have so far once
+// it is cancelled.
+class CancellationToken {
+public:
+	CancellationToken() : CancellationToken{nullptr} {}
+	// a token that is also cancelled whenever the parent is
+	explicit CancellationToken(const CancellationToken* parent) :
+		cancelled_{false}, parent_{parent}, has_deadline_{false} {}
+	// a child of the parent that also cancels itself once the given number of
+	// seconds have passed, which is how solvers keep to a time budget, and
+	// never does if it isn't positive
+	CancellationToken(const CancellationToken* parent, double seconds) :
+			CancellationToken{parent} {
+		if (seconds > 0) {
+			CancelAfter(std::chrono::duration_cast<
+					std::chrono::steady_clock::duration>(
+						std::chrono::duration<double>{seconds}));
+		}
+	}
+
+	void Cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+
+	// Cancel the token once the given time has passed. Call this before handing
+	// the token to a solver, since the deadline itself isn't atomic.
+	void CancelAfter(std::chrono::steady_clock::duration timeout) {
+		deadline_ = std::chrono::steady_clock::now() + timeout;
+		has_deadline_ = true;
+	}
+
+	bool IsCancelled() const {
+		if (cancelled_.load(std::memory_order_relaxed)) { return true; }
+		if (parent_ && parent_->IsCancelled()) { return true; }
+		return has_deadline_ && std::chrono::steady_clock::now() >= deadline_;
+	}
+
+private:
+	std::atomic<bool> cancelled_;
+	const CancellationToken* parent_;
+	bool has_deadline_;
+	std::chrono::steady_clock::time_point deadline_;
+};
+
+#endif  // TSP_SOLVER_CANCELLATION_H
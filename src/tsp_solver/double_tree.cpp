@@ -0,0 +1,55 @@
+#include "tsp_solver/double_tree.hpp"
+
+#include <vector>
+
+#include "graph/edge.hpp"
+#include "graph/graph.hpp"
+#include "graph/spanning_tree.hpp"
+#include "path.hpp"
+#include "tsp_solver/local_search.hpp"
+
+using std::vector;
+
+Path DoubleTreeTSPSolver::Solve(const Graph& graph) const {
+	statistics_.Clear();
+	const int num_vertices{graph.GetNumVertices()};
+	// catch the case with 0 vertices
+	if (num_vertices == 0) { return Path{}; }
+
+	const vector<Edge> tree{MinimumSpanningTree(graph)};
+	int tree_length{0};
+	// the tree's edges at each vertex, as a range of one array
+	vector<int> firsts(num_vertices + 1, 0);
+	for (const Edge& edge : tree) {
+		tree_length += graph.GetDistance(edge.u, edge.v);
+		++firsts[edge.u + 1];
+		++firsts[edge.v + 1];
+	}
+	for (int vertex{0}; vertex < num_vertices; ++vertex)
+	{ firsts[vertex + 1] += firsts[vertex]; }
+	vector<int> adjacent(firsts.back());
+	vector<int> filled(firsts.begin(), firsts.end() - 1);
+	for (const Edge& edge : tree) {
+		adjacent[filled[edge.u]++] = edge.v;
+		adjacent[filled[edge.v]++] = edge.u;
+	}
+	statistics_.Set("lower_bound", tree_length);
+
+	// the order a depth first search from vertex 0 first reaches the vertices
+	Path path;
+	vector<char> visited(num_vertices, false);
+	vector<int> stack{0};
+	while (!stack.empty()) {
+		const int vertex{stack.back()};
+		stack.pop_back();
+		if (visited[vertex]) { continue; }
+		visited[vertex] = true;
+		path.vertices.push_back(vertex);
+		for (int i{firsts[vertex + 1] - 1}; i >= firsts[vertex]; --i)
+		{ if (!visited[adjacent[i]]) { stack.push_back(adjacent[i]); } }
+	}
+	path.length = CalculatePathLength(graph, path.vertices);
+	if (options_.neighbors > 0)
+	{ path = ImproveTour(graph, path, options_.neighbors); }
+	return path;
+}
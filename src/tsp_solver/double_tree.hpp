@@ -0,0 +1,27 @@
+#ifndef TSP_SOLVER_DOUBLE_TREE_H
+#define TSP_SOLVER_DOUBLE_TREE_H
+
+#include "tsp_solver/options.hpp"
+#include "tsp_solver/tsp_solver.hpp"
+
+/* Solves the TSP with the double tree heuristic: walking around a minimum
+ * spanning tree passes every edge twice, and skipping the vertices already
+ * visited turns the walk into a tour at most twice as long as the tree, so at
+ * most twice the optimum. Takes O(N log N) time on a graph with coordinates
+ * and O(N^2) otherwise, see MinimumSpanningTree. The tree's length is a lower
+ * bound on the optimum, recorded as the "lower_bound" statistic. The tour is
+ * then improved with ImproveTour, unless options.neighbors is 0.
+ */
+class DoubleTreeTSPSolver : public TSPSolver {
+public:
+	DoubleTreeTSPSolver() : DoubleTreeTSPSolver{SolverOptions{}} {}
+	explicit DoubleTreeTSPSolver(const SolverOptions& options) :
+		TSPSolver{false}, options_{options} {}
+
+	Path Solve(const Graph&) const override;
+
+private:
+	SolverOptions options_;
+};
+
+#endif  // TSP_SOLVER_DOUBLE_TREE_H
@@ -4,9 +4,16 @@
 #include <memory>
 #include <unordered_set>
 
+#include "tsp_solver/anneal.hpp"
+#include "tsp_solver/double_tree.hpp"
 #include "tsp_solver/fast.hpp"
+#include "tsp_solver/hilbert.hpp"
+#include "tsp_solver/lin_kernighan.hpp"
 #include "tsp_solver/little/solver.hpp"
+#include "tsp_solver/multi_start.hpp"
 #include "tsp_solver/naive.hpp"
+#include "tsp_solver/options.hpp"
+#include "tsp_solver/portfolio.hpp"
 #include "tsp_solver/tsp_solver.hpp"
 #include "util.hpp"
 
@@ -17,20 +24,41 @@ using std::unordered_set;
 const string naive_tsp_type_c{"naive"};
 const string little_tsp_type_c{"little"};
 const string fast_tsp_type_c{"fast"};
+const string lk_tsp_type_c{"lk"};
+const string hilbert_tsp_type_c{"hilbert"};
+const string mst_tsp_type_c{"mst"};
+const string multistart_tsp_type_c{"multistart"};
+const string anneal_tsp_type_c{"anneal"};
+const string portfolio_tsp_type_c{"portfolio"};
 const unordered_set<string> valid_tsp_types{
-	naive_tsp_type_c, little_tsp_type_c, fast_tsp_type_c};
+	naive_tsp_type_c, little_tsp_type_c, fast_tsp_type_c, lk_tsp_type_c,
+	hilbert_tsp_type_c, mst_tsp_type_c, multistart_tsp_type_c,
+	anneal_tsp_type_c, portfolio_tsp_type_c};
 
 
 bool IsValidTSPSolverType(const std::string& type)
 { return valid_tsp_types.find(type) != valid_tsp_types.end(); }
 
 
-unique_ptr<TSPSolver> CreateTSPSolver(const string& type) {
+unique_ptr<TSPSolver> CreateTSPSolver(const string& type,
+		const SolverOptions& options) {
 	if (type == naive_tsp_type_c)
-		{ return unique_ptr<TSPSolver>{new NaiveTSPSolver{}}; }
+		{ return unique_ptr<TSPSolver>{new NaiveTSPSolver{options}}; }
 	if (type == little_tsp_type_c)
-		{ return unique_ptr<TSPSolver>{new LittleTSPSolver{}}; }
+		{ return unique_ptr<TSPSolver>{new LittleTSPSolver{options}}; }
 	if (type == fast_tsp_type_c)
-		{ return unique_ptr<TSPSolver>{new FastTSPSolver{}}; }
+		{ return unique_ptr<TSPSolver>{new FastTSPSolver{options}}; }
+	if (type == lk_tsp_type_c)
+		{ return unique_ptr<TSPSolver>{new LinKernighanTSPSolver{options}}; }
+	if (type == hilbert_tsp_type_c)
+		{ return unique_ptr<TSPSolver>{new HilbertTSPSolver{options}}; }
+	if (type == mst_tsp_type_c)
+		{ return unique_ptr<TSPSolver>{new DoubleTreeTSPSolver{options}}; }
+	if (type == multistart_tsp_type_c)
+		{ return unique_ptr<TSPSolver>{new MultiStartTSPSolver{options}}; }
+	if (type == anneal_tsp_type_c)
+		{ return unique_ptr<TSPSolver>{new AnnealTSPSolver{options}}; }
+	if (type == portfolio_tsp_type_c)
+		{ return unique_ptr<TSPSolver>{new PortfolioTSPSolver{options}}; }
 	throw Error{"Not a valid TSP solver type!"};
 }
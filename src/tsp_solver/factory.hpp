@@ -4,10 +4,13 @@
 #include <memory>
 #include <string>
 
+#include "tsp_solver/options.hpp"
+
 class TSPSolver;
 
 bool IsValidTSPSolverType(const std::string& type);
 
-std::unique_ptr<TSPSolver> CreateTSPSolver(const std::string& type);
+std::unique_ptr<TSPSolver> CreateTSPSolver(const std::string& type,
+		const SolverOptions& options = SolverOptions{});
 
 #endif  // TSP_SOLVER_FACTORY_H
@@ -0,0 +1,92 @@
+#include "tsp_solver/factory.hpp"
+
+#include <memory>
+#include <ostream>
+#include <string>
+
+#include "graph/graph.hpp"
+#include "path.hpp"
+#include "test_util.hpp"
+#include "tsp_solver/options.hpp"
+#include "tsp_solver/tsp_solver.hpp"
+
+#include "gtest/gtest.h"
+
+using std::ostream;
+using std::string;
+using std::unique_ptr;
+
+// a solver that splits its work among threads, and an instance for it
+struct ThreadedSolver {
+	string type;
+	int num_points;
+	int world_size;
+	unsigned seed;
+};
+
+void PrintTo(const ThreadedSolver& solver, ostream* os)
+{ *os << solver.type << " on " << solver.num_points << " points"; }
+
+class SameTourWithAnyThreadsTest :
+	public ::testing::TestWithParam<ThreadedSolver> {};
+
+TEST_P(SameTourWithAnyThreadsTest, MatchesOneThread) {
+	const ThreadedSolver& solver{GetParam()};
+	unique_ptr<Graph> graph{MakeRandomGraph(solver.num_points,
+			solver.world_size, solver.seed)};
+
+	// runs without a time budget, so they make the same tour every time
+	SolverOptions options;
+	options.time_budget = 0;
+	options.starts = 20;
+	options.rounds = 50;
+	const Path tour{CreateTSPSolver(solver.type, options)->Solve(*graph)};
+	EXPECT_TRUE(IsValidTour(*graph, tour));
+	for (int threads{2}; threads <= 4; ++threads) {
+		options.threads = threads;
+		const Path threaded{
+			CreateTSPSolver(solver.type, options)->Solve(*graph)};
+		EXPECT_EQ(tour.vertices, threaded.vertices) << threads << " threads";
+		EXPECT_EQ(tour.length, threaded.length) << threads << " threads";
+	}
+}
+
+INSTANTIATE_TEST_CASE_P(Solvers, SameTourWithAnyThreadsTest, ::testing::Values(
+		ThreadedSolver{"naive", 10, 100, 11},
+		ThreadedSolver{"hilbert", 5000, 100000, 7},
+		ThreadedSolver{"multistart", 300, 1000, 8},
+		ThreadedSolver{"anneal", 400, 1000, 9}));
+
+// an exact solver and how it splits its search
+struct ExactSolver {
+	string type;
+	int threads;
+	int processes;
+};
+
+void PrintTo(const ExactSolver& solver, ostream* os) {
+	*os << solver.type << " with " << solver.threads << " threads and "
+		<< solver.processes << " processes";
+}
+
+class NoShorterTourTest : public ::testing::TestWithParam<ExactSolver> {};
+
+TEST_P(NoShorterTourTest, ReturnsEmptyPath) {
+	const ExactSolver& solver{GetParam()};
+	unique_ptr<Graph> graph{MakeRandomGraph(12, 100, 14)};
+	SolverOptions options;
+	options.threads = solver.threads;
+	options.processes = solver.processes;
+	options.portfolio = "little,little:strong";
+	unique_ptr<TSPSolver> tsp_solver{CreateTSPSolver(solver.type, options)};
+	const Path optimum{tsp_solver->Solve(*graph)};
+	EXPECT_TRUE(IsValidTour(*graph, optimum));
+
+	const Path none{tsp_solver->Solve(*graph, optimum.length)};
+	EXPECT_TRUE(none.vertices.empty());
+	EXPECT_EQ(0, none.length);
+}
+
+INSTANTIATE_TEST_CASE_P(Solvers, NoShorterTourTest, ::testing::Values(
+		ExactSolver{"little", 1, 1}, ExactSolver{"little", 3, 1},
+		ExactSolver{"little", 1, 3}, ExactSolver{"portfolio", 1, 1}));
@@ -1,116 +1,285 @@
 #include "tsp_solver/fast.hpp"
 
-#include <unordered_set>
 #include <algorithm>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
 
+#include "graph/distance.hpp"
 #include "graph/graph.hpp"
-#include "graph/edge_cost.hpp"
 #include "path.hpp"
+#include "tsp_solver/local_search.hpp"
+#include "util.hpp"
 
+using std::greater;
+using std::less;
+using std::min;
+using std::numeric_limits;
+using std::string;
 using std::vector;
-using std::unordered_set;
-using std::min_element;
-using std::max_element;
-
-// a struct for helping with the cheapest insertion heuristic
-// keeps track of distances between a certain vertex and the rest
-struct FastTable
-{
-	vector<int> distances;
-	FastTable(int size) : distances{size} {}
-
-	bool operator()(int first, int second) {
-		return distances[first] < distances[second];
+
+const int infinity{numeric_limits<int>::max()};
+
+const string nearest_insertion_c{"nearest"};
+const string farthest_insertion_c{"farthest"};
+const string cheapest_insertion_c{"cheapest"};
+
+// The tour as it is built, a cycle kept as a linked list, so
+// inserting is O(1). The list lives in flat arrays indexed by the order the
+// vertices joined the tour, which hold the points of both ends of each edge,
+// so searching every edge for where to insert a vertex is one pass over them
+// that never follows a link. The graph is taken to be undirected.
+template <typename Distance>
+class InsertionTour {
+public:
+	using Point = typename Distance::Point;
+
+	InsertionTour(int num_vertices, int first, const Distance& distance) :
+			distance_{distance}, slots_(num_vertices, -1) {
+		// the first vertex alone is a tour with an edge to itself
+		AddSlot(first, first);
+	}
+
+	// put the vertex between after and the vertex that follows it
+	void InsertAfter(int after, int vertex) {
+		const int slot{slots_[after]};
+		const int before{next_[slot]};
+		next_[slot] = vertex;
+		next_points_[slot] = distance_.GetPoint(vertex);
+		next_distance_[slot] = distance_(after, vertex);
+		AddSlot(vertex, before);
 	}
+
+	// how much longer the tour gets with the vertex put after the given one
+	int InsertionCost(int after, int vertex) const {
+		const int slot{slots_[after]};
+		return distance_(after, vertex) + distance_(vertex, next_[slot]) -
+			next_distance_[slot];
+	}
+
+	// the vertex to put the given one after so the tour gets the least longer,
+	// and how much longer it gets, including the edge back to the first vertex
+	int CheapestPosition(int vertex, int& cost) const {
+		const Point point{distance_.GetPoint(vertex)};
+		int best{0};
+		cost = infinity;
+		for (int slot{0}; slot < int(vertices_.size()); ++slot) {
+			const int added{distance_(points_[slot], point) +
+				distance_(point, next_points_[slot]) - next_distance_[slot]};
+			if (added < cost) {
+				cost = added;
+				best = slot;
+			}
+		}
+		return vertices_[best];
+	}
+
+	int GetNext(int vertex) const { return next_[slots_[vertex]]; }
+
+	// the tour from vertex 0, once it has joined
+	Path GetPath() const {
+		Path path;
+		int vertex{0};
+		do {
+			path.vertices.push_back(vertex);
+			path.length += next_distance_[slots_[vertex]];
+			vertex = next_[slots_[vertex]];
+		} while (vertex != 0);
+		return path;
+	}
+
+private:
+	void AddSlot(int vertex, int next) {
+		slots_[vertex] = int(vertices_.size());
+		vertices_.push_back(vertex);
+		next_.push_back(next);
+		points_.push_back(distance_.GetPoint(vertex));
+		next_points_.push_back(distance_.GetPoint(next));
+		next_distance_.push_back(distance_(vertex, next));
+	}
+
+	const Distance& distance_;
+	// the slot of each vertex in the tour
+	vector<int> slots_;
+	// for each slot, its vertex, the vertex after it in the tour, their points
+	// and the length of the edge between them
+	vector<int> vertices_;
+	vector<int> next_;
+	vector<Point> points_;
+	vector<Point> next_points_;
+	vector<int> next_distance_;
 };
 
+template <typename Distance, typename Compare>
+static Path InsertByDistance(int num_vertices, int first,
+		const Distance& distance, Compare comes_first);
+template <typename Distance>
+static Path InsertCheapest(int num_vertices, int first,
+		const Distance& distance);
+
+bool IsValidInsertionType(const string& type) {
+	return type == nearest_insertion_c || type == farthest_insertion_c ||
+		type == cheapest_insertion_c;
+}
+
+FastTSPSolver::FastTSPSolver(const SolverOptions& options) :
+		TSPSolver{false}, options_{options} {
+	if (!IsValidInsertionType(options_.insertion))
+	{ throw Error{"Not a valid insertion type!"}; }
+}
+
 Path FastTSPSolver::Solve(const Graph& graph) const {
 	// catch the case with 0 vertices
 	if (graph.GetNumVertices() == 0) { return Path{}; }
 
-	// this is very similar to finding an MST
-	FastTable t{graph.GetNumVertices()};
-	unordered_set<int> remaining;
-	Path salespath;
-
-	// set the starting vertex's data
-	int start = 0;
-	t.distances[start] = 0;
-	salespath.vertices.push_back(start);
-
-	// set all the distances 
-	for (int i = 1; i < graph.GetNumVertices(); ++i)
-	{
-		t.distances[i] = graph(start, i)();
-		remaining.insert(i);
-	}
+	Path path{BuildInsertionTour(graph, options_.insertion, 0)};
+	if (options_.neighbors > 0)
+	{ path = ImproveTour(graph, path, options_.neighbors); }
+	return path;
+}
+
+Path BuildInsertionTour(const Graph& graph, const string& insertion,
+		int first) {
+	const int num_vertices{graph.GetNumVertices()};
+	return WithDistance(graph, [&](const auto& distance) {
+		if (insertion == cheapest_insertion_c)
+		{ return InsertCheapest(num_vertices, first, distance); }
+		if (insertion == farthest_insertion_c) {
+			return InsertByDistance(num_vertices, first, distance,
+					greater<int>{});
+		}
+		return InsertByDistance(num_vertices, first, distance, less<int>{});
+	});
+}
+
+// Insert the vertex nearest to the tour next, or farthest from it if
+// comes_first is greater.
+template <typename Distance, typename Compare>
+Path InsertByDistance(int num_vertices, int first, const Distance& distance,
+		Compare comes_first) {
+	InsertionTour<Distance> tour{num_vertices, first, distance};
 
-	// fi%s//d the second vertex, the closest one to the beginning
-	if (!remaining.empty())
-	{
-		// find the min distance to a vertex
-		int minIndex = *min_element(remaining.cbegin(),
-			remaining.cend(), t);
-		salespath.vertices.push_back(minIndex);
-		remaining.erase(minIndex);
+	// the vertices not in the tour, with each one's point and distance to the
+	// tour at the same index, removed by moving the last one into their place
+	vector<int> remaining;
+	vector<typename Distance::Point> points;
+	for (int vertex{0}; vertex < num_vertices; ++vertex) {
+		if (vertex == first) { continue; }
+		remaining.push_back(vertex);
+		points.push_back(distance.GetPoint(vertex));
 	}
+	vector<int> distances(remaining.size(), infinity);
 
-	// while there are still unvisited vertices
-	while (!remaining.empty())
-	{
-		// find the min distance to a vertex
-		int minIndex = *min_element(remaining.cbegin(),
-			remaining.cend(), t);
-		remaining.erase(minIndex);
-
-		// find the cost of inserting between the first and second vertices
-		// use that as a baseline
-		int index1 = 0;
-		int index2 = 1;
-		int oldDistance = graph(salespath.vertices[index1],
-			salespath.vertices[index2])();
-		int newDistance = graph(salespath.vertices[index1],
-			minIndex)() + graph(salespath.vertices[index2], minIndex)();
-		int minCost = newDistance - oldDistance;
-
-		// find the two vertices that has the smallest cost of insertion
-		for (int i = 1; i < int(salespath.vertices.size()) - 1; ++i)
-		{
-			int oldDist = graph(salespath.vertices[i],
-				salespath.vertices[i + 1])();
-			int newDist = graph(salespath.vertices[i],
-				minIndex)() + graph(salespath.vertices[i + 1],
-				minIndex)();
-			int cost = newDist - oldDist;
-			if (cost < minCost)
-			{
-				minCost = cost;
-				index1 = i;
-				index2 = i + 1;
-			}
+	int inserted{first};
+	while (!remaining.empty()) {
+		// bring the distances up to date with the vertex inserted last, and
+		// pick the next vertex in the same pass
+		const typename Distance::Point inserted_point{
+			distance.GetPoint(inserted)};
+		int chosen{0};
+		for (int i{0}; i < int(remaining.size()); ++i) {
+			distances[i] = min(distances[i],
+					distance(inserted_point, points[i]));
+			if (comes_first(distances[i], distances[chosen])) { chosen = i; }
 		}
+		inserted = remaining[chosen];
+		remaining[chosen] = remaining.back();
+		remaining.pop_back();
+		points[chosen] = points.back();
+		points.pop_back();
+		distances[chosen] = distances.back();
+		distances.pop_back();
 
-		// insert the vertex in the path
-		auto pos = salespath.vertices.begin() + index2;
-		salespath.vertices.insert(pos, minIndex);
-
-		// update the distances of all entries
-		for (int index : remaining)
-		{
-			int newDistance = graph(minIndex, index)();
-			if (newDistance < t.distances[index])
-			{
-				t.distances[index] = newDistance;
-			}
-		}
+		int cost;
+		tour.InsertAfter(tour.CheapestPosition(inserted, cost), inserted);
 	}
+	return tour.GetPath();
+}
+
+// Insert the vertex that makes the tour the least longer next. Each vertex
+// remembers its cheapest position. When the edge there is broken up, the old
+// cost is still a lower bound on inserting the vertex anywhere else, so the
+// vertex is only searched for a new position once that bound makes it the next
+// to be inserted. This takes about O(N^2) time.
+template <typename Distance>
+Path InsertCheapest(int num_vertices, int first, const Distance& distance) {
+	using Point = typename Distance::Point;
+	InsertionTour<Distance> tour{num_vertices, first, distance};
 
-	// calculate and set the length of the path
-	for (int i = 0; i < int(salespath.vertices.size()); ++i)
-	{
-		salespath.length += graph(salespath.vertices[i],
-			salespath.vertices[(i + 1) % salespath.vertices.size()])();
+	// the vertices not in the tour, with each one's point, the vertex it is
+	// cheapest to put after, how much that costs, and whether the edge there
+	// is gone and the cost only a lower bound, at the same index
+	vector<int> remaining;
+	vector<Point> points;
+	vector<int> positions;
+	vector<int> costs;
+	vector<char> stale;
+	int chosen{0};
+	for (int vertex{0}; vertex < num_vertices; ++vertex) {
+		if (vertex == first) { continue; }
+		remaining.push_back(vertex);
+		points.push_back(distance.GetPoint(vertex));
+		positions.push_back(first);
+		costs.push_back(tour.InsertionCost(first, vertex));
+		stale.push_back(false);
+		if (costs.back() < costs[chosen]) { chosen = int(costs.size()) - 1; }
 	}
 
-	return salespath;
+	while (!remaining.empty()) {
+		// the cheapest vertex might have a cheaper position
+		while (stale[chosen]) {
+			positions[chosen] =
+				tour.CheapestPosition(remaining[chosen], costs[chosen]);
+			stale[chosen] = false;
+			for (int i{0}; i < int(remaining.size()); ++i)
+			{ if (costs[i] < costs[chosen]) { chosen = i; } }
+		}
+		const int inserted{remaining[chosen]};
+		const int after{positions[chosen]};
+		remaining[chosen] = remaining.back();
+		remaining.pop_back();
+		points[chosen] = points.back();
+		points.pop_back();
+		positions[chosen] = positions.back();
+		positions.pop_back();
+		costs[chosen] = costs.back();
+		costs.pop_back();
+		stale[chosen] = stale.back();
+		stale.pop_back();
+
+		tour.InsertAfter(after, inserted);
+		const int before{tour.GetNext(inserted)};
+		const Point after_point{distance.GetPoint(after)};
+		const Point inserted_point{distance.GetPoint(inserted)};
+		const Point before_point{distance.GetPoint(before)};
+		const int after_length{distance(after_point, inserted_point)};
+		const int before_length{distance(inserted_point, before_point)};
+
+		// the edge after the position is gone, and there are two new ones,
+		// which are the cheapest for a stale vertex if they reach its bound,
+		// and the next vertex to insert is picked in the same pass
+		chosen = 0;
+		for (int i{0}; i < int(remaining.size()); ++i) {
+			if (positions[i] == after) { stale[i] = true; }
+			const int to_inserted{distance(points[i], inserted_point)};
+			const int after_cost{
+				distance(after_point, points[i]) + to_inserted - after_length};
+			if (after_cost < costs[i] || (stale[i] && after_cost == costs[i])) {
+				costs[i] = after_cost;
+				positions[i] = after;
+				stale[i] = false;
+			}
+			const int before_cost{to_inserted +
+				distance(points[i], before_point) - before_length};
+			if (before_cost < costs[i] ||
+					(stale[i] && before_cost == costs[i])) {
+				costs[i] = before_cost;
+				positions[i] = inserted;
+				stale[i] = false;
+			}
+			if (costs[i] < costs[chosen]) { chosen = i; }
+		}
+	}
+	return tour.GetPath();
 }
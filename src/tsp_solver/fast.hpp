@@ -1,14 +1,37 @@
 #ifndef TSP_SOLVER_FAST_H
 #define TSP_SOLVER_FAST_H
 
+#include <string>
+
+#include "tsp_solver/options.hpp"
 #include "tsp_solver/tsp_solver.hpp"
 
-/* Solves the TSP using a heuristic that may not be optimal */
+// whether the type names an insertion heuristic: "nearest", "farthest" or
+// "cheapest"
+bool IsValidInsertionType(const std::string& type);
+
+// The tour the insertion heuristic of the given type builds starting from the
+// first vertex instead of vertex 0, as a path from vertex 0. The graph must
+// have at least one vertex.
+Path BuildInsertionTour(const Graph& graph, const std::string& insertion,
+		int first);
+
+/* Solves the TSP using a heuristic that may not be optimal. Starting from
+ * vertex 0, the tour grows one vertex at a time, each put where it lengthens
+ * the tour the least. Which vertex goes next depends on options.insertion:
+ * the one nearest to the tour, the one farthest from it, or the one that
+ * lengthens it the least. All take O(N^2) time and O(N) memory. The tour is
+ * then improved with ImproveTour, unless options.neighbors is 0.
+ */
 class FastTSPSolver : public TSPSolver {
 public:
-	FastTSPSolver() : TSPSolver{false} {}
+	FastTSPSolver() : FastTSPSolver{SolverOptions{}} {}
+	explicit FastTSPSolver(const SolverOptions& options);
 
 	Path Solve(const Graph&) const override;
+
+private:
+	SolverOptions options_;
 };
 
 #endif  // TSP_SOLVER_FAST_H
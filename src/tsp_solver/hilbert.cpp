@@ -0,0 +1,143 @@
+#include "tsp_solver/hilbert.hpp"
+
+#include <cstdint>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "graph/graph.hpp"
+#include "path.hpp"
+#include "tsp_solver/local_search.hpp"
+#include "util.hpp"
+
+using std::fill;
+using std::find;
+using std::max;
+using std::min;
+using std::rotate;
+using std::swap;
+using std::thread;
+using std::uint32_t;
+using std::uint64_t;
+using std::vector;
+
+// the curve passes through a grid of 2^order by 2^order cells
+const int order_c{16};
+// the radix sort takes this many bits of the keys at a time
+const int radix_bits_c{8};
+const int num_buckets_c{1 << radix_bits_c};
+
+static uint32_t HilbertIndex(uint32_t x, uint32_t y);
+static void RadixSort(vector<uint64_t>& keys, int num_threads);
+
+Path HilbertTSPSolver::Solve(const Graph& graph) const {
+	const vector<Coordinate>* points{graph.GetCoordinates()};
+	if (!points)
+	{ throw Error{"The hilbert solver needs a graph with coordinates!"}; }
+	const int num_vertices{graph.GetNumVertices()};
+	if (num_vertices == 0) { return Path{}; }
+
+	// scale the points into the grid, the same way on both axes
+	int min_x{(*points)[0].x};
+	int max_x{min_x};
+	int min_y{(*points)[0].y};
+	int max_y{min_y};
+	for (int vertex{1}; vertex < num_vertices; ++vertex) {
+		min_x = min(min_x, (*points)[vertex].x);
+		max_x = max(max_x, (*points)[vertex].x);
+		min_y = min(min_y, (*points)[vertex].y);
+		max_y = max(max_y, (*points)[vertex].y);
+	}
+	const uint64_t span{uint64_t(max(1LL,
+				max(1LL * max_x - min_x, 1LL * max_y - min_y)))};
+	const uint64_t cells{(uint64_t{1} << order_c) - 1};
+
+	// each key holds a vertex's index on the curve above the vertex itself
+	vector<uint64_t> keys(num_vertices);
+	for (int vertex{0}; vertex < num_vertices; ++vertex) {
+		const Coordinate& point{(*points)[vertex]};
+		const uint32_t x{uint32_t((point.x - min_x) * cells / span)};
+		const uint32_t y{uint32_t((point.y - min_y) * cells / span)};
+		keys[vertex] = uint64_t{HilbertIndex(x, y)} << 32 | uint32_t(vertex);
+	}
+	RadixSort(keys, max(1, options_.threads));
+
+	Path path;
+	for (uint64_t key : keys) { path.vertices.push_back(int(uint32_t(key))); }
+	// start at vertex 0, as the other solvers do
+	rotate(path.vertices.begin(),
+			find(path.vertices.begin(), path.vertices.end(), 0),
+			path.vertices.end());
+	path.length = CalculatePathLength(graph, path.vertices);
+	if (options_.improve_hilbert && options_.neighbors > 0)
+	{ path = ImproveTour(graph, path, options_.neighbors); }
+	return path;
+}
+
+// the index along the curve of the cell (x, y), after the usual algorithm,
+// which rotates the quadrant each bit picks so the curve runs the same way
+// through it
+uint32_t HilbertIndex(uint32_t x, uint32_t y) {
+	const uint32_t size{uint32_t{1} << order_c};
+	uint32_t index{0};
+	for (uint32_t half{size / 2}; half > 0; half /= 2) {
+		const uint32_t right{(x & half) ? 1u : 0u};
+		const uint32_t up{(y & half) ? 1u : 0u};
+		index += half * half * ((3 * right) ^ up);
+		if (!up) {
+			if (right) {
+				x = size - 1 - x;
+				y = size - 1 - y;
+			}
+			swap(x, y);
+		}
+	}
+	return index;
+}
+
+// Sorts the keys by their upper 32 bits, keeping keys with the same upper bits
+// in order, with a least significant digit radix sort. Each thread counts the
+// digits of its share of the keys, the counts give every thread the place to
+// put its keys with each digit, and each thread moves its share there.
+void RadixSort(vector<uint64_t>& keys, int num_threads) {
+	const int size{int(keys.size())};
+	num_threads = max(1, min(num_threads, size / num_buckets_c));
+	vector<uint64_t> sorted(size);
+	vector<vector<int>> counts(num_threads, vector<int>(num_buckets_c));
+	const auto share_begin = [size, num_threads](int share)
+	{ return int(1LL * size * share / num_threads); };
+	const auto in_parallel = [num_threads](auto work) {
+		vector<thread> threads;
+		for (int share{1}; share < num_threads; ++share)
+		{ threads.emplace_back(work, share); }
+		work(0);
+		for (thread& worker : threads) { worker.join(); }
+	};
+
+	for (int shift{32}; shift < 64; shift += radix_bits_c) {
+		const auto digit = [shift](uint64_t key)
+		{ return int((key >> shift) & (num_buckets_c - 1)); };
+		in_parallel([&](int share) {
+			vector<int>& count{counts[share]};
+			fill(count.begin(), count.end(), 0);
+			for (int i{share_begin(share)}; i < share_begin(share + 1); ++i)
+			{ ++count[digit(keys[i])]; }
+		});
+		// the keys with each digit go in thread order, so the sort is stable
+		int place{0};
+		for (int bucket{0}; bucket < num_buckets_c; ++bucket) {
+			for (int share{0}; share < num_threads; ++share) {
+				const int count{counts[share][bucket]};
+				counts[share][bucket] = place;
+				place += count;
+			}
+		}
+		in_parallel([&](int share) {
+			vector<int>& places{counts[share]};
+			for (int i{share_begin(share)}; i < share_begin(share + 1); ++i)
+			{ sorted[places[digit(keys[i])]++] = keys[i]; }
+		});
+		keys.swap(sorted);
+	}
+}
@@ -0,0 +1,31 @@
+#include "tsp_solver/hilbert.hpp"
+
+#include <memory>
+
+#include "graph/graph.hpp"
+#include "path.hpp"
+#include "test_util.hpp"
+#include "tsp_solver/options.hpp"
+
+#include "gtest/gtest.h"
+
+using std::unique_ptr;
+
+TEST(HilbertTest, VisitsEveryVertex) {
+	unique_ptr<Graph> graph{MakeRandomGraph(2000, 100000, 6)};
+	SolverOptions options;
+	const Path tour{HilbertTSPSolver{options}.Solve(*graph)};
+	EXPECT_TRUE(IsValidTour(*graph, tour));
+	EXPECT_EQ(0, tour.vertices.front());
+}
+
+TEST(HilbertTest, LocalSearchOnlyShortens) {
+	unique_ptr<Graph> graph{MakeRandomGraph(5000, 100000, 7)};
+	SolverOptions options;
+	const Path tour{HilbertTSPSolver{options}.Solve(*graph)};
+	options.improve_hilbert = true;
+	options.neighbors = 8;
+	const Path improved{HilbertTSPSolver{options}.Solve(*graph)};
+	EXPECT_TRUE(IsValidTour(*graph, improved));
+	EXPECT_LE(improved.length, tour.length);
+}
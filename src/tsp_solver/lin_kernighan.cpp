@@ -0,0 +1,367 @@
+#include "tsp_solver/lin_kernighan.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <random>
+#include <vector>
+
+#include "graph/distance.hpp"
+#include "graph/graph.hpp"
+#include "graph/neighbors.hpp"
+#include "graph/spanning_tree.hpp"
+#include "path.hpp"
+#include "statistics.hpp"
+#include "tsp_solver/array_tour.hpp"
+#include "tsp_solver/cancellation.hpp"
+#include "tsp_solver/fast.hpp"
+#include "tsp_solver/local_search.hpp"
+#include "tsp_solver/neighbor_moves.hpp"
+#include "tsp_solver/progress.hpp"
+#include "tsp_solver/two_level_tour.hpp"
+#include "util.hpp"
+
+using std::chrono::duration;
+using std::chrono::duration_cast;
+using std::chrono::steady_clock;
+using std::deque;
+using std::min;
+using std::mt19937;
+using std::sort;
+using std::uniform_int_distribution;
+using std::vector;
+
+// a chain stops after this many 2-opt moves
+const int max_depth_c{50};
+// the first move of a chain tries this many of the best edges to add, the
+// rest only the best
+const int breadth_c{5};
+// kicks move stretches of at most this many vertices
+const int max_kick_length_c{50};
+
+// A tour that remembers the 2-opt moves made on it, so they can be undone.
+template <typename Tour>
+class UndoableTour {
+public:
+	explicit UndoableTour(Tour& tour) : tour_(tour) {}
+
+	int Next(int vertex) const { return tour_.Next(vertex); }
+	int Prev(int vertex) const { return tour_.Prev(vertex); }
+	int size() const { return tour_.size(); }
+
+	void TwoOptMove(int a, int b, int c, int d) {
+		tour_.TwoOptMove(a, b, c, d);
+		moves_.push_back(Move{a, b, c, d});
+	}
+
+	int GetNumMoves() const { return int(moves_.size()); }
+	// calls the function with the ends of the edges each move since the given
+	// one changed
+	template <typename Function>
+	void ForEachChanged(int first_move, Function function) const {
+		for (int i{first_move}; i < int(moves_.size()); ++i) {
+			for (int vertex : {moves_[i].a, moves_[i].b, moves_[i].c,
+					moves_[i].d}) { function(vertex); }
+		}
+	}
+
+	// a 2-opt move is undone by the one that removes the edges it added
+	void UndoTo(int num_moves) {
+		while (int(moves_.size()) > num_moves) {
+			const Move& move{moves_.back()};
+			tour_.TwoOptMove(move.a, move.c, move.b, move.d);
+			moves_.pop_back();
+		}
+	}
+
+	// keep the moves made so far, which can't be undone after this
+	void Forget() { moves_.clear(); }
+
+private:
+	struct Move { int a, b, c, d; };
+
+	Tour& tour_;
+	vector<Move> moves_;
+};
+
+// Lin-Kernighan chains and Or-opt moves on a tour, which remember the 2-opt
+// moves they are made of, so that a kick and the moves that repaired it can be
+// undone.
+template <typename Distance, typename Tour>
+class LinKernighanSearch {
+public:
+	LinKernighanSearch(const Distance& distance,
+			const vector<vector<int>>& neighbors, Tour& tour, int length) :
+			distance_(distance), neighbors_(neighbors), tour_{tour},
+			or_opt_{distance, neighbors, tour_}, length_{length},
+			committed_length_{length}, queued_(tour.size(), false),
+			marks_(tour.size(), 0), mark_{0} {}
+
+	int GetLength() const { return length_; }
+
+	void QueueAll() {
+		for (int vertex{0}; vertex < tour_.size(); ++vertex) { Queue(vertex); }
+	}
+
+	// make chains from the queued vertices until none shortens the tour,
+	// queueing the ends of every edge a chain changes, like the don't-look
+	// bits of ImproveTour
+	void Optimize() {
+		while (!queue_.empty()) {
+			const int vertex{queue_.front()};
+			queue_.pop_front();
+			queued_[vertex] = false;
+			if (ImproveFrom(vertex)) { continue; }
+			// segments moved elsewhere whole are out of reach of the chains
+			length_ -= or_opt_.TryOrOpt(vertex,
+					[this](int changed) { Queue(changed); });
+		}
+	}
+
+	// Replace three edges a short way apart with a double bridge, which turns
+	// A B C D into A C B D. It is built here from three non-sequential 2-opt
+	// moves, but the sequential chains ImproveFrom makes can't undo a double
+	// bridge, so it takes the search out of its local optimum.
+	void Kick(mt19937& random) {
+		const int max_length{min(max_kick_length_c, (tour_.size() - 2) / 3)};
+		uniform_int_distribution<int> pick_vertex{0, tour_.size() - 1};
+		uniform_int_distribution<int> pick_length{1, max_length};
+		const int a1{pick_vertex(random)};
+		const int a2{tour_.Next(a1)};
+		const int b1{Advance(a2, pick_length(random) - 1)};
+		const int b2{tour_.Next(b1)};
+		const int c1{Advance(b2, pick_length(random) - 1)};
+		const int c2{tour_.Next(c1)};
+
+		length_ += distance_(a1, b2) + distance_(c1, a2) + distance_(b1, c2) -
+			distance_(a1, a2) - distance_(b1, b2) - distance_(c1, c2);
+		// a1 a2 ... b1 b2 ... c1 c2 becomes a1 c1 ... b2 b1 ... a2 c2
+		tour_.TwoOptMove(a1, a2, c1, c2);
+		// then a1 b2 ... c1 b1 ... a2 c2
+		tour_.TwoOptMove(a1, c1, b2, b1);
+		// then a1 b2 ... c1 a2 ... b1 c2
+		tour_.TwoOptMove(c1, b1, a2, c2);
+		for (int vertex : {a1, a2, b1, b2, c1, c2}) { Queue(vertex); }
+	}
+
+	// keep the moves made so far, so Undo goes back to the tour as it is now
+	void Commit() {
+		tour_.Forget();
+		committed_length_ = length_;
+	}
+
+	void Undo() {
+		tour_.UndoTo(0);
+		length_ = committed_length_;
+	}
+
+private:
+	// start chains from the edges on both sides of t1
+	bool ImproveFrom(int t1) {
+		for (bool forward : {true, false}) {
+			const int t2{forward ? tour_.Next(t1) : tour_.Prev(t1)};
+			const int removed{distance_(t1, t2)};
+			NewMark(t1, t2);
+			first_steps_.clear();
+			ForEachStep(t1, t2, removed, [this](int t3, int t4, int gain)
+					{ first_steps_.push_back(Step{t3, t4, gain}); });
+			sort(first_steps_.begin(), first_steps_.end(),
+					[](const Step& a, const Step& b) { return a.gain > b.gain; });
+			if (int(first_steps_.size()) > breadth_c)
+			{ first_steps_.resize(breadth_c); }
+
+			for (const Step& step : first_steps_) {
+				const int start{tour_.GetNumMoves()};
+				NewMark(t1, t2);
+				const int gain{Chain(t1, t2, step)};
+				if (gain > 0) {
+					length_ -= gain;
+					tour_.ForEachChanged(start,
+							[this](int changed) { Queue(changed); });
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	// A step of a chain removes the edge (t3, t4) and adds (t2, t3), where t2
+	// is the vertex t1 was joined to by the step before, then closes the tour
+	// by joining t1 to t4. gain is how much the edges removed so far outweigh
+	// those added, leaving out the closing edge.
+	struct Step { int t3, t4, gain; };
+
+	// Make the chain starting with the given step, taking the step that gains
+	// the most each time, then undo the steps after the one that left the tour
+	// shortest. Returns how much shorter it is.
+	int Chain(int t1, int t2, Step step) {
+		int best_gain{0};
+		int best_moves{tour_.GetNumMoves()};
+		for (int depth{0}; depth < max_depth_c; ++depth) {
+			tour_.TwoOptMove(t2, t1, step.t3, step.t4);
+			marks_[step.t3] = marks_[step.t4] = mark_;
+			const int closed{step.gain - distance_(step.t4, t1)};
+			if (closed > best_gain) {
+				best_gain = closed;
+				best_moves = tour_.GetNumMoves();
+			}
+
+			t2 = step.t4;
+			const int gain{step.gain};
+			step.t3 = -1;
+			ForEachStep(t1, t2, gain, [&step](int t3, int t4, int next_gain) {
+				if (step.t3 == -1 || next_gain > step.gain)
+				{ step = Step{t3, t4, next_gain}; }
+			});
+			if (step.t3 == -1) { break; }
+		}
+		tour_.UndoTo(best_moves);
+		return best_gain;
+	}
+
+	// Calls the function with each step that adds an edge from t2 to one of its
+	// neighbors and keeps the gain positive. Vertices a step of the chain
+	// touched are left alone, so no edge the chain added is removed again.
+	template <typename Function>
+	void ForEachStep(int t1, int t2, int gain, Function function) {
+		const bool forward{tour_.Next(t1) == t2};
+		for (int t3 : neighbors_[t2]) {
+			const int added{gain - distance_(t2, t3)};
+			if (added <= 0) { break; }
+			if (marks_[t3] == mark_) { continue; }
+			const int t4{forward ? tour_.Prev(t3) : tour_.Next(t3)};
+			if (marks_[t4] == mark_) { continue; }
+			function(t3, t4, added + distance_(t3, t4));
+		}
+	}
+
+	void NewMark(int t1, int t2) {
+		++mark_;
+		marks_[t1] = marks_[t2] = mark_;
+	}
+
+	int Advance(int vertex, int steps) const {
+		for (; steps > 0; --steps) { vertex = tour_.Next(vertex); }
+		return vertex;
+	}
+
+	void Queue(int vertex) {
+		if (queued_[vertex]) { return; }
+		queued_[vertex] = true;
+		queue_.push_back(vertex);
+	}
+
+	const Distance& distance_;
+	const vector<vector<int>>& neighbors_;
+	// remembers the moves made since the last Commit
+	UndoableTour<Tour> tour_;
+	NeighborMoves<Distance, UndoableTour<Tour>> or_opt_;
+	int length_;
+	int committed_length_;
+	deque<int> queue_;
+	vector<char> queued_;
+	// the vertices the current chain touched have the current mark
+	vector<int> marks_;
+	int mark_;
+	vector<Step> first_steps_;
+};
+
+template <typename Tour, typename Distance>
+static Path IterateLinKernighan(const Graph& graph, const Distance& distance,
+		const vector<vector<int>>& neighbors, const Path& start,
+		const SolverOptions& options, Statistics& statistics);
+
+LinKernighanTSPSolver::LinKernighanTSPSolver(const SolverOptions& options) :
+		TSPSolver{false}, options_{options} {
+	if (!IsValidInsertionType(options_.insertion))
+	{ throw Error{"Not a valid insertion type!"}; }
+	if (options_.neighbors <= 0)
+	{ throw Error{"The lk solver needs at least one neighbor!"}; }
+}
+
+Path LinKernighanTSPSolver::Solve(const Graph& graph) const {
+	statistics_.Clear();
+	// catch the case with 0 vertices
+	if (graph.GetNumVertices() == 0) { return Path{}; }
+
+	// the neighbor lists are only found once, for ImproveTour and the chains
+	SolverOptions insertion_options{options_};
+	insertion_options.neighbors = 0;
+	const vector<vector<int>> neighbors{
+		NearestNeighbors(graph, options_.neighbors)};
+	const Path start{ImproveTour(graph,
+			FastTSPSolver{insertion_options}.Solve(graph), neighbors)};
+	if (start.vertices.size() < 4) { return start; }
+	statistics_.Set("lower_bound", SpanningTreeLowerBound(graph));
+
+	return WithDistance(graph, [&](const auto& distance) {
+		if (graph.GetNumVertices() >= two_level_tour_size_c) {
+			return IterateLinKernighan<TwoLevelTour>(graph, distance, neighbors,
+					start, options_, statistics_);
+		}
+		return IterateLinKernighan<ArrayTour>(graph, distance, neighbors,
+				start, options_, statistics_);
+	});
+}
+
+template <typename Tour, typename Distance>
+Path IterateLinKernighan(const Graph& graph, const Distance& distance,
+		const vector<vector<int>>& neighbors, const Path& start,
+		const SolverOptions& options, Statistics& statistics) {
+	Tour tour{start.vertices};
+	LinKernighanSearch<Distance, Tour> search{distance, neighbors, tour,
+		start.length};
+	search.QueueAll();
+	search.Optimize();
+	search.Commit();
+
+	const auto current = [&] {
+		Path path;
+		path.vertices = tour.GetVertices(start.vertices.front());
+		path.length = search.GetLength();
+		return path;
+	};
+	// the tour is only passed on about every progress_interval seconds, since
+	// building it takes O(N) time
+	const auto interval = duration_cast<steady_clock::duration>(
+			duration<double>{options.progress_interval});
+	steady_clock::time_point next_share{steady_clock::now() + interval};
+	ShareTour(current(), options);
+
+	CancellationToken budget{options.cancellation, options.time_budget};
+	mt19937 random{options.seed};
+	int best{search.GetLength()};
+	long long kicks{0};
+	long long improving_kicks{0};
+	bool shared{true};
+	// a double bridge needs three stretches and the vertices between them
+	while (tour.size() >= 8 && (options.kicks == 0 || kicks < options.kicks) &&
+			!budget.IsCancelled()) {
+		++kicks;
+		search.Kick(random);
+		search.Optimize();
+		// tours as long as the best are kept too, so the search can drift
+		if (search.GetLength() > best) {
+			search.Undo();
+			continue;
+		}
+		if (search.GetLength() < best) {
+			++improving_kicks;
+			best = search.GetLength();
+			shared = false;
+		}
+		search.Commit();
+		if (!shared && steady_clock::now() >= next_share) {
+			ShareTour(current(), options);
+			shared = true;
+			next_share = steady_clock::now() + interval;
+		}
+	}
+	statistics.Set("kicks", kicks);
+	statistics.Set("improving_kicks", improving_kicks);
+
+	Path path{current()};
+	path.length = CalculatePathLength(graph, path.vertices);
+	return path;
+}
@@ -0,0 +1,31 @@
+#ifndef TSP_SOLVER_LIN_KERNIGHAN_H
+#define TSP_SOLVER_LIN_KERNIGHAN_H
+
+#include "tsp_solver/options.hpp"
+#include "tsp_solver/tsp_solver.hpp"
+
+/* Solves the TSP with iterated Lin-Kernighan, a heuristic that finds much
+ * shorter tours than the fast solver on large graphs but may not be optimal.
+ * The fast solver's insertion tour is improved with ImproveTour, then with
+ * Lin-Kernighan moves: chains of 2-opt moves, each starting where the last
+ * left off, kept up to the point the tour was shortest. Only edges to each
+ * vertex's options.neighbors nearest neighbors are added. Then, until
+ * options.time_budget seconds have passed or options.kicks kicks are done, a
+ * random double bridge kicks a short stretch of the tour out of its local
+ * optimum and Lin-Kernighan repairs it, and the kick is undone unless the tour
+ * got no longer. Large tours are kept in a TwoLevelTour. The length of a
+ * minimum spanning tree is recorded as the "lower_bound" statistic, so the gap
+ * to the optimum can be told.
+ */
+class LinKernighanTSPSolver : public TSPSolver {
+public:
+	LinKernighanTSPSolver() : LinKernighanTSPSolver{SolverOptions{}} {}
+	explicit LinKernighanTSPSolver(const SolverOptions& options);
+
+	Path Solve(const Graph&) const override;
+
+private:
+	SolverOptions options_;
+};
+
+#endif  // TSP_SOLVER_LIN_KERNIGHAN_H
@@ -0,0 +1,56 @@
+#include "tsp_solver/lin_kernighan.hpp"
+
+#include <memory>
+#include <sstream>
+
+#include "graph/factory.hpp"
+#include "graph/graph.hpp"
+#include "path.hpp"
+#include "test_util.hpp"
+#include "tsp_solver/fast.hpp"
+#include "tsp_solver/options.hpp"
+#include "util.hpp"
+
+#include "gtest/gtest.h"
+
+using std::istringstream;
+using std::unique_ptr;
+
+// 16 points on a manhattan grid, the shortest tour has length 534
+const char* const graph_input{
+	"100 16 17 72 97 8 32 15 63 97 57 60 83 48 100 26 12 62 3 49 55 77 97 98 "
+	"0 89 57 34 92 29 75 13 40 3"};
+
+// runs without a time budget, so they make the same tour every time
+static SolverOptions KicksOnly(int kicks) {
+	SolverOptions options;
+	options.time_budget = 0;
+	options.kicks = kicks;
+	return options;
+}
+
+TEST(LinKernighanTest, FindsOptimum) {
+	istringstream input{graph_input};
+	unique_ptr<Graph> graph{CreateGraph("manhattan", input)};
+	const Path tour{LinKernighanTSPSolver{KicksOnly(100)}.Solve(*graph)};
+	EXPECT_EQ(534, tour.length);
+	EXPECT_TRUE(IsValidTour(*graph, tour));
+}
+
+TEST(LinKernighanTest, RandomPoints) {
+	unique_ptr<Graph> graph{MakeRandomGraph(500, 1000, 4)};
+
+	const Path fast{FastTSPSolver{}.Solve(*graph)};
+	const LinKernighanTSPSolver solver{KicksOnly(500)};
+	const Path tour{solver.Solve(*graph)};
+	EXPECT_TRUE(IsValidTour(*graph, tour));
+	EXPECT_LT(tour.length, fast.length);
+	EXPECT_EQ(500, solver.GetStatistics().Get("kicks"));
+	EXPECT_EQ(tour, solver.Solve(*graph));
+}
+
+TEST(LinKernighanTest, NeedsNeighbors) {
+	SolverOptions options;
+	options.neighbors = 0;
+	EXPECT_THROW(LinKernighanTSPSolver{options}, Error);
+}
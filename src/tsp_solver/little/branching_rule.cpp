@@ -0,0 +1,176 @@
+#include "tsp_solver/little/branching_rule.hpp"
+
+#include <cassert>
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "graph/edge.hpp"
+#include "matrix.hpp"
+#include "statistics.hpp"
+#include "tsp_solver/little/tree_node.hpp"
+#include "tsp_solver/options.hpp"
+#include "util.hpp"
+
+using std::max;
+using std::min;
+using std::numeric_limits;
+using std::pair;
+using std::string;
+using std::unique_ptr;
+using std::unordered_set;
+using std::vector;
+
+// how much a branch raises the bounds of its weaker and stronger child
+using score_t = pair<double, double>;
+
+const int infinity{numeric_limits<int>::max()};
+
+const string penalty_rule_type_c{"penalty"};
+const string strong_rule_type_c{"strong"};
+const string reliability_rule_type_c{"reliability"};
+const unordered_set<string> valid_rule_types{
+	penalty_rule_type_c, strong_rule_type_c, reliability_rule_type_c};
+
+static int GetGain(int parent_bound, int child_bound);
+static score_t MakeScore(double include_gain, double exclude_gain);
+
+Edge PenaltyBranchingRule::ChooseEdge(const TreeNode&,
+		const vector<CostMatrixZero>& zeros) {
+	assert(!zeros.empty());
+	return zeros.front().edge;
+}
+
+StrongBranchingRule::StrongBranchingRule(int num_candidates) :
+		num_candidates_{num_candidates}, evaluations_{0} {
+	assert(num_candidates_ > 0);
+}
+
+Edge StrongBranchingRule::ChooseEdge(const TreeNode& node,
+		const vector<CostMatrixZero>& zeros) {
+	assert(!zeros.empty());
+	const int num_candidates{min(num_candidates_, int(zeros.size()))};
+	if (num_candidates == 1) { return zeros.front().edge; }
+
+	// the earlier zero wins ties, so this falls back on the penalty order
+	Edge best_edge{zeros.front().edge};
+	score_t best_score{-1, -1};
+	for (int candidate{0}; candidate < num_candidates; ++candidate) {
+		const Edge& edge{zeros[candidate].edge};
+		++evaluations_;
+		score_t score{MakeScore(
+				GetGain(node.GetLowerBound(),
+					node.CalcChildLowerBound(edge, true)),
+				GetGain(node.GetLowerBound(),
+					node.CalcChildLowerBound(edge, false)))};
+		if (score > best_score) {
+			best_edge = edge;
+			best_score = score;
+		}
+	}
+	return best_edge;
+}
+
+void StrongBranchingRule::RecordStatistics(Statistics& statistics) const
+{ statistics.Set("strong_branching_evaluations", evaluations_); }
+
+ReliabilityBranchingRule::ReliabilityBranchingRule(int num_vertices,
+		int num_candidates, int reliability_threshold) :
+		num_candidates_{num_candidates},
+		reliability_threshold_{reliability_threshold},
+		include_gains_{num_vertices, num_vertices, 0},
+		exclude_gains_{num_vertices, num_vertices, 0},
+		num_observations_{num_vertices, num_vertices, 0}, evaluations_{0} {
+	assert(num_candidates_ > 0);
+}
+
+Edge ReliabilityBranchingRule::ChooseEdge(const TreeNode& node,
+		const vector<CostMatrixZero>& zeros) {
+	assert(!zeros.empty());
+	Edge best_edge{zeros.front().edge};
+	score_t best_score{-1, -1};
+	// the children's bounds of each candidate evaluated
+	struct Evaluation { Edge edge; int include_bound, exclude_bound; };
+	vector<Evaluation> evaluated;
+	for (const CostMatrixZero& zero : zeros) {
+		const Edge& edge{zero.edge};
+		score_t score;
+		if (num_observations_(edge.u, edge.v) >= reliability_threshold_) {
+			const double observations{double(num_observations_(edge.u, edge.v))};
+			score = MakeScore(include_gains_(edge.u, edge.v) / observations,
+					exclude_gains_(edge.u, edge.v) / observations);
+		} else if (int(evaluated.size()) < num_candidates_) {
+			// the pseudocosts can't be trusted yet, so evaluate the children and
+			// learn from them
+			++evaluations_;
+			int include_bound{node.CalcChildLowerBound(edge, true)};
+			int exclude_bound{node.CalcChildLowerBound(edge, false)};
+			evaluated.push_back(Evaluation{edge, include_bound, exclude_bound});
+			score = MakeScore(GetGain(node.GetLowerBound(), include_bound),
+					GetGain(node.GetLowerBound(), exclude_bound));
+		} else { continue; }
+
+		if (score > best_score) {
+			best_edge = edge;
+			best_score = score;
+		}
+	}
+	// the search records the branch on the chosen edge once it is made, so
+	// only the others are recorded here
+	for (const Evaluation& evaluation : evaluated) {
+		if (evaluation.edge == best_edge) { continue; }
+		RecordBranch(evaluation.edge, node.GetLowerBound(),
+				evaluation.include_bound, evaluation.exclude_bound);
+	}
+	return best_edge;
+}
+
+void ReliabilityBranchingRule::RecordBranch(const Edge& edge,
+		int parent_bound, int include_bound, int exclude_bound) {
+	// infinite bounds say nothing about how much an edge usually costs
+	if (parent_bound == infinity || include_bound == infinity ||
+			exclude_bound == infinity) { return; }
+	include_gains_(edge.u, edge.v) += GetGain(parent_bound, include_bound);
+	exclude_gains_(edge.u, edge.v) += GetGain(parent_bound, exclude_bound);
+	++num_observations_(edge.u, edge.v);
+}
+
+void ReliabilityBranchingRule::RecordStatistics(Statistics& statistics) const
+{ statistics.Set("strong_branching_evaluations", evaluations_); }
+
+bool IsValidBranchingRuleType(const string& type)
+{ return valid_rule_types.find(type) != valid_rule_types.end(); }
+
+unique_ptr<BranchingRule> CreateBranchingRule(const string& type,
+		int num_vertices, const SolverOptions& options) {
+	if (type == penalty_rule_type_c)
+	{ return unique_ptr<BranchingRule>{new PenaltyBranchingRule{}}; }
+	if (type == strong_rule_type_c) {
+		return unique_ptr<BranchingRule>{
+			new StrongBranchingRule{options.branching_candidates}};
+	}
+	if (type == reliability_rule_type_c) {
+		return unique_ptr<BranchingRule>{new ReliabilityBranchingRule{
+			num_vertices, options.branching_candidates,
+			options.reliability_threshold}};
+	}
+	throw Error{"Not a valid branching rule type!"};
+}
+
+// The rise from the parent's lower bound to the child's. Bounds never drop
+// from parent to child, and an infinite child bound stays infinite.
+int GetGain(int parent_bound, int child_bound) {
+	if (child_bound == infinity) { return infinity; }
+	return max(0, child_bound - parent_bound);
+}
+
+// Branches are compared by the gain of their weaker child first, since that is
+// the child that has to be searched, and by the stronger one to break ties.
+score_t MakeScore(double include_gain, double exclude_gain)
+{ return score_t{min(include_gain, exclude_gain),
+	max(include_gain, exclude_gain)}; }
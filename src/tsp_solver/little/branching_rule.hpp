@@ -0,0 +1,114 @@
+#ifndef TSP_SOLVER_LITTLE_BRANCHING_RULE_H
+#define TSP_SOLVER_LITTLE_BRANCHING_RULE_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "graph/edge.hpp"
+#include "matrix.hpp"
+
+class Statistics;
+class TreeNode;
+struct SolverOptions;
+
+// A zero in a reduced cost matrix and the amount the lower bound would rise by
+// if it were excluded.
+struct CostMatrixZero {
+	Edge edge;
+	int penalty;
+	bool operator<(const CostMatrixZero& other) const
+	{ return penalty < other.penalty; }
+};
+
+/* Decides which edge a TreeNode branches on. Rules are handed every zero of the
+ * node's reduced cost matrix, and may keep state across the nodes of a search.
+ */
+class BranchingRule {
+public:
+	virtual ~BranchingRule() {}
+
+	// The number of zeros with the highest penalties the rule chooses among,
+	// or -1 for every zero. Only these are found and sorted for ChooseEdge.
+	virtual int GetNumCandidates() const { return -1; }
+
+	// Chooses the edge to branch on for the node. zeros holds at most
+	// GetNumCandidates() zeros, sorted by decreasing penalty (ties in the
+	// order they were found), and none of the penalties is infinite.
+	virtual Edge ChooseEdge(const TreeNode& node,
+			const std::vector<CostMatrixZero>& zeros) = 0;
+
+	// Tells the rule the lower bounds the children of a node got after
+	// branching on edge, infinity for a child that wasn't evaluated.
+	virtual void RecordBranch(const Edge&, int /* parent_bound */,
+			int /* include_bound */, int /* exclude_bound */) {}
+
+	// adds the rule's counters to the solver's statistics
+	virtual void RecordStatistics(Statistics&) const {}
+};
+
+/* Little's original rule: branch on the zero with the highest penalty. */
+class PenaltyBranchingRule : public BranchingRule {
+public:
+	int GetNumCandidates() const override { return 1; }
+	Edge ChooseEdge(const TreeNode& node,
+			const std::vector<CostMatrixZero>& zeros) override;
+};
+
+/* Evaluates both children of the candidates with the highest penalties and
+ * branches on the one whose weaker child has the highest lower bound.
+ */
+class StrongBranchingRule : public BranchingRule {
+public:
+	explicit StrongBranchingRule(int num_candidates);
+
+	int GetNumCandidates() const override { return num_candidates_; }
+	Edge ChooseEdge(const TreeNode& node,
+			const std::vector<CostMatrixZero>& zeros) override;
+	void RecordStatistics(Statistics& statistics) const override;
+
+private:
+	int num_candidates_;
+	long long evaluations_;
+};
+
+/* Keeps pseudocosts, the average rise in lower bound seen when including and
+ * excluding each edge. Candidates whose pseudocosts rest on fewer than
+ * reliability_threshold observations are evaluated as in strong branching, the
+ * rest are scored by their pseudocosts alone. An evaluated candidate that
+ * isn't chosen is observed right away, the chosen one when the search records
+ * its branch.
+ */
+class ReliabilityBranchingRule : public BranchingRule {
+public:
+	ReliabilityBranchingRule(int num_vertices, int num_candidates,
+			int reliability_threshold);
+
+	Edge ChooseEdge(const TreeNode& node,
+			const std::vector<CostMatrixZero>& zeros) override;
+	void RecordBranch(const Edge& edge, int parent_bound, int include_bound,
+			int exclude_bound) override;
+	void RecordStatistics(Statistics& statistics) const override;
+
+	// the number of branches on the edge its pseudocosts rest on
+	int GetNumObservations(const Edge& edge) const
+	{ return num_observations_(edge.u, edge.v); }
+
+private:
+	int num_candidates_;
+	int reliability_threshold_;
+
+	// total rise in lower bound and number of observations for each edge
+	Matrix<long long> include_gains_;
+	Matrix<long long> exclude_gains_;
+	Matrix<int> num_observations_;
+
+	long long evaluations_;
+};
+
+bool IsValidBranchingRuleType(const std::string& type);
+
+std::unique_ptr<BranchingRule> CreateBranchingRule(const std::string& type,
+		int num_vertices, const SolverOptions& options);
+
+#endif  // TSP_SOLVER_LITTLE_BRANCHING_RULE_H
@@ -0,0 +1,224 @@
+#include "tsp_solver/little/checkpoint.hpp"
+
+#include <cstdint>
+#include <cstdio>
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "graph/edge.hpp"
+#include "graph/graph.hpp"
+#include "path.hpp"
+#include "statistics.hpp"
+#include "util.hpp"
+
+using std::cerr;
+using std::endl;
+using std::ifstream;
+using std::int32_t;
+using std::istream;
+using std::lock_guard;
+using std::move;
+using std::mutex;
+using std::ofstream;
+using std::ostream;
+using std::string;
+using std::uint32_t;
+using std::uint64_t;
+using std::unique_lock;
+using std::unique_ptr;
+using std::vector;
+
+const int32_t checkpoint_magic_c{0x4C545350};  // "LTSP"
+const int32_t checkpoint_version_c{2};
+
+static void WriteInt(ostream& os, int32_t value);
+// the high half first, then the low
+static void WriteLong(ostream& os, long long value);
+static void WriteEdges(ostream& os, const vector<Edge>& edges);
+static int32_t ReadInt(istream& is);
+static long long ReadLong(istream& is);
+// reads a count of things that follow, which can't be negative
+static int ReadSize(istream& is);
+// throws Error if an edge is out of range
+static vector<Edge> ReadEdges(istream& is, int num_vertices);
+
+void WriteCheckpoint(ostream& os, const Checkpoint& checkpoint) {
+	WriteInt(os, checkpoint_magic_c);
+	WriteInt(os, checkpoint_version_c);
+	WriteInt(os, checkpoint.num_vertices);
+	WriteLong(os, (long long)(checkpoint.graph_fingerprint));
+
+	WriteInt(os, checkpoint.shortest.length);
+	WriteInt(os, int32_t(checkpoint.shortest.vertices.size()));
+	for (int vertex : checkpoint.shortest.vertices) { WriteInt(os, vertex); }
+	WriteInt(os, checkpoint.lowest_pruned);
+
+	// counters are written as name length, name, and the value split in two
+	const auto& counters = checkpoint.statistics.GetCounters();
+	WriteInt(os, int32_t(counters.size()));
+	for (const auto& counter : counters) {
+		WriteInt(os, int32_t(counter.first.size()));
+		os.write(counter.first.data(), counter.first.size());
+		WriteLong(os, counter.second);
+	}
+
+	WriteInt(os, int32_t(checkpoint.nodes.size()));
+	for (const Checkpoint::Node& node : checkpoint.nodes) {
+		WriteEdges(os, node.include);
+		WriteEdges(os, node.exclude);
+	}
+}
+
+Checkpoint ReadCheckpoint(istream& is) {
+	if (ReadInt(is) != checkpoint_magic_c) { throw Error{"Not a checkpoint!"}; }
+	if (ReadInt(is) != checkpoint_version_c)
+	{ throw Error{"Unsupported checkpoint version!"}; }
+
+	Checkpoint checkpoint;
+	checkpoint.num_vertices = ReadSize(is);
+	checkpoint.graph_fingerprint = uint64_t(ReadLong(is));
+	const int size{checkpoint.num_vertices};
+
+	checkpoint.shortest.length = ReadInt(is);
+	checkpoint.shortest.vertices.resize(ReadSize(is));
+	for (int& vertex : checkpoint.shortest.vertices) { vertex = ReadInt(is); }
+	checkpoint.lowest_pruned = ReadInt(is);
+
+	const int num_counters{ReadSize(is)};
+	for (int counter{0}; counter < num_counters; ++counter) {
+		string name(ReadSize(is), '\0');
+		is.read(&name[0], name.size());
+		checkpoint.statistics.Set(name, ReadLong(is));
+	}
+
+	checkpoint.nodes.resize(ReadSize(is));
+	for (Checkpoint::Node& node : checkpoint.nodes) {
+		node.include = ReadEdges(is, size);
+		node.exclude = ReadEdges(is, size);
+	}
+
+	if (!is) { throw Error{"Checkpoint is truncated!"}; }
+	return checkpoint;
+}
+
+Checkpoint LoadCheckpoint(const string& file_name) {
+	ifstream file{file_name, ifstream::binary};
+	if (!file) { throw Error{"Could not open checkpoint file!"}; }
+	return ReadCheckpoint(file);
+}
+
+// 64-bit FNV-1a over the costs, row by row
+uint64_t GetGraphFingerprint(const Graph& graph) {
+	const int num_vertices{graph.GetNumVertices()};
+	uint64_t hash{14695981039346656037ULL};
+	auto mix = [&hash](uint32_t value) {
+		for (int byte{0}; byte < 4; ++byte) {
+			hash ^= (value >> (8 * byte)) & 0xFF;
+			hash *= 1099511628211ULL;
+		}
+	};
+	mix(uint32_t(num_vertices));
+	for (int from{0}; from < num_vertices; ++from) {
+		for (int to{0}; to < num_vertices; ++to)
+		{ mix(uint32_t(graph.GetDistance(from, to))); }
+	}
+	return hash;
+}
+
+CheckpointWriter::CheckpointWriter(const string& file_name) :
+		file_name_{file_name}, done_{false},
+		writer_{&CheckpointWriter::WriteLoop, this} {}
+
+CheckpointWriter::~CheckpointWriter() {
+	{
+		lock_guard<mutex> lock{mutex_};
+		done_ = true;
+	}
+	submitted_.notify_one();
+	writer_.join();
+}
+
+void CheckpointWriter::Submit(Checkpoint checkpoint) {
+	{
+		lock_guard<mutex> lock{mutex_};
+		pending_.reset(new Checkpoint{move(checkpoint)});
+	}
+	submitted_.notify_one();
+}
+
+void CheckpointWriter::WriteLoop() {
+	while (true) {
+		unique_ptr<Checkpoint> checkpoint;
+		{
+			unique_lock<mutex> lock{mutex_};
+			submitted_.wait(lock, [this] { return pending_ || done_; });
+			if (!pending_) { return; }  // done, and nothing left to write
+			checkpoint = move(pending_);
+		}
+
+		const string temporary_name{file_name_ + ".tmp"};
+		{
+			ofstream file{temporary_name, ofstream::binary | ofstream::trunc};
+			WriteCheckpoint(file, *checkpoint);
+			file.flush();
+			if (!file) {
+				cerr << "Could not write checkpoint " << temporary_name << endl;
+				continue;
+			}
+		}
+		if (std::rename(temporary_name.c_str(), file_name_.c_str()) != 0)
+		{ cerr << "Could not replace checkpoint " << file_name_ << endl; }
+	}
+}
+
+void WriteInt(ostream& os, int32_t value)
+{ os.write(reinterpret_cast<const char*>(&value), sizeof(value)); }
+
+void WriteLong(ostream& os, long long value) {
+	WriteInt(os, int32_t(value >> 32));
+	WriteInt(os, int32_t(value & 0xFFFFFFFF));
+}
+
+void WriteEdges(ostream& os, const vector<Edge>& edges) {
+	WriteInt(os, int32_t(edges.size()));
+	for (const Edge& e : edges) {
+		WriteInt(os, e.u);
+		WriteInt(os, e.v);
+	}
+}
+
+int32_t ReadInt(istream& is) {
+	int32_t value{0};
+	is.read(reinterpret_cast<char*>(&value), sizeof(value));
+	if (!is) { throw Error{"Checkpoint is truncated!"}; }
+	return value;
+}
+
+int ReadSize(istream& is) {
+	int32_t size{ReadInt(is)};
+	if (size < 0) { throw Error{"Checkpoint has a negative size!"}; }
+	return size;
+}
+
+long long ReadLong(istream& is) {
+	const long long high{ReadInt(is)};
+	const long long low{uint32_t(ReadInt(is))};
+	return high * (1LL << 32) + low;
+}
+
+vector<Edge> ReadEdges(istream& is, int num_vertices) {
+	vector<Edge> edges(ReadSize(is));
+	for (Edge& e : edges) {
+		e.u = ReadInt(is);
+		e.v = ReadInt(is);
+		if (e.u < 0 || e.u >= num_vertices || e.v < 0 || e.v >= num_vertices)
+		{ throw Error{"Checkpoint has an edge out of range!"}; }
+	}
+	return edges;
+}
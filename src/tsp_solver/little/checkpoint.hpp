@@ -0,0 +1,83 @@
+#ifndef TSP_SOLVER_LITTLE_CHECKPOINT_H
+#define TSP_SOLVER_LITTLE_CHECKPOINT_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "graph/edge.hpp"
+#include "path.hpp"
+#include "statistics.hpp"
+
+class Graph;
+
+// Everything needed to pick a search for Little's algorithm back up: its open
+// nodes, the shortest tour so far and its counters.
+struct Checkpoint {
+	// an open node is rebuilt from the edges it includes and the edges it
+	// excludes by branching, as the rest of its excluded edges follow
+	struct Node {
+		std::vector<Edge> include;
+		std::vector<Edge> exclude;
+	};
+
+	int num_vertices{0};
+	// a hash of the graph's costs, so a checkpoint isn't resumed on another
+	// graph of the same size
+	std::uint64_t graph_fingerprint{0};
+	// may have a length but no vertices if it is a bound passed to Solve
+	Path shortest;
+	// lowest lower bound pruned because of the gap
+	int lowest_pruned{0};
+	Statistics statistics;
+	std::vector<Node> nodes;
+};
+
+// Checkpoints are binary: a magic number and version, followed by the fields
+// of the checkpoint as 32-bit integers in the host's byte order. Each node is
+// stored as its lists of included and excluded edges.
+void WriteCheckpoint(std::ostream& os, const Checkpoint& checkpoint);
+// throws Error if the stream doesn't hold a checkpoint
+Checkpoint ReadCheckpoint(std::istream& is);
+
+// reads the checkpoint in the named file, throws Error if it can't
+Checkpoint LoadCheckpoint(const std::string& file_name);
+
+// the hash of every edge's cost stored in checkpoints of the graph's searches
+std::uint64_t GetGraphFingerprint(const Graph& graph);
+
+/* Writes checkpoints to a file on a background thread, so the search only pays
+ * for copying its state. If checkpoints come in faster than they can be
+ * written, only the latest is kept. Each write goes to a temporary file that is
+ * renamed over the old checkpoint, so a crash never leaves half a checkpoint.
+ */
+class CheckpointWriter {
+public:
+	explicit CheckpointWriter(const std::string& file_name);
+	// writes the last submitted checkpoint, if it hasn't been already
+	~CheckpointWriter();
+
+	CheckpointWriter(const CheckpointWriter&) = delete;
+	CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+	void Submit(Checkpoint checkpoint);
+
+private:
+	void WriteLoop();
+
+	std::string file_name_;
+
+	std::mutex mutex_;
+	std::condition_variable submitted_;
+	std::unique_ptr<Checkpoint> pending_;
+	bool done_;
+
+	std::thread writer_;
+};
+
+#endif  // TSP_SOLVER_LITTLE_CHECKPOINT_H
@@ -0,0 +1,91 @@
+#include "checkpoint.hpp"
+
+#include <cstdio>
+
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "graph/edge.hpp"
+#include "graph/factory.hpp"
+#include "graph/graph.hpp"
+#include "path.hpp"
+#include "tsp_solver/little/solver.hpp"
+#include "tsp_solver/options.hpp"
+#include "util.hpp"
+
+#include "gtest/gtest.h"
+
+using std::numeric_limits;
+using std::unique_ptr;
+using std::string;
+using std::stringstream;
+using std::vector;
+
+const int infinity{numeric_limits<int>::max()};
+
+TEST(CheckpointTest, RoundTrip) {
+	Checkpoint saved;
+	saved.num_vertices = 4;
+	saved.graph_fingerprint = 0xFEDCBA9876543210ULL;
+	saved.shortest.vertices = {0, 2, 1, 3};
+	saved.shortest.length = 17;
+	saved.lowest_pruned = infinity;
+	saved.statistics.Set("nodes_expanded", 5000000000LL);
+	saved.statistics.Set("dives", 3);
+
+	Checkpoint::Node node{{Edge{0, 2}, Edge{2, 1}}, {Edge{1, 0}, Edge{3, 2}}};
+	saved.nodes.push_back(node);
+	saved.nodes.push_back(Checkpoint::Node{{}, {Edge{0, 3}}});
+
+	stringstream stream;
+	WriteCheckpoint(stream, saved);
+	Checkpoint loaded{ReadCheckpoint(stream)};
+
+	EXPECT_EQ(4, loaded.num_vertices);
+	EXPECT_EQ(saved.graph_fingerprint, loaded.graph_fingerprint);
+	EXPECT_EQ(saved.shortest.vertices, loaded.shortest.vertices);
+	EXPECT_EQ(17, loaded.shortest.length);
+	EXPECT_EQ(infinity, loaded.lowest_pruned);
+	EXPECT_EQ(saved.statistics.GetCounters(), loaded.statistics.GetCounters());
+
+	ASSERT_EQ(2u, loaded.nodes.size());
+	EXPECT_EQ(node.include, loaded.nodes[0].include);
+	EXPECT_EQ(node.exclude, loaded.nodes[0].exclude);
+	EXPECT_TRUE(loaded.nodes[1].include.empty());
+	EXPECT_EQ(saved.nodes[1].exclude, loaded.nodes[1].exclude);
+}
+
+TEST(CheckpointTest, BadInput) {
+	stringstream not_checkpoint{"this is not a checkpoint"};
+	EXPECT_THROW(ReadCheckpoint(not_checkpoint), Error);
+
+	Checkpoint saved;
+	saved.num_vertices = 3;
+	saved.nodes.push_back(Checkpoint::Node{{Edge{0, 1}}, {Edge{1, 2}}});
+	stringstream stream;
+	WriteCheckpoint(stream, saved);
+	string truncated{stream.str()};
+	truncated.pop_back();
+	stringstream truncated_stream{truncated};
+	EXPECT_THROW(ReadCheckpoint(truncated_stream), Error);
+}
+
+TEST(CheckpointTest, ResumeChecksTheGraph) {
+	const string file_name{"checkpoint_test.checkpoint"};
+	stringstream square{"100 4 0 0 0 5 5 5 5 0"};
+	unique_ptr<Graph> graph{CreateGraph("manhattan", square)};
+	stringstream rectangle{"100 4 0 0 0 5 9 5 9 0"};
+	unique_ptr<Graph> other{CreateGraph("manhattan", rectangle)};
+	EXPECT_NE(GetGraphFingerprint(*graph), GetGraphFingerprint(*other));
+
+	SolverOptions options;
+	options.checkpoint_file = file_name;
+	const Path tour{LittleTSPSolver{options}.Solve(*graph)};
+	options.resume = true;
+	EXPECT_EQ(tour.length, LittleTSPSolver{options}.Solve(*graph).length);
+	EXPECT_THROW(LittleTSPSolver{options}.Solve(*other), Error);
+	std::remove(file_name.c_str());
+}
@@ -0,0 +1,61 @@
+#include "tsp_solver/little/edge_elimination.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "graph/edge.hpp"
+#include "graph/edge_cost.hpp"
+#include "graph/graph.hpp"
+#include "matrix.hpp"
+#include "profile.hpp"
+#include "tsp_solver/little/cost_matrix.hpp"
+
+using std::min;
+using std::numeric_limits;
+using std::vector;
+
+const int infinity{numeric_limits<int>::max()};
+
+EdgeEliminator::EdgeEliminator(const Graph& graph) :
+		reduced_costs_{graph.GetNumVertices()},
+		eliminated_{graph.GetNumVertices(), graph.GetNumVertices(), 0},
+		num_eliminated_{0}, lowest_bound_{infinity} {
+	PROFILE_SCOPE(kRootReduction);
+	// the root excludes only self-loops
+	const int size{graph.GetNumVertices()};
+	Matrix<int> root_exclude{size, size, 0};
+	for (int diag{0}; diag < size; ++diag) { root_exclude(diag, diag) = 1; }
+
+	CostMatrix root_matrix{graph, vector<Edge>{}, root_exclude};
+	root_lower_bound_ = root_matrix.ReduceMatrix();
+	for (int row{0}; row < size; ++row) {
+		for (int column{0}; column < size; ++column)
+		{ reduced_costs_(row, column) = root_matrix(row, column)(); }
+	}
+}
+
+int EdgeEliminator::Eliminate(int upper_bound) {
+	if (upper_bound == infinity || root_lower_bound_ == infinity) { return 0; }
+
+	// a tour through an edge costs at least the root lower bound plus the
+	// edge's reduced cost
+	int newly_eliminated{0};
+	const int size{eliminated_.GetNumRows()};
+	for (int row{0}; row < size; ++row) {
+		for (int column{0}; column < size; ++column) {
+			if (row == column || eliminated_(row, column)) { continue; }
+			int reduced_cost{reduced_costs_(row, column)};
+			if (reduced_cost >= upper_bound - root_lower_bound_) {
+				eliminated_(row, column) = 1;
+				++newly_eliminated;
+				if (reduced_cost != infinity) {
+					lowest_bound_ = min(lowest_bound_,
+							root_lower_bound_ + reduced_cost);
+				}
+			}
+		}
+	}
+	num_eliminated_ += newly_eliminated;
+	return newly_eliminated;
+}
@@ -0,0 +1,38 @@
+#ifndef TSP_SOLVER_LITTLE_EDGE_ELIMINATION_H
+#define TSP_SOLVER_LITTLE_EDGE_ELIMINATION_H
+
+#include "graph/edge.hpp"
+#include "matrix.hpp"
+
+class Graph;
+
+// Finds edges that can't be part of any tour shorter than an upper bound. Any
+// tour costs the root's lower bound plus the reduced costs of its edges, and
+// reduced costs are never negative, so an edge whose reduced cost plus the root
+// lower bound reaches the upper bound can be excluded everywhere in the tree.
+class EdgeEliminator {
+public:
+	// reduces the root cost matrix of the graph
+	explicit EdgeEliminator(const Graph& graph);
+
+	// Marks every edge that can't be in a tour shorter than upper_bound.
+	// Returns the number of edges that weren't marked before.
+	int Eliminate(int upper_bound);
+
+	bool IsEliminated(const Edge& e) const { return eliminated_(e.u, e.v); }
+	// eliminated edges are set to 1, in the same layout as a TreeNode's
+	// excluded edges
+	const Matrix<int>& GetEliminated() const { return eliminated_; }
+	int GetNumEliminated() const { return num_eliminated_; }
+	// no tour through an eliminated edge is shorter than this
+	int GetLowestBound() const { return lowest_bound_; }
+
+private:
+	int root_lower_bound_;
+	Matrix<int> reduced_costs_;
+	Matrix<int> eliminated_;
+	int num_eliminated_;
+	int lowest_bound_;
+};
+
+#endif  // TSP_SOLVER_LITTLE_EDGE_ELIMINATION_H
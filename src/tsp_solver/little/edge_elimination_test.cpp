@@ -0,0 +1,79 @@
+#include "tsp_solver/little/edge_elimination.hpp"
+
+#include <limits>
+
+#include "graph/edge.hpp"
+#include "graph/edge_cost.hpp"
+#include "graph/mock.hpp"
+#include "matrix.hpp"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using std::numeric_limits;
+
+using ::testing::Const;
+using ::testing::Return;
+using ::testing::ReturnRef;
+
+const int infinity{numeric_limits<int>::max()};
+
+// cost matrix given in source paper, its root lower bound is 48
+const Matrix<EdgeCost> graph_weights{MakeEdgeCosts({
+	0, 27, 43, 16, 30, 26,
+	7, 0, 16, 1, 30, 25,
+	20, 13, 0, 35, 5, 0,
+	21, 16, 25, 0, 18, 18,
+	12, 46, 27, 48, 0, 5,
+	23, 5, 5, 9, 5, 0}, 6)};
+
+class EdgeEliminatorTest : public ::testing::Test {
+public:
+	EdgeEliminatorTest() {
+		for (int i{0}; i < 6; ++i) {
+			for (int j{0}; j < 6; ++j) {
+				EXPECT_CALL(Const(graph), Predicate(i, j)).WillRepeatedly(
+						ReturnRef(graph_weights(i, j)));
+			}
+		}
+		EXPECT_CALL(graph, GetNumVertices()).WillRepeatedly(Return(6));
+	}
+
+protected:
+	MockGraph graph;
+};
+
+TEST_F(EdgeEliminatorTest, NoUpperBound) {
+	EdgeEliminator eliminator{graph};
+	EXPECT_EQ(0, eliminator.Eliminate(infinity));
+	EXPECT_EQ(0, eliminator.GetNumEliminated());
+	EXPECT_EQ(infinity, eliminator.GetLowestBound());
+}
+
+TEST_F(EdgeEliminatorTest, Eliminate) {
+	EdgeEliminator eliminator{graph};
+
+	// with the optimal tour as upper bound, edges with reduced cost >= 15 go
+	EXPECT_EQ(9, eliminator.Eliminate(63));
+	// one of them has reduced cost exactly 15
+	EXPECT_EQ(63, eliminator.GetLowestBound());
+	EXPECT_TRUE(eliminator.IsEliminated({0, 2}));
+	EXPECT_TRUE(eliminator.IsEliminated({2, 0}));
+	EXPECT_FALSE(eliminator.IsEliminated({0, 4}));
+	EXPECT_FALSE(eliminator.IsEliminated({2, 1}));
+	// self-loops are never counted
+	EXPECT_FALSE(eliminator.IsEliminated({1, 1}));
+
+	// a lower bound only adds to the eliminated edges
+	EXPECT_EQ(5, eliminator.Eliminate(58));
+	EXPECT_EQ(14, eliminator.GetNumEliminated());
+	EXPECT_EQ(58, eliminator.GetLowestBound());
+	EXPECT_TRUE(eliminator.IsEliminated({0, 4}));
+	EXPECT_TRUE(eliminator.IsEliminated({2, 1}));
+	EXPECT_EQ(1, eliminator.GetEliminated()(0, 2));
+	EXPECT_EQ(0, eliminator.GetEliminated()(0, 3));
+
+	// edges of the optimal tour have reduced cost 0
+	EXPECT_FALSE(eliminator.IsEliminated({0, 3}));
+	EXPECT_FALSE(eliminator.IsEliminated({5, 1}));
+}
@@ -0,0 +1,92 @@
+#include "tsp_solver/little/exact_leaf.hpp"
+
+#include <cassert>
+
+#include <limits>
+#include <vector>
+
+#include "graph/edge.hpp"
+#include "graph/edge_cost.hpp"
+#include "matrix.hpp"
+#include "tsp_solver/little/cost_matrix.hpp"
+#include "tsp_solver/little/fragments.hpp"
+
+using std::numeric_limits;
+using std::vector;
+
+const int infinity{numeric_limits<int>::max()};
+
+vector<Edge> SolveResidualTour(const CostMatrix& cost_matrix,
+		const vector<Edge>& include, int budget) {
+	Fragments fragments{cost_matrix.GetActualSize(), include};
+	const vector<int>& heads{fragments.heads};
+	const vector<int>& tails{fragments.tails};
+	const int num_fragments{fragments.Size()};
+	assert(num_fragments == cost_matrix.GetCondensedSize());
+	assert(num_fragments <= max_exact_leaf_size);
+	if (num_fragments < 2 || budget <= 0) { return {}; }
+
+	// reduced cost of linking the tail of one fragment to the head of another,
+	// links that can't be part of a tour cheaper than the budget are dropped
+	Matrix<int> links{num_fragments, num_fragments, infinity};
+	for (int from{0}; from < num_fragments; ++from) {
+		for (int to{0}; to < num_fragments; ++to) {
+			if (from == to) { continue; }
+			int link{cost_matrix(tails[from], heads[to])()};
+			if (link < budget) { links(from, to) = link; }
+		}
+	}
+
+	// Every chain starts at fragment 0, so subsets only cover fragments 1 to
+	// num_fragments - 1, with fragment f stored at bit f - 1.
+	// shortest[subset * rest + f - 1] is the cheapest chain from fragment 0
+	// through exactly the fragments in `subset` that ends at fragment f.
+	const int rest{num_fragments - 1};
+	const int full_subset{(1 << rest) - 1};
+	vector<int> shortest((full_subset + 1) * rest, infinity);
+	vector<int> came_from((full_subset + 1) * rest, 0);
+	for (int f{1}; f < num_fragments; ++f)
+	{ shortest[(1 << (f - 1)) * rest + f - 1] = links(0, f); }
+
+	for (int subset{1}; subset <= full_subset; ++subset) {
+		for (int last{1}; last < num_fragments; ++last) {
+			int length{shortest[subset * rest + last - 1]};
+			if (length == infinity) { continue; }
+			for (int f{1}; f < num_fragments; ++f) {
+				int bit{1 << (f - 1)};
+				if ((subset & bit) || links(last, f) == infinity) { continue; }
+				if (length + links(last, f) >= budget) { continue; }
+				int& extended{shortest[(subset | bit) * rest + f - 1]};
+				if (length + links(last, f) < extended) {
+					extended = length + links(last, f);
+					came_from[(subset | bit) * rest + f - 1] = last;
+				}
+			}
+		}
+	}
+
+	// close the cheapest full chain back to fragment 0
+	int best_length{budget};
+	int best_last{-1};
+	for (int last{1}; last < num_fragments; ++last) {
+		int length{shortest[full_subset * rest + last - 1]};
+		if (length == infinity || links(last, 0) == infinity) { continue; }
+		if (length + links(last, 0) < best_length) {
+			best_length = length + links(last, 0);
+			best_last = last;
+		}
+	}
+	if (best_last == -1) { return {}; }
+
+	// walk the chain backwards to recover the linking edges
+	vector<Edge> completion{Edge{tails[best_last], heads[0]}};
+	int subset{full_subset};
+	int current{best_last};
+	while (current != 0) {
+		int from{came_from[subset * rest + current - 1]};
+		completion.push_back(Edge{tails[from], heads[current]});
+		subset &= ~(1 << (current - 1));
+		current = from;
+	}
+	return completion;
+}
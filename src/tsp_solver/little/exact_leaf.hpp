@@ -0,0 +1,25 @@
+#ifndef TSP_SOLVER_LITTLE_EXACT_LEAF_H
+#define TSP_SOLVER_LITTLE_EXACT_LEAF_H
+
+#include <vector>
+
+#include "graph/edge.hpp"
+
+class CostMatrix;
+
+// The largest residual problem SolveResidualTour will take on. Its table has
+// 2^size * size entries, so this keeps it to a few megabytes.
+const int max_exact_leaf_size{16};
+
+// Finds the cheapest edges that complete the tour whose fixed edges are
+// `include`, using the reduced costs in `cost_matrix` (so excluded edges are
+// never used). The included edges split the vertices into Fragments, and
+// a bitmask dynamic program over those fragments finds the cheapest order in
+// which to chain them together. Partial chains whose reduced cost reaches
+// `budget` are dropped, since they can't beat the best tour found so far.
+// Returns the edges to add, or an empty vector if no completion costs less than
+// `budget`.
+std::vector<Edge> SolveResidualTour(const CostMatrix& cost_matrix,
+		const std::vector<Edge>& include, int budget);
+
+#endif  // TSP_SOLVER_LITTLE_EXACT_LEAF_H
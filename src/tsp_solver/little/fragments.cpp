@@ -0,0 +1,26 @@
+#include "tsp_solver/little/fragments.hpp"
+
+#include <vector>
+
+#include "graph/edge.hpp"
+
+using std::vector;
+
+Fragments::Fragments(int num_vertices, const vector<Edge>& include) :
+		next(num_vertices, -1) {
+	// link up the included edges so the fragments can be walked
+	vector<bool> has_previous(num_vertices, false);
+	for (const Edge& e : include) {
+		next[e.u] = e.v;
+		has_previous[e.v] = true;
+	}
+
+	// every vertex without an included edge leading into it starts a fragment
+	for (int vertex{0}; vertex < num_vertices; ++vertex) {
+		if (has_previous[vertex]) { continue; }
+		int tail{vertex};
+		while (next[tail] != -1) { tail = next[tail]; }
+		heads.push_back(vertex);
+		tails.push_back(tail);
+	}
+}
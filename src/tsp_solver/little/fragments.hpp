@@ -0,0 +1,21 @@
+#ifndef TSP_SOLVER_LITTLE_FRAGMENTS_H
+#define TSP_SOLVER_LITTLE_FRAGMENTS_H
+
+#include <vector>
+
+struct Edge;
+
+// The paths formed by the included edges of a tree node. Every vertex is in
+// exactly one fragment, vertices without included edges are fragments on their
+// own. Fragments are numbered in order of their first vertex.
+struct Fragments {
+	Fragments(int num_vertices, const std::vector<Edge>& include);
+
+	int Size() const { return int(heads.size()); }
+
+	std::vector<int> heads;  // first vertex of each fragment
+	std::vector<int> tails;  // last vertex of each fragment
+	std::vector<int> next;  // vertex => next vertex in its fragment, -1 at tails
+};
+
+#endif  // TSP_SOLVER_LITTLE_FRAGMENTS_H
@@ -0,0 +1,427 @@
+#include "tsp_solver/little/processes.hpp"
+
+#include <cerrno>
+#include <cstdint>
+
+#include <poll.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "graph/graph.hpp"
+#include "path.hpp"
+#include "statistics.hpp"
+#include "tsp_solver/cancellation.hpp"
+#include "tsp_solver/little/branching_rule.hpp"
+#include "tsp_solver/little/checkpoint.hpp"
+#include "tsp_solver/little/search.hpp"
+#include "tsp_solver/little/tree_node.hpp"
+#include "tsp_solver/options.hpp"
+#include "tsp_solver/progress.hpp"
+#include "util.hpp"
+
+using std::atomic;
+using std::cerr;
+using std::chrono::duration;
+using std::chrono::duration_cast;
+using std::chrono::steady_clock;
+using std::cout;
+using std::deque;
+using std::int32_t;
+using std::istringstream;
+using std::max;
+using std::min;
+using std::numeric_limits;
+using std::ostringstream;
+using std::ref;
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+const int infinity{numeric_limits<int>::max()};
+
+static_assert(ATOMIC_INT_LOCK_FREE == 2,
+		"the shared upper bound must be lock free to work across processes");
+
+// messages sent between the parent and its workers
+enum MessageType : int32_t {
+	request_c,  // worker to parent: send me a subtree
+	node_c,  // parent to worker: a subtree to search
+	donate_c,  // worker to parent: a subtree for an idle worker
+	stop_c,  // parent to worker: no work is left
+	result_c,  // worker to parent: the worker's shortest tour and statistics
+	incumbent_c,  // worker to parent: a tour shorter than it found before
+};
+
+// open nodes per worker to expand the tree to before forking
+const int nodes_per_worker_c{4};
+// nodes a worker expands between checks for idle workers
+const long long donation_check_interval_c{256};
+// milliseconds between the parent's checks for cancellation and progress
+const int poll_ms_c{10};
+
+// lives in memory shared by the parent and all workers
+struct SharedState {
+	atomic<int> upper_bound;
+	// workers waiting for a subtree, busy workers give one up while this is
+	// more than 0
+	atomic<int> idle_workers;
+	// set when the solve is cancelled, workers drop what they are searching
+	CancellationToken cancellation;
+	// nodes expanded by all workers, for progress reports
+	atomic<long long> nodes_expanded;
+};
+
+// The parent's side of the workers: the shared memory, its end of each
+// worker's socket and each worker's process. Whatever is still open when it
+// is destroyed, as when the parent throws, is cancelled, closed, killed and
+// reaped, so no worker outlives the solve blocked on a socket nobody reads.
+struct WorkerProcesses {
+	WorkerProcesses();
+	~WorkerProcesses();
+
+	WorkerProcesses(const WorkerProcesses&) = delete;
+	WorkerProcesses& operator=(const WorkerProcesses&) = delete;
+
+	void* memory;
+	SharedState* shared;
+	// -1 once the parent closed it
+	vector<int> sockets;
+	// -1 once the worker was reaped
+	vector<pid_t> pids;
+};
+
+static void RunWorker(int socket, const Graph& graph,
+		const SolverOptions& options, SharedState& shared);
+static void SendMessage(int socket, MessageType type,
+		const Checkpoint& checkpoint);
+static bool ReceiveMessage(int socket, MessageType& type,
+		Checkpoint& checkpoint);
+static void WriteAll(int socket, const char* data, size_t size);
+static bool ReadAll(int socket, char* data, size_t size);
+
+Path SolveWithProcesses(const Graph& graph, const SolverOptions& options,
+		int upper_bound, Statistics& statistics) {
+	const steady_clock::time_point start{steady_clock::now()};
+	const int num_workers{options.processes};
+
+	WorkerProcesses processes;
+	SharedState& shared{*processes.shared};
+	shared.upper_bound = upper_bound;
+	shared.idle_workers = 0;
+	shared.nodes_expanded = 0;
+
+	// every process searches on its own, sharing only the upper bound, and
+	// threads don't survive a fork, so there are no checkpoints, and the
+	// workers would write over each other's traces
+	SolverOptions worker_options{options};
+	worker_options.processes = 1;
+	worker_options.shared_upper_bound = &shared.upper_bound;
+	worker_options.cancellation = &shared.cancellation;
+	worker_options.checkpoint_file.clear();
+	worker_options.trace_file.clear();
+	worker_options.resume = false;
+	worker_options.progress = nullptr;
+	// the workers send their tours here to be passed on, as long as they beat
+	// the tours of all the others
+	IncumbentReporter incumbent{options.incumbent};
+	if (options.incumbent) { worker_options.incumbent = ref(incumbent); }
+
+	// expand the tree until there is enough to go around
+	unique_ptr<BranchingRule> branching_rule{CreateBranchingRule(
+			options.branching, graph.GetNumVertices(), options)};
+	LittleSearch split{graph, worker_options, *branching_rule, upper_bound};
+	split.Start(TreeNode{graph, options.exact_leaf_size, branching_rule.get()});
+	split.ExpandShallowest(nodes_per_worker_c * num_workers);
+	// holds for every tour left to search, in case the search is cancelled
+	const int split_lower_bound{split.GetLowerBound()};
+
+	Checkpoint combined{split.MakeCheckpoint()};
+	branching_rule->RecordStatistics(combined.statistics);
+	deque<Checkpoint::Node> work(begin(combined.nodes), end(combined.nodes));
+	combined.nodes.clear();
+	shared.nodes_expanded = combined.statistics.Get("nodes_expanded");
+
+	// fork the workers, each with a socket to the parent
+	vector<int>& sockets{processes.sockets};
+	vector<pid_t>& workers{processes.pids};
+	if (!work.empty()) {
+		cout.flush();
+		cerr.flush();
+		for (int worker{0}; worker < num_workers; ++worker) {
+			int pair[2];
+			if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0)
+			{ throw Error{"Could not create a worker socket!"}; }
+			pid_t pid{fork()};
+			if (pid < 0) {
+				close(pair[0]);
+				close(pair[1]);
+				throw Error{"Could not fork a worker!"};
+			}
+			if (pid == 0) {
+				close(pair[0]);
+				for (int socket : sockets) { close(socket); }
+				RunWorker(pair[1], graph, worker_options, shared);
+			}
+			close(pair[1]);
+			sockets.push_back(pair[0]);
+			workers.push_back(pid);
+		}
+	}
+
+	// hand out subtrees until every worker is waiting and none are left
+	vector<int> idle;
+	vector<pollfd> polls;
+	for (int socket : sockets) { polls.push_back(pollfd{socket, POLLIN, 0}); }
+	// poll now and then if the solve can be cancelled or reports progress
+	const int poll_timeout{
+		options.cancellation || options.progress ? poll_ms_c : -1};
+	const steady_clock::duration progress_interval{
+		duration_cast<steady_clock::duration>(
+				duration<double>{options.progress_interval})};
+	steady_clock::time_point next_progress{start + progress_interval};
+	bool cancelled{false};
+	while (!workers.empty() &&
+			!(work.empty() && int(idle.size()) == num_workers)) {
+		if (poll(polls.data(), polls.size(), poll_timeout) < 0) {
+			if (errno == EINTR) { continue; }
+			throw Error{"Could not poll the workers!"};
+		}
+		if (options.cancellation && options.cancellation->IsCancelled() &&
+				!cancelled) {
+			shared.cancellation.Cancel();
+			cancelled = true;
+		}
+		if (options.progress && steady_clock::now() >= next_progress) {
+			SolveProgress progress;
+			progress.nodes_expanded = shared.nodes_expanded.load();
+			progress.upper_bound = shared.upper_bound.load();
+			progress.lower_bound = min(split_lower_bound, progress.upper_bound);
+			progress.seconds =
+				duration_cast<duration<double>>(steady_clock::now() - start)
+				.count();
+			options.progress(progress);
+			next_progress = steady_clock::now() + progress_interval;
+		}
+		for (int worker{0}; worker < num_workers; ++worker) {
+			if (!polls[worker].revents) { continue; }
+			MessageType type;
+			Checkpoint message;
+			if (!ReceiveMessage(sockets[worker], type, message))
+			{ throw Error{"A worker exited before the search finished!"}; }
+			if (type == request_c) { idle.push_back(worker); }
+			else if (type == donate_c)
+			{ work.insert(end(work), begin(message.nodes), end(message.nodes)); }
+			else if (type == incumbent_c) { incumbent(message.shortest); }
+		}
+		if (cancelled) { work.clear(); }
+
+		while (!work.empty() && !idle.empty()) {
+			Checkpoint subtree;
+			subtree.num_vertices = graph.GetNumVertices();
+			subtree.nodes.push_back(work.front());
+			work.pop_front();
+			SendMessage(sockets[idle.back()], node_c, subtree);
+			idle.pop_back();
+		}
+		shared.idle_workers = int(idle.size());
+	}
+
+	// collect each worker's shortest tour and statistics
+	Checkpoint stop;
+	stop.num_vertices = graph.GetNumVertices();
+	for (int worker{0}; worker < int(workers.size()); ++worker) {
+		SendMessage(sockets[worker], stop_c, stop);
+		MessageType type;
+		Checkpoint result;
+		do {
+			if (!ReceiveMessage(sockets[worker], type, result))
+			{ throw Error{"A worker exited before reporting its result!"}; }
+			// tours sent before the worker saw the stop
+			if (type == incumbent_c) { incumbent(result.shortest); }
+		} while (type != result_c);
+		close(sockets[worker]);
+		sockets[worker] = -1;
+		waitpid(workers[worker], nullptr, 0);
+		workers[worker] = -1;
+
+		if (!result.shortest.vertices.empty() &&
+				(combined.shortest.vertices.empty() ||
+				 result.shortest.length < combined.shortest.length))
+		{ combined.shortest = result.shortest; }
+		// a cancelled worker's lower bound covers the nodes it left open
+		combined.lowest_pruned = min(combined.lowest_pruned,
+				min(result.lowest_pruned,
+					int(result.statistics.Get("lower_bound"))));
+		for (const auto& counter : result.statistics.GetCounters()) {
+			if (counter.first == "edges_eliminated") {
+				combined.statistics.Set(counter.first, max(counter.second,
+							combined.statistics.Get(counter.first)));
+			} else if (counter.first != "lower_bound") {
+				combined.statistics.Add(counter.first, counter.second);
+			}
+		}
+	}
+
+	// no tour is shorter than the shortest one or any pruned bound
+	int lower_bound{combined.lowest_pruned};
+	if (!combined.shortest.vertices.empty())
+	{ lower_bound = min(lower_bound, combined.shortest.length); }
+	else { lower_bound = min(lower_bound, upper_bound); }
+	// undistributed subtrees were dropped
+	if (cancelled) { lower_bound = min(lower_bound, split_lower_bound); }
+	statistics = combined.statistics;
+	statistics.Set("lower_bound", lower_bound);
+	if (cancelled) { statistics.Set("cancelled", 1); }
+	statistics.Set("processes", num_workers);
+
+	if (combined.shortest.vertices.empty()) { return Path{}; }
+	return combined.shortest;
+}
+
+WorkerProcesses::WorkerProcesses() :
+		memory{mmap(nullptr, sizeof(SharedState), PROT_READ | PROT_WRITE,
+				MAP_SHARED | MAP_ANONYMOUS, -1, 0)}, shared{nullptr} {
+	if (memory == MAP_FAILED) { throw Error{"Could not map shared memory!"}; }
+	shared = new (memory) SharedState{};
+}
+
+WorkerProcesses::~WorkerProcesses() {
+	// workers in the middle of a search drop it, and the kill takes care of
+	// any stuck elsewhere
+	shared->cancellation.Cancel();
+	for (int socket : sockets) { if (socket >= 0) { close(socket); } }
+	for (pid_t pid : pids) {
+		if (pid < 0) { continue; }
+		kill(pid, SIGKILL);
+		waitpid(pid, nullptr, 0);
+	}
+	munmap(memory, sizeof(SharedState));
+}
+
+// The worker's side of the protocol: ask for a subtree, search it, and repeat
+// until the parent says to stop. Never returns, the worker exits instead.
+void RunWorker(int socket, const Graph& graph, const SolverOptions& options,
+		SharedState& shared) try {
+	// the parent passes the worker's tours on
+	SolverOptions search_options{options};
+	if (options.incumbent) {
+		search_options.incumbent = [socket, &graph](const Path& tour) {
+			Checkpoint message;
+			message.num_vertices = graph.GetNumVertices();
+			message.shortest = tour;
+			SendMessage(socket, incumbent_c, message);
+		};
+	}
+	unique_ptr<BranchingRule> branching_rule{CreateBranchingRule(
+			options.branching, graph.GetNumVertices(), options)};
+	LittleSearch search{graph, search_options, *branching_rule,
+		shared.upper_bound.load()};
+	const TreeNode empty{graph, options.exact_leaf_size, branching_rule.get()};
+
+	Checkpoint request;
+	request.num_vertices = graph.GetNumVertices();
+	long long donations{0};
+	long long nodes_reported{0};
+	auto report_nodes = [&] {
+		shared.nodes_expanded += search.GetNodesExpanded() - nodes_reported;
+		nodes_reported = search.GetNodesExpanded();
+	};
+	while (true) {
+		SendMessage(socket, request_c, request);
+		MessageType type;
+		Checkpoint message;
+		// the parent is gone, so nobody wants the result
+		if (!ReceiveMessage(socket, type, message)) { _exit(1); }
+
+		if (type == stop_c) {
+			Checkpoint result{search.MakeCheckpoint()};
+			branching_rule->RecordStatistics(result.statistics);
+			result.statistics.Set("subtrees_donated", donations);
+			SendMessage(socket, result_c, result);
+			_exit(0);
+		}
+
+		search.AddNodes(message.nodes, empty);
+		while (!search.Run(donation_check_interval_c)) {
+			report_nodes();
+			// the open nodes are left for the result's lower bound
+			if (shared.cancellation.IsCancelled()) { break; }
+			if (shared.idle_workers.load() > 0 &&
+					search.GetNumOpenNodes() > 1) {
+				Checkpoint donation;
+				donation.num_vertices = graph.GetNumVertices();
+				donation.nodes.push_back(search.TakeShallowestNode());
+				SendMessage(socket, donate_c, donation);
+				++donations;
+			}
+		}
+		report_nodes();
+	}
+} catch (...) {
+	// the parent notices the closed socket and reports the failure
+	_exit(2);
+}
+
+// Messages are a type and a payload size, followed by the payload, which is a
+// checkpoint holding whatever the message carries.
+void SendMessage(int socket, MessageType type, const Checkpoint& checkpoint) {
+	ostringstream payload;
+	WriteCheckpoint(payload, checkpoint);
+	const string bytes{payload.str()};
+	const int32_t header[2]{type, int32_t(bytes.size())};
+	WriteAll(socket, reinterpret_cast<const char*>(header), sizeof(header));
+	WriteAll(socket, bytes.data(), bytes.size());
+}
+
+bool ReceiveMessage(int socket, MessageType& type, Checkpoint& checkpoint) {
+	int32_t header[2];
+	if (!ReadAll(socket, reinterpret_cast<char*>(header), sizeof(header)))
+	{ return false; }
+	string bytes(header[1], '\0');
+	if (!ReadAll(socket, &bytes[0], bytes.size())) { return false; }
+	type = MessageType(header[0]);
+	istringstream payload{bytes};
+	checkpoint = ReadCheckpoint(payload);
+	return true;
+}
+
+void WriteAll(int socket, const char* data, size_t size) {
+	while (size > 0) {
+		// a dead peer shows up as an error rather than SIGPIPE
+		ssize_t written{send(socket, data, size, MSG_NOSIGNAL)};
+		if (written < 0) {
+			if (errno == EINTR) { continue; }
+			throw Error{"Could not write to a worker socket!"};
+		}
+		data += written;
+		size -= written;
+	}
+}
+
+// returns false if the other end closed the socket
+bool ReadAll(int socket, char* data, size_t size) {
+	while (size > 0) {
+		ssize_t got{read(socket, data, size)};
+		if (got < 0 && errno == EINTR) { continue; }
+		if (got <= 0) { return false; }
+		data += got;
+		size -= got;
+	}
+	return true;
+}
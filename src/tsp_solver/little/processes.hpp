@@ -0,0 +1,18 @@
+#ifndef TSP_SOLVER_LITTLE_PROCESSES_H
+#define TSP_SOLVER_LITTLE_PROCESSES_H
+
+class Graph;
+class Statistics;
+struct Path;
+struct SolverOptions;
+
+// Searches the tree of Little's algorithm with options.processes forked worker
+// processes. The tree is first expanded until there are a few open nodes per
+// worker, then the workers take subtrees from the parent over local sockets and
+// hand part of their own back when another worker runs out of work. The upper
+// bound lives in shared memory, so a tour found by one worker prunes all of
+// them. Checkpoints are not written in this mode.
+Path SolveWithProcesses(const Graph& graph, const SolverOptions& options,
+		int upper_bound, Statistics& statistics);
+
+#endif  // TSP_SOLVER_LITTLE_PROCESSES_H
@@ -0,0 +1,370 @@
+#include "tsp_solver/little/search.hpp"
+
+#include <cmath>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <vector>
+
+#include "graph/graph.hpp"
+#include "path.hpp"
+#include "statistics.hpp"
+#include "tsp_solver/cancellation.hpp"
+#include "tsp_solver/little/branching_rule.hpp"
+#include "tsp_solver/little/checkpoint.hpp"
+#include "tsp_solver/little/edge_elimination.hpp"
+#include "tsp_solver/little/trace.hpp"
+#include "tsp_solver/little/tree_node.hpp"
+#include "tsp_solver/local_search.hpp"
+#include "tsp_solver/options.hpp"
+#include "tsp_solver/progress.hpp"
+
+using std::atomic;
+using std::ceil;
+using std::chrono::duration;
+using std::chrono::duration_cast;
+using std::chrono::seconds;
+using std::chrono::steady_clock;
+using std::min;
+using std::min_element;
+using std::numeric_limits;
+using std::rotate;
+using std::vector;
+
+const int infinity{numeric_limits<int>::max()};
+
+LittleSearch::LittleSearch(const Graph& graph, const SolverOptions& options,
+		BranchingRule& branching_rule, int upper_bound) : graph_{graph},
+		options_{options}, branching_rule_{branching_rule},
+		upper_bound_{infinity}, prune_bound_{infinity},
+		lowest_pruned_{infinity}, eliminator_{graph}, eliminated_at_{infinity},
+		nodes_expanded_{0}, next_dive_{0}, dives_{0}, dive_improvements_{0},
+		eliminations_{0}, cancelled_{false}, graph_fingerprint_{0},
+		start_{steady_clock::now()},
+		next_progress_{start_} {
+	if (!options_.trace_file.empty()) {
+		trace_writer_.reset(new TraceWriter{options_.trace_file,
+				graph_.GetNumVertices(), options_.trace_sample,
+				options_.trace_limit});
+	}
+
+	// a passed upper bound acts like a tour of that length, but no vertices
+	Path bound;
+	bound.length = upper_bound;
+	if (UpdateShortest(bound) && trace_writer_)
+	{ trace_writer_->IncumbentFound(0, kIncumbentInitial, upper_bound_); }
+
+	if (!options_.checkpoint_file.empty()) {
+		checkpoint_writer_.reset(
+				new CheckpointWriter{options_.checkpoint_file});
+		next_checkpoint_ = steady_clock::now() +
+			seconds{options_.checkpoint_interval};
+		graph_fingerprint_ = GetGraphFingerprint(graph_);
+	}
+	if (options_.progress) {
+		next_progress_ = start_ + duration_cast<steady_clock::duration>(
+				duration<double>{options_.progress_interval});
+	}
+}
+
+void LittleSearch::Start(TreeNode root) {
+	TraceNode(root, nullptr, kTraceRoot);
+	if (EvaluateNode(root)) { nodes_.push_back(root); }
+}
+
+void LittleSearch::Resume(const Checkpoint& checkpoint,
+		const TreeNode& empty) {
+	if (UpdateShortest(checkpoint.shortest) && trace_writer_)
+	{ trace_writer_->IncumbentFound(0, kIncumbentInitial, upper_bound_); }
+	lowest_pruned_ = min(lowest_pruned_, checkpoint.lowest_pruned);
+	const Statistics& statistics{checkpoint.statistics};
+	nodes_expanded_ = statistics.Get("nodes_expanded");
+	next_dive_ = nodes_expanded_;
+	dives_ = statistics.Get("dives");
+	dive_improvements_ = statistics.Get("dive_improvements");
+	eliminations_ = statistics.Get("eliminations");
+
+	AddNodes(checkpoint.nodes, empty);
+}
+
+void LittleSearch::AddNodes(const vector<Checkpoint::Node>& saved,
+		const TreeNode& empty) {
+	// the nodes are evaluated again, since only their edges were saved, and
+	// the edges eliminated here are excluded from them again
+	const bool eliminated_any{eliminator_.GetNumEliminated() > 0};
+	for (const Checkpoint::Node& saved_node : saved) {
+		TreeNode node{empty};
+		for (const Edge& e : saved_node.include) { node.AddInclude(e); }
+		for (const Edge& e : saved_node.exclude) { node.AddExclude(e); }
+		if (eliminated_any) { node.AddExcludes(eliminator_.GetEliminated()); }
+		TraceNode(node, nullptr, kTraceResumed);
+		if (EvaluateNode(node)) { nodes_.push_back(node); }
+	}
+}
+
+bool LittleSearch::Run(long long max_expansions) {
+	const long long stop_at{nodes_expanded_ + max_expansions};
+
+	// branch and bound, baby, branch and bound
+	while (!nodes_.empty()) {
+		if (max_expansions >= 0 && nodes_expanded_ >= stop_at) { return false; }
+		if (options_.cancellation && options_.cancellation->IsCancelled()) {
+			cancelled_ = true;
+			return false;
+		}
+		if (options_.shared_upper_bound) { ReadSharedUpperBound(); }
+
+		if (checkpoint_writer_ && steady_clock::now() >= next_checkpoint_) {
+			checkpoint_writer_->Submit(MakeCheckpoint());
+			next_checkpoint_ = steady_clock::now() +
+				seconds{options_.checkpoint_interval};
+		}
+		if (options_.progress && steady_clock::now() >= next_progress_)
+		{ ReportProgress(); }
+
+		// every so often, dive for a better tour, the first dive is from the
+		// root
+		if (options_.dive_frequency > 0 && nodes_expanded_ >= next_dive_) {
+			next_dive_ = nodes_expanded_ + options_.dive_frequency;
+			Dive();
+		}
+
+		if (options_.eliminate_edges && prune_bound_ < eliminated_at_)
+		{ EliminateEdges(); }
+
+		// get the current node and remove it from the stack
+		TreeNode current{nodes_.back()};
+		nodes_.pop_back();
+
+		// the prune bound may have dropped since the node was pushed
+		if (Prune(current.GetLowerBound())) {
+			TracePrune(current, kPruneStale);
+			continue;
+		}
+		++nodes_expanded_;
+
+		// two branches:
+		// 1. Exclude the highest penalty, lowest cost edge
+		// (if excluding it doesn't create a disconnected graph)
+		bool eliminated_any{eliminator_.GetNumEliminated() > 0};
+		int exclude_bound{infinity};
+		if (current.HasExcludeBranch()) {
+			TreeNode exclude{TreeNode::MakeExcludeChild(current)};
+			if (eliminated_any)
+			{ exclude.AddExcludes(eliminator_.GetEliminated()); }
+			TraceNode(exclude, &current, kTraceExclude);
+			if (EvaluateNode(exclude)) { nodes_.push_back(exclude); }
+			exclude_bound = exclude.GetLowerBound();
+		}
+
+		// 2. Include the highest penalty, lowest cost edge
+		// adding this node on second causes the algorithm to branch to the
+		// right before left (as suggested in the original paper)
+		// no tour under the prune bound goes through an eliminated edge
+		int include_bound{infinity};
+		if (!eliminator_.IsEliminated(current.GetNextEdge())) {
+			TreeNode include{TreeNode::MakeIncludeChild(current)};
+			if (eliminated_any)
+			{ include.AddExcludes(eliminator_.GetEliminated()); }
+			TraceNode(include, &current, kTraceInclude);
+			if (EvaluateNode(include)) { nodes_.push_back(include); }
+			include_bound = include.GetLowerBound();
+		}
+
+		// let the branching rule learn from how the branch turned out
+		if (current.HasExcludeBranch()) {
+			branching_rule_.RecordBranch(current.GetNextEdge(),
+					current.GetLowerBound(), include_bound, exclude_bound);
+		}
+	}
+
+	// a finished search resumes straight to its answer
+	if (checkpoint_writer_) { checkpoint_writer_->Submit(MakeCheckpoint()); }
+	return true;
+}
+
+bool LittleSearch::ExpandShallowest(int num_nodes) {
+	while (!nodes_.empty() && GetNumOpenNodes() < num_nodes && !cancelled_) {
+		// A shallowest node the prune bound dropped to is pruned here, since
+		// Run would expand the deepest node in its place.
+		if (options_.shared_upper_bound) { ReadSharedUpperBound(); }
+		if (Prune(nodes_.front().GetLowerBound())) {
+			TracePrune(nodes_.front(), kPruneStale);
+			nodes_.erase(begin(nodes_));
+			continue;
+		}
+
+		// move the shallowest node to the top of the stack and expand it
+		rotate(begin(nodes_), begin(nodes_) + 1, end(nodes_));
+		Run(1);
+	}
+	return nodes_.empty();
+}
+
+Checkpoint::Node LittleSearch::TakeShallowestNode() {
+	// the stack grows downwards, so the bottom node is the shallowest
+	Checkpoint::Node shallowest{
+		nodes_.front().GetIncludes(), nodes_.front().GetBranchExcludes()};
+	nodes_.erase(begin(nodes_));
+	return shallowest;
+}
+
+int LittleSearch::GetLowerBound() const {
+	int lower_bound{min(upper_bound_, lowest_pruned_)};
+	for (const TreeNode& node : nodes_)
+	{ lower_bound = min(lower_bound, node.GetLowerBound()); }
+	return lower_bound;
+}
+
+void LittleSearch::RecordStatistics(Statistics& statistics) const {
+	statistics.Set("nodes_expanded", nodes_expanded_);
+	statistics.Set("dives", dives_);
+	statistics.Set("dive_improvements", dive_improvements_);
+	statistics.Set("eliminations", eliminations_);
+	statistics.Set("edges_eliminated", eliminator_.GetNumEliminated());
+	statistics.Set("lower_bound", GetLowerBound());
+	if (cancelled_) { statistics.Set("cancelled", 1); }
+}
+
+bool LittleSearch::EvaluateNode(TreeNode& node) {
+	const long long start{trace_writer_ ? trace_writer_->Now() : 0};
+	const bool branch{node.CalcLBAndNextEdge(prune_bound_)};
+	const int lower_bound{node.GetLowerBound()};
+	if (trace_writer_) {
+		trace_writer_->NodeEvaluated(node.GetTraceId(), start, lower_bound,
+				branch ? node.GetNextEdge() : Edge{});
+	}
+
+	// add the node to the list only if its lower bound is strictly less than
+	// the prune bound
+	if (branch) {
+		if (!Prune(lower_bound)) { return true; }
+		TracePrune(node, kPruneBound);
+		return false;
+	}
+
+	// otherwise, no more nodes to evaluate on this branch
+	// (complete TSP path, or node with no next edge)
+	// this will work even if the node has no next edge, because then the node
+	// must have an infinite lower bound and will not become the shortest
+	if (lower_bound < upper_bound_ && UpdateShortest(node.GetTSPPath())) {
+		if (trace_writer_) {
+			trace_writer_->IncumbentFound(node.GetTraceId(), kIncumbentLeaf,
+					upper_bound_);
+		}
+	} else if (lower_bound == infinity) {
+		// an exact leaf only looks for tours under the prune bound, so all that
+		// is known about it is that its tours aren't shorter than that
+		lowest_pruned_ = min(lowest_pruned_, prune_bound_);
+		TracePrune(node, kPruneNoTour);
+	} else { TracePrune(node, kPruneLeaf); }
+	return false;
+}
+
+bool LittleSearch::Prune(int lower_bound) {
+	if (lower_bound < prune_bound_) { return false; }
+	lowest_pruned_ = min(lowest_pruned_, lower_bound);
+	return true;
+}
+
+void LittleSearch::Dive() {
+	auto promising_it = min_element(begin(nodes_), end(nodes_),
+			[](const TreeNode& first, const TreeNode& second)
+			{ return first.GetLowerBound() < second.GetLowerBound(); });
+	++dives_;
+	if (UpdateShortest(TwoOpt(graph_, promising_it->CompleteGreedily()))) {
+		++dive_improvements_;
+		if (trace_writer_) {
+			trace_writer_->IncumbentFound(promising_it->GetTraceId(),
+					kIncumbentDive, upper_bound_);
+		}
+	}
+}
+
+bool LittleSearch::UpdateShortest(const Path& tour) {
+	if (tour.length >= upper_bound_) { return false; }
+	shortest_ = tour;
+	upper_bound_ = tour.length;
+
+	// only look for tours that beat the upper bound by more than the gap
+	prune_bound_ = upper_bound_;
+	if (options_.gap > 0 && upper_bound_ != infinity)
+	{ prune_bound_ = int(ceil(upper_bound_ / (1 + options_.gap))); }
+
+	// let the other searches prune with the tour too
+	atomic<int>* shared{options_.shared_upper_bound};
+	if (shared && !tour.vertices.empty()) {
+		int current{shared->load()};
+		while (upper_bound_ < current &&
+				!shared->compare_exchange_weak(current, upper_bound_)) {}
+	}
+	if (options_.incumbent && !tour.vertices.empty())
+	{ options_.incumbent(shortest_); }
+	return true;
+}
+
+void LittleSearch::ReadSharedUpperBound() {
+	int shared{options_.shared_upper_bound->load(std::memory_order_relaxed)};
+	if (shared >= upper_bound_) { return; }
+
+	// the tour itself belongs to whoever found it
+	Path bound;
+	bound.length = shared;
+	UpdateShortest(bound);
+	if (trace_writer_)
+	{ trace_writer_->IncumbentFound(0, kIncumbentShared, upper_bound_); }
+}
+
+void LittleSearch::EliminateEdges() {
+	eliminator_.Eliminate(prune_bound_);
+	eliminated_at_ = prune_bound_;
+	++eliminations_;
+	lowest_pruned_ = min(lowest_pruned_, eliminator_.GetLowestBound());
+}
+
+void LittleSearch::ReportProgress() {
+	SolveProgress progress;
+	progress.nodes_expanded = nodes_expanded_;
+	progress.upper_bound = upper_bound_;
+	progress.lower_bound = GetLowerBound();
+	const steady_clock::time_point now{steady_clock::now()};
+	progress.seconds = duration_cast<duration<double>>(now - start_).count();
+	options_.progress(progress);
+	next_progress_ = now + duration_cast<steady_clock::duration>(
+			duration<double>{options_.progress_interval});
+}
+
+void LittleSearch::TraceNode(TreeNode& node, const TreeNode* parent,
+		TraceBranch branch) {
+	if (!trace_writer_) { return; }
+	node.SetTraceId(trace_writer_->NewNode());
+	trace_writer_->NodeCreated(node.GetTraceId(),
+			parent ? parent->GetTraceId() : 0, branch,
+			parent ? parent->GetNextEdge() : Edge{},
+			int(node.GetIncludes().size()));
+}
+
+void LittleSearch::TracePrune(const TreeNode& node, TracePruneReason reason) {
+	if (trace_writer_) {
+		trace_writer_->NodePruned(node.GetTraceId(), reason,
+				node.GetLowerBound());
+	}
+}
+
+Checkpoint LittleSearch::MakeCheckpoint() const {
+	Checkpoint checkpoint;
+	checkpoint.num_vertices = graph_.GetNumVertices();
+	checkpoint.graph_fingerprint = graph_fingerprint_;
+	checkpoint.shortest = shortest_;
+	// infinite until a tour is found, while the empty path has length 0
+	checkpoint.shortest.length = upper_bound_;
+	checkpoint.lowest_pruned = lowest_pruned_;
+	RecordStatistics(checkpoint.statistics);
+	for (const TreeNode& node : nodes_) {
+		checkpoint.nodes.push_back(
+				Checkpoint::Node{node.GetIncludes(), node.GetBranchExcludes()});
+	}
+	return checkpoint;
+}
@@ -0,0 +1,132 @@
+#ifndef TSP_SOLVER_LITTLE_SEARCH_H
+#define TSP_SOLVER_LITTLE_SEARCH_H
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "path.hpp"
+#include "tsp_solver/little/checkpoint.hpp"
+#include "tsp_solver/little/edge_elimination.hpp"
+#include "tsp_solver/little/trace.hpp"
+#include "tsp_solver/little/tree_node.hpp"
+
+class BranchingRule;
+class Graph;
+class Statistics;
+struct SolverOptions;
+
+// The state of one run of Little's algorithm: the open nodes, the shortest tour
+// found so far and the counters reported as statistics.
+class LittleSearch {
+public:
+	LittleSearch(const Graph& graph, const SolverOptions& options,
+			BranchingRule& branching_rule, int upper_bound);
+
+	// start the search from the root
+	void Start(TreeNode root);
+	// pick up the search saved in a checkpoint, with its nodes rebuilt from
+	// the given empty node
+	void Resume(const Checkpoint& checkpoint, const TreeNode& empty);
+	// rebuild saved nodes from the given empty node and add them to the search
+	void AddNodes(const std::vector<Checkpoint::Node>& saved,
+			const TreeNode& empty);
+
+	// Branch and bound until no open nodes are left, or until max_expansions
+	// more nodes have been expanded if it isn't negative, or until the search
+	// is cancelled. Returns true if the search is finished.
+	bool Run(long long max_expansions = -1);
+
+	// Expand the open nodes closest to the root first, until there are at
+	// least num_nodes open nodes to split among several searches, or until the
+	// search is cancelled. Returns true if the search is finished.
+	bool ExpandShallowest(int num_nodes);
+
+	int GetNumOpenNodes() const { return int(nodes_.size()); }
+	long long GetNodesExpanded() const { return nodes_expanded_; }
+	// removes the open node closest to the root, which has the most left to
+	// search under it, so it can be searched elsewhere
+	Checkpoint::Node TakeShallowestNode();
+
+	// the shortest tour found, empty if none beat the initial upper bound
+	const Path& GetShortest() const { return shortest_; }
+	// no tour is shorter than this, it is below the length of the shortest tour
+	// only if nodes were pruned because of the gap or the search was stopped
+	// with nodes left open
+	int GetLowerBound() const;
+
+	void RecordStatistics(Statistics& statistics) const;
+
+	// copy the state of the search into a checkpoint
+	Checkpoint MakeCheckpoint() const;
+
+private:
+	// evaluate a node by calculating its next Edge and lower bound
+	// return true if the node should be branched on
+	bool EvaluateNode(TreeNode& node);
+
+	// return true if a node with the given lower bound can be pruned, keeping
+	// track of the lowest bound that was pruned
+	bool Prune(int lower_bound);
+
+	// greedily complete the open node with the lowest bound and improve the
+	// tour with 2-opt
+	void Dive();
+
+	// make the tour the shortest if it beats the upper bound, and share it
+	bool UpdateShortest(const Path& tour);
+
+	// lower the upper bound to one shared by another search, if it is lower
+	void ReadSharedUpperBound();
+
+	// exclude the edges the root reduced costs rule out under the prune bound
+	void EliminateEdges();
+
+	// pass a snapshot of the search to the progress callback
+	void ReportProgress();
+
+	// number a node made from the parent, or from no node, in the trace
+	void TraceNode(TreeNode& node, const TreeNode* parent, TraceBranch branch);
+	void TracePrune(const TreeNode& node, TracePruneReason reason);
+
+	const Graph& graph_;
+	const SolverOptions& options_;
+	BranchingRule& branching_rule_;
+
+	// used as a stack
+	std::vector<TreeNode> nodes_;
+
+	Path shortest_;  // stays empty until a tour under the upper bound is found
+	int upper_bound_;
+	// nodes whose lower bound reaches this are pruned, it is the upper bound
+	// divided by 1 + gap
+	int prune_bound_;
+	int lowest_pruned_;
+
+	// edges that can't be in a tour under the prune bound, based on the root's
+	// reduced costs, rechecked whenever the prune bound drops
+	EdgeEliminator eliminator_;
+	int eliminated_at_;
+
+	long long nodes_expanded_;
+	long long next_dive_;
+	long long dives_;
+	long long dive_improvements_;
+	long long eliminations_;
+	bool cancelled_;
+
+	// null if checkpoints are off
+	std::unique_ptr<CheckpointWriter> checkpoint_writer_;
+	std::chrono::steady_clock::time_point next_checkpoint_;
+	// of the graph, only found if checkpoints are on
+	std::uint64_t graph_fingerprint_;
+
+	// null if tracing is off
+	std::unique_ptr<TraceWriter> trace_writer_;
+
+	std::chrono::steady_clock::time_point start_;
+	std::chrono::steady_clock::time_point next_progress_;
+};
+
+#endif  // TSP_SOLVER_LITTLE_SEARCH_H
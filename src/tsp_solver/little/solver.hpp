@@ -1,15 +1,21 @@
 #ifndef TSP_SOLVER_LITTLE_SOLVER_H
 #define TSP_SOLVER_LITTLE_SOLVER_H
 
+#include "tsp_solver/options.hpp"
 #include "tsp_solver/tsp_solver.hpp"
 
 /* Solves the TSP using the optimal algorithm described by Little et. al */
 class LittleTSPSolver : public TSPSolver {
 public:
-	LittleTSPSolver() : TSPSolver{true} {}
+	LittleTSPSolver() : LittleTSPSolver{SolverOptions{}} {}
+	explicit LittleTSPSolver(const SolverOptions& options) :
+		TSPSolver{true}, options_{options} {}
 
 	Path Solve(const Graph&) const override;
 	Path Solve(const Graph&, int upper_bound) const override;
+
+private:
+	SolverOptions options_;
 };
 
 #endif  // TSP_SOLVER_LITTLE_SOLVER_H
@@ -0,0 +1,272 @@
+#include "tsp_solver/little/threads.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "graph/graph.hpp"
+#include "path.hpp"
+#include "statistics.hpp"
+#include "tsp_solver/cancellation.hpp"
+#include "tsp_solver/little/branching_rule.hpp"
+#include "tsp_solver/little/checkpoint.hpp"
+#include "tsp_solver/little/search.hpp"
+#include "tsp_solver/little/tree_node.hpp"
+#include "tsp_solver/options.hpp"
+#include "tsp_solver/progress.hpp"
+
+using std::atomic;
+using std::chrono::duration;
+using std::chrono::duration_cast;
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+using std::condition_variable;
+using std::cref;
+using std::current_exception;
+using std::deque;
+using std::exception_ptr;
+using std::max;
+using std::min;
+using std::mutex;
+using std::ref;
+using std::rethrow_exception;
+using std::thread;
+using std::unique_lock;
+using std::unique_ptr;
+using std::vector;
+
+// open nodes per thread to expand the tree to before starting the threads
+const int nodes_per_thread_c{4};
+// nodes a thread expands between checks for idle threads
+const long long donation_check_interval_c{256};
+// how often waiting threads check for cancellation
+const milliseconds cancellation_poll_interval_c{10};
+
+// the subtrees left to search, shared by all threads
+struct WorkQueue {
+	mutex queue_mutex;
+	// signalled when a subtree is added or the search finishes
+	condition_variable changed;
+	// signalled only when the search finishes
+	condition_variable finished_changed;
+	deque<Checkpoint::Node> nodes;
+	int num_idle{0};
+	bool finished{false};
+	// a copy of num_idle busy threads read without the lock, they give up a
+	// subtree while it is more than 0
+	atomic<int> idle_threads{0};
+	// nodes expanded by all threads, for progress reports
+	atomic<long long> nodes_expanded{0};
+};
+
+// what each thread leaves behind for the combined result
+struct ThreadResult {
+	Path shortest;
+	Statistics statistics;
+	exception_ptr error;
+};
+
+static void RunThread(const Graph& graph, const SolverOptions& options,
+		int num_threads, WorkQueue& queue, ThreadResult& result);
+static void SearchThread(const Graph& graph, const SolverOptions& options,
+		int num_threads, WorkQueue& queue, ThreadResult& result);
+static bool IsCancelled(const SolverOptions& options);
+
+Path SolveWithThreads(const Graph& graph, const SolverOptions& options,
+		int upper_bound, Statistics& statistics) {
+	const steady_clock::time_point start{steady_clock::now()};
+	const int num_threads{options.threads};
+
+	// an outer solver sharing its upper bound gets the threads' tours directly
+	atomic<int> own_upper_bound{upper_bound};
+	atomic<int>* shared_upper_bound{options.shared_upper_bound ?
+		options.shared_upper_bound : &own_upper_bound};
+
+	// every thread searches on its own, sharing only the upper bound, and
+	// progress is reported here instead of by each thread
+	SolverOptions thread_options{options};
+	thread_options.threads = 1;
+	thread_options.shared_upper_bound = shared_upper_bound;
+	thread_options.checkpoint_file.clear();
+	thread_options.trace_file.clear();
+	thread_options.resume = false;
+	thread_options.progress = nullptr;
+	// the threads' tours are passed on one at a time, and only if they beat
+	// the tours of all the others
+	IncumbentReporter incumbent{options.incumbent};
+	if (options.incumbent) { thread_options.incumbent = ref(incumbent); }
+
+	// expand the tree until there is enough to go around
+	unique_ptr<BranchingRule> branching_rule{CreateBranchingRule(
+			options.branching, graph.GetNumVertices(), options)};
+	LittleSearch split{graph, thread_options, *branching_rule, upper_bound};
+	split.Start(TreeNode{graph, options.exact_leaf_size, branching_rule.get()});
+	split.ExpandShallowest(nodes_per_thread_c * num_threads);
+	// holds for every tour left to search, in case the search is cancelled
+	const int split_lower_bound{split.GetLowerBound()};
+
+	Checkpoint combined{split.MakeCheckpoint()};
+	branching_rule->RecordStatistics(combined.statistics);
+	WorkQueue queue;
+	queue.nodes.assign(begin(combined.nodes), end(combined.nodes));
+	queue.nodes_expanded = combined.statistics.Get("nodes_expanded");
+	combined.nodes.clear();
+
+	vector<ThreadResult> results(num_threads);
+	vector<thread> threads;
+	if (!queue.nodes.empty()) {
+		for (int index{0}; index < num_threads; ++index) {
+			threads.emplace_back(RunThread, cref(graph), cref(thread_options),
+					num_threads, ref(queue), ref(results[index]));
+		}
+	}
+
+	// report progress until the threads run out of work
+	if (options.progress && !threads.empty()) {
+		const duration<double> interval{options.progress_interval};
+		unique_lock<mutex> lock{queue.queue_mutex};
+		while (!queue.finished) {
+			queue.finished_changed.wait_for(lock, interval);
+			if (queue.finished) { break; }
+			lock.unlock();
+			SolveProgress progress;
+			progress.nodes_expanded = queue.nodes_expanded.load();
+			progress.upper_bound = shared_upper_bound->load();
+			progress.lower_bound = min(split_lower_bound, progress.upper_bound);
+			progress.seconds =
+				duration_cast<duration<double>>(steady_clock::now() - start)
+				.count();
+			options.progress(progress);
+			lock.lock();
+		}
+	}
+	for (thread& search_thread : threads) { search_thread.join(); }
+
+	// combine each thread's shortest tour and statistics
+	bool cancelled{!queue.nodes.empty()};
+	for (const ThreadResult& result : results) {
+		if (result.error) { rethrow_exception(result.error); }
+		if (!result.shortest.vertices.empty() &&
+				(combined.shortest.vertices.empty() ||
+				 result.shortest.length < combined.shortest.length))
+		{ combined.shortest = result.shortest; }
+		// a cancelled thread's lower bound covers the nodes it left open
+		combined.lowest_pruned = min(combined.lowest_pruned,
+				int(result.statistics.Get("lower_bound")));
+		if (result.statistics.Get("cancelled")) { cancelled = true; }
+		for (const auto& counter : result.statistics.GetCounters()) {
+			if (counter.first == "edges_eliminated") {
+				combined.statistics.Set(counter.first, max(counter.second,
+							combined.statistics.Get(counter.first)));
+			} else if (counter.first != "lower_bound" &&
+					counter.first != "cancelled") {
+				combined.statistics.Add(counter.first, counter.second);
+			}
+		}
+	}
+
+	// no tour is shorter than the shortest one or any pruned bound
+	int lower_bound{combined.lowest_pruned};
+	if (!combined.shortest.vertices.empty())
+	{ lower_bound = min(lower_bound, combined.shortest.length); }
+	else { lower_bound = min(lower_bound, upper_bound); }
+	// undistributed subtrees were dropped
+	if (cancelled) { lower_bound = min(lower_bound, split_lower_bound); }
+	statistics = combined.statistics;
+	statistics.Set("lower_bound", lower_bound);
+	if (cancelled) { statistics.Set("cancelled", 1); }
+	statistics.Set("threads", num_threads);
+
+	if (combined.shortest.vertices.empty()) { return Path{}; }
+	return combined.shortest;
+}
+
+// keeps an exception from ending the program, it is rethrown after the threads
+// are joined
+void RunThread(const Graph& graph, const SolverOptions& options,
+		int num_threads, WorkQueue& queue, ThreadResult& result) {
+	try {
+		SearchThread(graph, options, num_threads, queue, result);
+	} catch (...) {
+		result.error = current_exception();
+		unique_lock<mutex> lock{queue.queue_mutex};
+		queue.finished = true;
+		queue.changed.notify_all();
+		queue.finished_changed.notify_all();
+	}
+}
+
+// Take a subtree from the queue, search it, and repeat until every thread is
+// waiting for one and none are left.
+void SearchThread(const Graph& graph, const SolverOptions& options,
+		int num_threads, WorkQueue& queue, ThreadResult& result) {
+	unique_ptr<BranchingRule> branching_rule{CreateBranchingRule(
+			options.branching, graph.GetNumVertices(), options)};
+	LittleSearch search{graph, options, *branching_rule,
+		options.shared_upper_bound->load()};
+	const TreeNode empty{graph, options.exact_leaf_size, branching_rule.get()};
+
+	long long donations{0};
+	long long nodes_reported{0};
+	auto report_nodes = [&] {
+		queue.nodes_expanded += search.GetNodesExpanded() - nodes_reported;
+		nodes_reported = search.GetNodesExpanded();
+	};
+
+	while (true) {
+		vector<Checkpoint::Node> subtree;
+		{
+			unique_lock<mutex> lock{queue.queue_mutex};
+			queue.idle_threads = ++queue.num_idle;
+			while (queue.nodes.empty() && !queue.finished) {
+				if (queue.num_idle == num_threads || IsCancelled(options)) {
+					queue.finished = true;
+					queue.changed.notify_all();
+					queue.finished_changed.notify_all();
+					break;
+				}
+				// a cancelled search leaves nodes in the queue, so waiting
+				// threads have to notice it themselves
+				if (options.cancellation)
+				{ queue.changed.wait_for(lock, cancellation_poll_interval_c); }
+				else { queue.changed.wait(lock); }
+			}
+			if (queue.finished) { break; }
+			subtree.push_back(queue.nodes.front());
+			queue.nodes.pop_front();
+			queue.idle_threads = --queue.num_idle;
+		}
+
+		search.AddNodes(subtree, empty);
+		while (!search.Run(donation_check_interval_c)) {
+			report_nodes();
+			// the open nodes are left for the result's lower bound
+			if (IsCancelled(options)) { break; }
+			if (queue.idle_threads.load() > 0 &&
+					search.GetNumOpenNodes() > 1) {
+				unique_lock<mutex> lock{queue.queue_mutex};
+				queue.nodes.push_back(search.TakeShallowestNode());
+				queue.changed.notify_one();
+				++donations;
+			}
+		}
+		report_nodes();
+	}
+
+	result.shortest = search.GetShortest();
+	search.RecordStatistics(result.statistics);
+	branching_rule->RecordStatistics(result.statistics);
+	result.statistics.Set("subtrees_donated", donations);
+}
+
+bool IsCancelled(const SolverOptions& options)
+{ return options.cancellation && options.cancellation->IsCancelled(); }
@@ -0,0 +1,17 @@
+#ifndef TSP_SOLVER_LITTLE_THREADS_H
+#define TSP_SOLVER_LITTLE_THREADS_H
+
+class Graph;
+class Statistics;
+struct Path;
+struct SolverOptions;
+
+// Searches the tree of Little's algorithm with options.threads threads, for
+// programs that embed the solver and can't fork. The tree is split the same way
+// as with processes, but subtrees are passed through a queue guarded by a mutex
+// and the upper bound is a plain atomic. Checkpoints are not written in this
+// mode.
+Path SolveWithThreads(const Graph& graph, const SolverOptions& options,
+		int upper_bound, Statistics& statistics);
+
+#endif  // TSP_SOLVER_LITTLE_THREADS_H
@@ -0,0 +1,329 @@
+#include "tsp_solver/little/trace.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "graph/edge.hpp"
+#include "util.hpp"
+
+using std::chrono::duration_cast;
+using std::chrono::nanoseconds;
+using std::chrono::steady_clock;
+using std::endl;
+using std::int32_t;
+using std::istream;
+using std::max;
+using std::numeric_limits;
+using std::ofstream;
+using std::ostream;
+using std::set;
+using std::string;
+using std::uint32_t;
+using std::unordered_map;
+using std::vector;
+
+const int32_t trace_magic_c{0x4C545452};  // "LTTR"
+const int32_t trace_version_c{1};
+const int ints_per_event_c{13};
+// events are buffered and written this many bytes at a time
+const size_t trace_buffer_size_c{1 << 16};
+
+static void AppendInt(vector<char>& buffer, int32_t value);
+static void AppendLong(vector<char>& buffer, long long value);
+// returns false if the stream ended before the integer began
+static bool ReadInt(istream& is, int32_t& value);
+static int32_t ReadInt(istream& is);
+static long long ReadLong(istream& is);
+
+TraceWriter::TraceWriter(const string& file_name, int num_vertices,
+		int sample, long long limit) :
+		file_{file_name, ofstream::binary | ofstream::trunc},
+		sample_{sample}, limit_{limit}, num_nodes_{0}, written_{0},
+		dropped_{0}, start_{steady_clock::now()} {
+	if (!file_) { throw Error{"Could not open trace file!"}; }
+	if (sample_ < 1) { throw Error{"Trace sample must be positive!"}; }
+	buffer_.reserve(trace_buffer_size_c);
+	AppendInt(buffer_, trace_magic_c);
+	AppendInt(buffer_, trace_version_c);
+	AppendInt(buffer_, num_vertices);
+	AppendInt(buffer_, sample_);
+}
+
+TraceWriter::~TraceWriter() {
+	TraceEvent end;
+	end.node = dropped_;
+	end.time = Now();
+	// the end is written past the limit, so a trace always has one
+	limit_ = written_ + 1;
+	Write(end);
+	file_.write(buffer_.data(), buffer_.size());
+	file_.flush();
+	if (!file_) { std::cerr << "Could not write the trace" << endl; }
+}
+
+long long TraceWriter::Now() const
+{ return duration_cast<nanoseconds>(steady_clock::now() - start_).count(); }
+
+void TraceWriter::NodeCreated(long long node, long long parent,
+		TraceBranch branch, const Edge& edge, int num_included) {
+	if (!IsSampled(node)) { return; }
+	TraceEvent event;
+	event.type = kTraceCreate;
+	event.detail = branch;
+	event.node = node;
+	event.parent = parent;
+	event.time = Now();
+	event.value = num_included;
+	event.edge = edge;
+	Write(event);
+}
+
+void TraceWriter::NodeEvaluated(long long node, long long start,
+		int lower_bound, const Edge& next_edge) {
+	if (!IsSampled(node)) { return; }
+	TraceEvent event;
+	event.type = kTraceEvaluate;
+	event.node = node;
+	event.time = start;
+	event.duration = Now() - start;
+	event.value = lower_bound;
+	event.edge = next_edge;
+	Write(event);
+}
+
+void TraceWriter::NodePruned(long long node, TracePruneReason reason,
+		int lower_bound) {
+	if (!IsSampled(node)) { return; }
+	TraceEvent event;
+	event.type = kTracePrune;
+	event.detail = reason;
+	event.node = node;
+	event.time = Now();
+	event.value = lower_bound;
+	Write(event);
+}
+
+void TraceWriter::IncumbentFound(long long node, TraceIncumbentSource source,
+		int length) {
+	// there are few enough of these to keep them all
+	TraceEvent event;
+	event.type = kTraceIncumbent;
+	event.detail = source;
+	event.node = node;
+	event.time = Now();
+	event.value = length;
+	Write(event);
+}
+
+void TraceWriter::Write(const TraceEvent& event) {
+	if (written_ >= limit_) {
+		++dropped_;
+		return;
+	}
+	++written_;
+	AppendInt(buffer_, event.type);
+	AppendInt(buffer_, event.detail);
+	AppendLong(buffer_, event.node);
+	AppendLong(buffer_, event.parent);
+	AppendLong(buffer_, event.time);
+	AppendLong(buffer_, event.duration);
+	AppendInt(buffer_, event.value);
+	AppendInt(buffer_, event.edge.u);
+	AppendInt(buffer_, event.edge.v);
+	if (buffer_.size() + ints_per_event_c * sizeof(int32_t) >
+			trace_buffer_size_c) {
+		file_.write(buffer_.data(), buffer_.size());
+		buffer_.clear();
+	}
+}
+
+Trace ReadTrace(istream& is) {
+	int32_t magic{0};
+	if (!ReadInt(is, magic) || magic != trace_magic_c)
+	{ throw Error{"Not a trace!"}; }
+	if (ReadInt(is) != trace_version_c)
+	{ throw Error{"Unsupported trace version!"}; }
+
+	Trace trace;
+	trace.num_vertices = ReadInt(is);
+	trace.sample = ReadInt(is);
+	// a search that was killed leaves a trace without an end, which is still
+	// worth reading
+	int32_t type{0};
+	while (ReadInt(is, type)) {
+		TraceEvent event;
+		event.type = type;
+		event.detail = ReadInt(is);
+		event.node = ReadLong(is);
+		event.parent = ReadLong(is);
+		event.time = ReadLong(is);
+		event.duration = ReadLong(is);
+		event.value = ReadInt(is);
+		event.edge.u = ReadInt(is);
+		event.edge.v = ReadInt(is);
+		if (event.type == kTraceEnd) {
+			trace.dropped = event.node;
+			break;
+		}
+		if (event.type < kTraceCreate || event.type > kTraceEnd)
+		{ throw Error{"Trace has an unknown event!"}; }
+		trace.events.push_back(event);
+	}
+	return trace;
+}
+
+namespace {
+
+const char* const branch_names_c[]{"root", "include", "exclude", "resumed"};
+const char* const prune_names_c[]{"bound", "stale", "no_tour", "leaf"};
+const char* const source_names_c[]{"initial", "leaf", "dive", "shared"};
+
+template <size_t size>
+const char* Name(const char* const (&names)[size], int index)
+{ return index >= 0 && size_t(index) < size ? names[index] : "unknown"; }
+
+// the parts every event of a node shares, the track is its number of edges
+// included
+void WriteEventStart(ostream& os, const char* name, const char* phase,
+		int track, long long time) {
+	os << ",\n{\"name\":\"" << name << "\",\"ph\":\"" << phase
+		<< "\",\"pid\":1,\"tid\":" << track << ",\"ts\":" << time / 1e3;
+}
+
+void WriteEdge(ostream& os, const Edge& edge)
+{ os << ",\"edge\":[" << edge.u << "," << edge.v << "]"; }
+
+// infinite bounds are written as null, since JSON has no infinity
+void WriteBound(ostream& os, int bound) {
+	if (bound == numeric_limits<int>::max()) { os << "null"; }
+	else { os << bound; }
+}
+
+}  // namespace
+
+void WriteChromeTrace(ostream& os, const Trace& trace) {
+	// nodes are made before they are evaluated or pruned, and all the events
+	// of a sampled node are written, so every node's track is known
+	unordered_map<long long, int> tracks;
+	set<int> used_tracks;
+	for (const TraceEvent& event : trace.events) {
+		if (event.type != kTraceCreate) { continue; }
+		tracks[event.node] = event.value;
+		used_tracks.insert(event.value);
+	}
+	auto track_of = [&tracks](long long node) {
+		auto it = tracks.find(node);
+		return it == tracks.end() ? 0 : it->second;
+	};
+
+	const std::ios::fmtflags flags{os.flags()};
+	const std::streamsize precision{os.precision()};
+	os << std::fixed << std::setprecision(3);
+
+	os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n"
+		<< "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":"
+		<< "{\"name\":\"Little's algorithm, " << trace.num_vertices
+		<< " vertices, 1 in " << trace.sample << " nodes traced\"}}";
+	for (int track : used_tracks) {
+		os << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+			<< track << ",\"args\":{\"name\":\"" << track
+			<< " edges included\"}}"
+			<< ",\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,"
+			<< "\"tid\":" << track << ",\"args\":{\"sort_index\":" << track
+			<< "}}";
+	}
+
+	long long last_time{0};
+	for (const TraceEvent& event : trace.events) {
+		last_time = max(last_time, event.time + event.duration);
+		const int track{track_of(event.node)};
+		switch (event.type) {
+		case kTraceCreate:
+			WriteEventStart(os, Name(branch_names_c, event.detail), "i",
+					track, event.time);
+			os << ",\"s\":\"t\",\"args\":{\"node\":" << event.node
+				<< ",\"parent\":" << event.parent;
+			WriteEdge(os, event.edge);
+			os << "}}";
+			break;
+		case kTraceEvaluate:
+			WriteEventStart(os, "evaluate", "X", track, event.time);
+			os << ",\"dur\":" << event.duration / 1e3 << ",\"args\":{\"node\":"
+				<< event.node << ",\"lower_bound\":";
+			WriteBound(os, event.value);
+			WriteEdge(os, event.edge);
+			os << "}}";
+			break;
+		case kTracePrune:
+			WriteEventStart(os, "prune", "i", track, event.time);
+			os << ",\"s\":\"t\",\"args\":{\"node\":" << event.node
+				<< ",\"reason\":\"" << Name(prune_names_c, event.detail)
+				<< "\",\"lower_bound\":";
+			WriteBound(os, event.value);
+			os << "}}";
+			break;
+		case kTraceIncumbent:
+			WriteEventStart(os, "shortest", "C", 0, event.time);
+			os << ",\"args\":{\"length\":";
+			WriteBound(os, event.value);
+			os << "}}";
+			WriteEventStart(os, "incumbent", "i", 0, event.time);
+			os << ",\"s\":\"p\",\"args\":{\"node\":" << event.node
+				<< ",\"source\":\"" << Name(source_names_c, event.detail)
+				<< "\",\"length\":";
+			WriteBound(os, event.value);
+			os << "}}";
+			break;
+		}
+	}
+	if (trace.dropped) {
+		WriteEventStart(os, "trace limit reached", "i", 0, last_time);
+		os << ",\"s\":\"g\",\"args\":{\"dropped\":" << trace.dropped << "}}";
+	}
+	os << "\n]}" << endl;
+
+	os.flags(flags);
+	os.precision(precision);
+}
+
+void AppendInt(vector<char>& buffer, int32_t value) {
+	char bytes[sizeof(value)];
+	std::memcpy(bytes, &value, sizeof(value));
+	buffer.insert(buffer.end(), bytes, bytes + sizeof(value));
+}
+
+// the high half first, as checkpoints write counters
+void AppendLong(vector<char>& buffer, long long value) {
+	AppendInt(buffer, int32_t(value >> 32));
+	AppendInt(buffer, int32_t(value & 0xFFFFFFFF));
+}
+
+bool ReadInt(istream& is, int32_t& value) {
+	is.read(reinterpret_cast<char*>(&value), sizeof(value));
+	if (is.gcount() == 0) { return false; }
+	if (!is) { throw Error{"Trace is truncated!"}; }
+	return true;
+}
+
+int32_t ReadInt(istream& is) {
+	int32_t value{0};
+	if (!ReadInt(is, value)) { throw Error{"Trace is truncated!"}; }
+	return value;
+}
+
+long long ReadLong(istream& is) {
+	const long long high{ReadInt(is)};
+	const long long low{uint32_t(ReadInt(is))};
+	return high * (1LL << 32) + low;
+}
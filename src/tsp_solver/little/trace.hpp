@@ -0,0 +1,123 @@
+#ifndef TSP_SOLVER_LITTLE_TRACE_H
+#define TSP_SOLVER_LITTLE_TRACE_H
+
+#include <chrono>
+#include <fstream>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "graph/edge.hpp"
+
+enum TraceEventType {
+	kTraceCreate,  // a node was made, value is the number of edges it includes
+	kTraceEvaluate,  // a node's lower bound (value) and next edge were found
+	kTracePrune,  // a node was dropped, value is its lower bound
+	kTraceIncumbent,  // a shorter tour was found, value is its length
+	kTraceEnd  // the search finished, node is the number of events dropped
+};
+
+// how a node was made, the detail of kTraceCreate
+enum TraceBranch {
+	kTraceRoot,
+	kTraceInclude,
+	kTraceExclude,
+	kTraceResumed  // rebuilt from a checkpoint, so its parent isn't known
+};
+
+// why a node was dropped, the detail of kTracePrune
+enum TracePruneReason {
+	kPruneBound,  // its lower bound reached the prune bound when evaluated
+	kPruneStale,  // the prune bound dropped to its bound while it was open
+	kPruneNoTour,  // an exact leaf with no tour under the prune bound
+	kPruneLeaf  // a complete tour no shorter than the shortest one
+};
+
+// where a shorter tour came from, the detail of kTraceIncumbent
+enum TraceIncumbentSource {
+	kIncumbentInitial,  // the upper bound passed in, or a resumed checkpoint's
+	kIncumbentLeaf,  // a node's complete tour
+	kIncumbentDive,  // a greedy completion of a node
+	kIncumbentShared  // another search's tour
+};
+
+// One thing that happened in a search. Nodes are numbered from 1 in the order
+// they were made, 0 standing for no node.
+struct TraceEvent {
+	int type{kTraceEnd};
+	int detail{0};
+	long long node{0};
+	long long parent{0};  // for kTraceCreate
+	// nanoseconds since the search started
+	long long time{0};
+	long long duration{0};  // for kTraceEvaluate
+	int value{0};
+	// the edge a kTraceCreate node branched on, or a kTraceEvaluate node's
+	// next edge, (-1, -1) if it has none
+	Edge edge;
+};
+
+struct Trace {
+	int num_vertices{0};
+	int sample{1};
+	// events past the limit, which weren't written
+	long long dropped{0};
+	std::vector<TraceEvent> events;
+};
+
+/* Writes the events of a search of Little's algorithm to a file, to see how
+ * its bounds and branching choices played out. Traces are binary: a magic
+ * number, version, the number of vertices and the sample, then each event as
+ * 32-bit integers in the host's byte order, ending with a kTraceEnd event.
+ *
+ * To keep traces of large searches affordable, only the events of every
+ * sample-th node are written, though every shorter tour is, and once limit
+ * events have been written the rest are only counted.
+ */
+class TraceWriter {
+public:
+	TraceWriter(const std::string& file_name, int num_vertices, int sample,
+			long long limit);
+	// writes the kTraceEnd event
+	~TraceWriter();
+
+	TraceWriter(const TraceWriter&) = delete;
+	TraceWriter& operator=(const TraceWriter&) = delete;
+
+	// number the next node
+	long long NewNode() { return ++num_nodes_; }
+	// nanoseconds since the trace started
+	long long Now() const;
+
+	void NodeCreated(long long node, long long parent, TraceBranch branch,
+			const Edge& edge, int num_included);
+	void NodeEvaluated(long long node, long long start, int lower_bound,
+			const Edge& next_edge);
+	void NodePruned(long long node, TracePruneReason reason, int lower_bound);
+	void IncumbentFound(long long node, TraceIncumbentSource source,
+			int length);
+
+private:
+	bool IsSampled(long long node) const { return node % sample_ == 0; }
+	void Write(const TraceEvent& event);
+
+	std::ofstream file_;
+	int sample_;
+	long long limit_;
+	long long num_nodes_;
+	long long written_;
+	long long dropped_;
+	std::chrono::steady_clock::time_point start_;
+	std::vector<char> buffer_;
+};
+
+// throws Error if the stream doesn't hold a trace
+Trace ReadTrace(std::istream& is);
+
+// Writes the trace in the Chrome trace event format, which Perfetto and
+// chrome://tracing open. Evaluations are slices on one track per number of
+// edges included, creations and prunes are instant events on them, and the
+// length of the shortest tour is a counter.
+void WriteChromeTrace(std::ostream& os, const Trace& trace);
+
+#endif  // TSP_SOLVER_LITTLE_TRACE_H
@@ -0,0 +1,148 @@
+#include "tsp_solver/little/trace.hpp"
+
+#include <cstdio>
+
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "graph/graph.hpp"
+#include "path.hpp"
+#include "test_util.hpp"
+#include "tsp_solver/little/solver.hpp"
+#include "tsp_solver/options.hpp"
+#include "util.hpp"
+
+#include "gtest/gtest.h"
+
+using std::ifstream;
+using std::istringstream;
+using std::map;
+using std::ostringstream;
+using std::string;
+using std::unique_ptr;
+
+const char trace_file_c[]{"trace_test.trace"};
+
+static Trace LoadTrace() {
+	ifstream file{trace_file_c, ifstream::binary};
+	Trace trace{ReadTrace(file)};
+	std::remove(trace_file_c);
+	return trace;
+}
+
+TEST(TraceTest, RoundTrip) {
+	{
+		TraceWriter writer{trace_file_c, 5, 1, 100};
+		const long long root{writer.NewNode()};
+		writer.NodeCreated(root, 0, kTraceRoot, Edge{}, 0);
+		writer.NodeEvaluated(root, writer.Now(), 42, Edge{3, 1});
+		const long long child{writer.NewNode()};
+		writer.NodeCreated(child, root, kTraceInclude, Edge{3, 1}, 1);
+		writer.NodePruned(child, kPruneBound, 5000000);
+		writer.IncumbentFound(child, kIncumbentDive, 57);
+	}
+	const Trace trace{LoadTrace()};
+	EXPECT_EQ(5, trace.num_vertices);
+	EXPECT_EQ(1, trace.sample);
+	EXPECT_EQ(0, trace.dropped);
+	ASSERT_EQ(5u, trace.events.size());
+
+	const TraceEvent& evaluate{trace.events[1]};
+	EXPECT_EQ(kTraceEvaluate, evaluate.type);
+	EXPECT_EQ(1, evaluate.node);
+	EXPECT_EQ(42, evaluate.value);
+	EXPECT_EQ(Edge(3, 1), evaluate.edge);
+	EXPECT_GE(evaluate.duration, 0);
+
+	const TraceEvent& create{trace.events[2]};
+	EXPECT_EQ(kTraceCreate, create.type);
+	EXPECT_EQ(kTraceInclude, create.detail);
+	EXPECT_EQ(2, create.node);
+	EXPECT_EQ(1, create.parent);
+	EXPECT_EQ(1, create.value);
+	EXPECT_EQ(kPruneBound, trace.events[3].detail);
+	EXPECT_EQ(kIncumbentDive, trace.events[4].detail);
+	EXPECT_EQ(57, trace.events[4].value);
+	for (int i{1}; i < 5; ++i)
+	{ EXPECT_LE(trace.events[i - 1].time, trace.events[i].time); }
+}
+
+TEST(TraceTest, SampleAndLimit) {
+	{
+		TraceWriter writer{trace_file_c, 5, 3, 4};
+		for (int i{0}; i < 9; ++i) {
+			const long long node{writer.NewNode()};
+			writer.NodeCreated(node, 0, kTraceResumed, Edge{}, 0);
+			writer.NodePruned(node, kPruneStale, 10);
+		}
+		writer.IncumbentFound(0, kIncumbentShared, 30);
+	}
+	const Trace trace{LoadTrace()};
+	// nodes 3 and 6 fill the trace, so node 9 and the tour are dropped
+	ASSERT_EQ(4u, trace.events.size());
+	EXPECT_EQ(3, trace.events[0].node);
+	EXPECT_EQ(6, trace.events[3].node);
+	EXPECT_EQ(3, trace.dropped);
+}
+
+TEST(TraceTest, BadInput) {
+	istringstream not_trace{"this is not a trace"};
+	EXPECT_THROW(ReadTrace(not_trace), Error);
+
+	{
+		TraceWriter writer{trace_file_c, 5, 1, 100};
+		writer.IncumbentFound(0, kIncumbentInitial, 30);
+	}
+	ifstream file{trace_file_c, ifstream::binary};
+	string truncated{std::istreambuf_iterator<char>{file}, {}};
+	std::remove(trace_file_c);
+	truncated.resize(truncated.size() - 3);
+	istringstream truncated_stream{truncated};
+	EXPECT_THROW(ReadTrace(truncated_stream), Error);
+}
+
+TEST(TraceTest, Search) {
+	unique_ptr<Graph> graph{MakeRandomGraph(9, 100, 12)};
+
+	SolverOptions options;
+	options.trace_file = trace_file_c;
+	// leave the branching to the tree
+	options.exact_leaf_size = 0;
+	options.dive_frequency = 0;
+	const Path tour{LittleTSPSolver{options}.Solve(*graph)};
+	const Trace trace{LoadTrace()};
+
+	// every node is made before it is evaluated or pruned, and its children
+	// branch on the edge it chose
+	map<long long, Edge> next_edges;
+	int last_length{-1};
+	for (const TraceEvent& event : trace.events) {
+		switch (event.type) {
+		case kTraceCreate:
+			if (event.detail == kTraceRoot) {
+				EXPECT_EQ(0, event.parent);
+				break;
+			}
+			ASSERT_TRUE(next_edges.count(event.parent));
+			EXPECT_EQ(next_edges[event.parent], event.edge);
+			next_edges[event.node] = Edge{};
+			break;
+		case kTraceEvaluate:
+			ASSERT_TRUE(event.node == 1 || next_edges.count(event.node));
+			next_edges[event.node] = event.edge;
+			break;
+		case kTraceIncumbent:
+			last_length = event.value;
+			break;
+		}
+	}
+	EXPECT_EQ(tour.length, last_length);
+
+	ostringstream json;
+	WriteChromeTrace(json, trace);
+	EXPECT_NE(string::npos, json.str().find("\"name\":\"evaluate\""));
+	EXPECT_EQ('}', json.str()[json.str().size() - 2]);
+}
@@ -7,6 +7,7 @@
 #include <iostream>
 #include <iterator>
 #include <limits>
+#include <numeric>
 #include <utility>
 
 #include "graph/edge.hpp"
@@ -14,7 +15,11 @@
 #include "graph/graph.hpp"
 #include "matrix.hpp"
 #include "path.hpp"
+#include "profile.hpp"
+#include "tsp_solver/little/branching_rule.hpp"
 #include "tsp_solver/little/cost_matrix.hpp"
+#include "tsp_solver/little/exact_leaf.hpp"
+#include "tsp_solver/little/fragments.hpp"
 #include "util.hpp"
 
 using namespace std::rel_ops;
@@ -22,13 +27,15 @@ using namespace std::rel_ops;
 using std::begin;
 using std::deque;
 using std::end;
+using std::find;
 using std::for_each;
 using std::pair;
 using std::make_pair;
-using std::max;
 using std::max_element;
 using std::numeric_limits;
 using std::ostream;
+using std::rotate;
+using std::stable_sort;
 using std::vector;
 
 using cmi_pair_t = pair<EdgeCost, EdgeCost>;
@@ -36,26 +43,38 @@ using two_smallest_t = vector<cmi_pair_t>;
 
 const int infinity{numeric_limits<int>::max()};
 
+// nodes created without a branching rule use Little's, which has no state
+static PenaltyBranchingRule penalty_branching_rule;
+
 static void UpdateTwoSmallest(const EdgeCost& current,
 		pair<EdgeCost, EdgeCost>& two_smallest);
 static EdgeCost GetPenalty(const Edge& edge,
 		const cmi_pair_t& penalties);
-static vector<CostMatrixZero> FindZerosAndPenalties(
-		const CostMatrix& cost_matrix);
 static vector<CostMatrixZero> FindBaseCaseZerosAndPenalties(
 		const vector<Edge>& zero_edges,
 		const two_smallest_t& two_smallest_row,
 		const two_smallest_t& two_smallest_column);
 
-TreeNode::TreeNode(const Graph& costs) : graph_ptr_{&costs},
+TreeNode::TreeNode(const Graph& costs) : TreeNode{costs, 0} {}
+
+TreeNode::TreeNode(const Graph& costs, int exact_leaf_size) :
+		TreeNode{costs, exact_leaf_size, nullptr} {}
+
+TreeNode::TreeNode(const Graph& costs, int exact_leaf_size,
+		BranchingRule* branching_rule) : graph_ptr_{&costs},
 		exclude_{costs.GetNumVertices(), costs.GetNumVertices(), 0},
-		next_edge_{-1, -1}, has_exclude_branch_{false}, lower_bound_{infinity} {
+		next_edge_{-1, -1}, has_exclude_branch_{false}, lower_bound_{infinity},
+		exact_leaf_size_{exact_leaf_size},
+		branching_rule_{branching_rule ? branching_rule :
+			&penalty_branching_rule}, trace_id_{0} {
+	assert(exact_leaf_size_ <= max_exact_leaf_size);
 	// exclude all cells along the diagonal, we don't want self-loops
 	for (int diag{0}; diag < graph_ptr_->GetNumVertices(); ++diag)
-	{ AddExclude(Edge{diag, diag}); }
+	{ exclude_(diag, diag) = 1; }
 }
 
 TreeNode TreeNode::MakeIncludeChild(const TreeNode& parent) {
+	PROFILE_SCOPE(kMakeChild);
 	TreeNode child{parent};
 	child.AddInclude(parent.GetNextEdge());
 	child.ResetCalculatedState();
@@ -63,6 +82,7 @@ TreeNode TreeNode::MakeIncludeChild(const TreeNode& parent) {
 }
 
 TreeNode TreeNode::MakeExcludeChild(const TreeNode& parent) {
+	PROFILE_SCOPE(kMakeChild);
 	TreeNode child{parent};
 	child.AddExclude(parent.GetNextEdge());
 	child.ResetCalculatedState();
@@ -99,12 +119,25 @@ void TreeNode::AddInclude(const Edge& e) {
 	include_.push_back(e);
 
 	// make the ends of the longest subtour infinite
-	AddExclude(Edge{subtour.back(), subtour.front()});
+	exclude_(subtour.back(), subtour.front()) = 1;
+}
+
+void TreeNode::AddExclude(const Edge& e) {
+	exclude_(e.u, e.v) = 1;
+	branch_excludes_.push_back(e);
+}
+
+void TreeNode::AddExcludes(const Matrix<int>& exclude) {
+	for (int row{0}; row < exclude_.GetNumRows(); ++row) {
+		for (int column{0}; column < exclude_.GetNumColumns(); ++column)
+		{ exclude_(row, column) |= exclude(row, column); }
+	}
 }
 
 // build the TSP path once it exists
 // this method will infinite loop if there is not a full path
 Path TreeNode::GetTSPPath() const {
+	PROFILE_SCOPE(kExtractPath);
 	// bucket sort the edges and then find the path through them
 	vector<Edge> edges{include_};
 	for_each(begin(include_), end(include_),
@@ -127,6 +160,49 @@ Path TreeNode::GetTSPPath() const {
 	return solution;
 }
 
+Path TreeNode::CompleteGreedily() const {
+	// the reduction may be infinite, the partial reductions still order costs
+	CostMatrix cost_matrix{*graph_ptr_, include_, exclude_};
+	cost_matrix.ReduceMatrix();
+
+	Fragments fragments{graph_ptr_->GetNumVertices(), include_};
+	vector<bool> used(fragments.Size(), false);
+	Path tour;
+
+	int current{0};
+	while (current != -1) {
+		used[current] = true;
+		for (int vertex{fragments.heads[current]}; vertex != -1;
+				vertex = fragments.next[vertex])
+		{ tour.vertices.push_back(vertex); }
+
+		// find the cheapest fragment to go to next, breaking ties between
+		// reduced costs with the actual cost
+		int tail{fragments.tails[current]};
+		current = -1;
+		EdgeCost best_reduced{EdgeCost::Infinite()};
+		int best_actual{infinity};
+		for (int next{0}; next < fragments.Size(); ++next) {
+			if (used[next]) { continue; }
+			EdgeCost reduced{cost_matrix(tail, fragments.heads[next])};
+			int actual{(*graph_ptr_)(tail, fragments.heads[next])()};
+			if (current == -1 || reduced < best_reduced ||
+					(!(best_reduced < reduced) && actual < best_actual)) {
+				current = next;
+				best_reduced = reduced;
+				best_actual = actual;
+			}
+		}
+	}
+
+	// paths start at vertex 0
+	rotate(begin(tour.vertices),
+			find(begin(tour.vertices), end(tour.vertices), 0),
+			end(tour.vertices));
+	tour.length = CalculatePathLength(*graph_ptr_, tour.vertices);
+	return tour;
+}
+
 int TreeNode::CalculateLowerBound() const {
 	return accumulate(begin(include_), end(include_), 0,
 			[this](int current_lb, Edge e)
@@ -145,14 +221,10 @@ ostream& operator<<(ostream& os, const TreeNode& p) {
 	return os;
 }
 
-struct CostMatrixZero {
-	Edge edge;
-	int penalty;
-	bool operator<(const CostMatrixZero& other) const
-	{ return penalty < other.penalty; }
-};
+bool TreeNode::CalcLBAndNextEdge() { return CalcLBAndNextEdge(infinity); }
 
-bool TreeNode::CalcLBAndNextEdge() {
+bool TreeNode::CalcLBAndNextEdge(int upper_bound) {
+	PROFILE_SCOPE(kEvaluateNode);
 	// create a cost matrix from information stored in the tree node, reduce it
 	// use current edges and reduced cost matrix to calculate lower bound
 	CostMatrix cost_matrix{*graph_ptr_, include_, exclude_};
@@ -160,21 +232,45 @@ bool TreeNode::CalcLBAndNextEdge() {
 	if (lower_bound_ == infinity) { return false; }
 	lower_bound_ += CalculateLowerBound();
 
-	// find all the zeros in the matrix and copy them into the zeros vector
-	vector<CostMatrixZero> zeros{FindZerosAndPenalties(cost_matrix)};
+	// small enough subproblems are finished in one go rather than branched on
+	// all the way down to the base case, unless the node will be pruned anyway
+	if (cost_matrix.GetCondensedSize() <= exact_leaf_size_ &&
+			lower_bound_ < upper_bound)
+	{ return HandleExactLeaf(cost_matrix, upper_bound); }
+
+	// find the zeros the branching rule chooses among
+	vector<CostMatrixZero> zeros{FindZerosAndPenalties(cost_matrix,
+			branching_rule_->GetNumCandidates())};
 
 	// handle base case in a separate function
 	if (cost_matrix.GetCondensedSize() == 2)
 	{ return HandleBaseCase(zeros); }
 
-	// for any other case, set the next edge as the zero with the highest
-	// penalty and allow an exclude branch if the penalty is not infinite
-	assert(zeros.size() == 1);
-	next_edge_ = zeros[0].edge;
-	has_exclude_branch_ = zeros[0].penalty != infinity;
+	// a zero with an infinite penalty must be included, otherwise the
+	// branching rule picks the zero to branch on
+	assert(!zeros.empty());
+	if (zeros[0].penalty == infinity) {
+		assert(zeros.size() == 1);
+		next_edge_ = zeros[0].edge;
+		has_exclude_branch_ = false;
+	} else {
+		next_edge_ = branching_rule_->ChooseEdge(*this, zeros);
+		has_exclude_branch_ = true;
+	}
 	return true;
 }
 
+int TreeNode::CalcChildLowerBound(const Edge& e, bool include) const {
+	TreeNode child{*this};
+	if (include) { child.AddInclude(e); }
+	else { child.AddExclude(e); }
+
+	CostMatrix cost_matrix{*graph_ptr_, child.include_, child.exclude_};
+	int reduction{cost_matrix.ReduceMatrix()};
+	if (reduction == infinity) { return infinity; }
+	return reduction + child.CalculateLowerBound();
+}
+
 bool TreeNode::HandleBaseCase(const vector<CostMatrixZero>& zeros) {
 	// find the edge with the largest penalty, remove it from zeros
 	auto max_penalty_it = max_element(begin(zeros), end(zeros));
@@ -194,11 +290,34 @@ bool TreeNode::HandleBaseCase(const vector<CostMatrixZero>& zeros) {
 	return false;  // no next edge, we have a complete tour
 }
 
-// Finds the zero with the highest "penalty" for exclusion.
+bool TreeNode::HandleExactLeaf(const CostMatrix& cost_matrix,
+		int upper_bound) {
+	// any completion costs the lower bound plus its reduced cost
+	vector<Edge> completion{SolveResidualTour(
+			cost_matrix, include_, upper_bound - lower_bound_)};
+	if (completion.empty()) {
+		lower_bound_ = infinity;
+		return false;  // no better tour can be made from this node
+	}
+
+	// the completion closes every fragment, so it can't create a subtour and
+	// there is no need to go through AddInclude
+	include_.insert(end(include_), begin(completion), end(completion));
+
+	// recalculate LB, i.e. the length of the TSP tour
+	lower_bound_ = CalculateLowerBound();
+
+	return false;  // no next edge, we have a complete tour
+}
+
+// Finds the zeros and their "penalty" for exclusion, sorted by decreasing
+// penalty.
 // The penalty of any zero is defined as the amount the lower bound would
 // increase if the zero were excluded from the TSP path
-// Note: only returns more than one zero in the base case
-vector<CostMatrixZero> FindZerosAndPenalties(const CostMatrix& cost_matrix) {
+// Note: if a zero has an infinite penalty outside the base case, only that zero
+// is returned
+vector<CostMatrixZero> FindZerosAndPenalties(const CostMatrix& cost_matrix,
+		int max_zeros) {
 	// hold the two smallest elements in each row and column
 	cmi_pair_t infinite_cmis{make_pair(EdgeCost::Infinite(),
 		EdgeCost::Infinite())};
@@ -227,9 +346,7 @@ vector<CostMatrixZero> FindZerosAndPenalties(const CostMatrix& cost_matrix) {
 				zero_edges, two_smallest_row, two_smallest_column);
 	}
 
-	// hold a dummy value for max now that will be replaced on first iteration
 	vector<CostMatrixZero> cost_matrix_zeros;
-	cost_matrix_zeros.push_back(CostMatrixZero{Edge{-1, -1}, -1});
 
 	for (const Edge& edge : zero_edges) {
 		// get the row and column penalties
@@ -245,10 +362,21 @@ vector<CostMatrixZero> FindZerosAndPenalties(const CostMatrix& cost_matrix) {
 		{ return { CostMatrixZero{edge, infinity} }; }
 
 		// 3. normal case, there is both an include and exclude branch
-		// keep only the structure with the maximum penalty
-		CostMatrixZero current_zero{edge, row_penalty() + column_penalty()};
-		cost_matrix_zeros[0] = max(cost_matrix_zeros[0], current_zero);
+		cost_matrix_zeros.push_back(
+				CostMatrixZero{edge, row_penalty() + column_penalty()});
 	}
+
+	// Little's rule only needs the highest penalty, which is found without
+	// sorting, and max_element keeps the first of any ties
+	if (max_zeros == 1 && !cost_matrix_zeros.empty())
+	{ return {*max_element(begin(cost_matrix_zeros), end(cost_matrix_zeros))}; }
+
+	// highest penalty first, ties keep the order the zeros were found in
+	stable_sort(begin(cost_matrix_zeros), end(cost_matrix_zeros),
+			[](const CostMatrixZero& first, const CostMatrixZero& second)
+			{ return second < first; });
+	if (max_zeros >= 0 && max_zeros < int(cost_matrix_zeros.size()))
+	{ cost_matrix_zeros.resize(max_zeros); }
 	return cost_matrix_zeros;
 }
 
@@ -7,6 +7,7 @@
 #include "graph/edge.hpp"
 #include "matrix.hpp"
 
+class BranchingRule;
 class CostMatrix;
 struct CostMatrixZero;
 class Graph;
@@ -16,6 +17,13 @@ class TreeNode {
 public:
 	// some constructors
 	explicit TreeNode(const Graph& costs);
+	// nodes with at most exact_leaf_size rows left are solved exactly instead
+	// of being branched on further, 0 turns this off
+	TreeNode(const Graph& costs, int exact_leaf_size);
+	// the branching rule chooses the edge to branch on, it is shared by all of
+	// the node's descendants, nullptr uses Little's original penalty rule
+	TreeNode(const Graph& costs, int exact_leaf_size,
+			BranchingRule* branching_rule);
 
 	// create children for the include and exclude branches given the parent
 	static TreeNode MakeIncludeChild(const TreeNode& parent);
@@ -24,19 +32,46 @@ public:
 	// Important methods
 	// add included and excluded vertices
 	void AddInclude(const Edge& e);
-	void AddExclude(const Edge& e) { exclude_(e.u, e.v) = 1; }
+	void AddExclude(const Edge& e);
+	// exclude every edge set in the given matrix as well, these are expected to
+	// be eliminated edges, so they aren't among GetBranchExcludes()
+	void AddExcludes(const Matrix<int>& exclude);
 
 	int GetLowerBound() const { return lower_bound_; }
+	const std::vector<Edge>& GetIncludes() const { return include_; }
+	const Matrix<int>& GetExcludes() const { return exclude_; }
+	// the edges passed to AddExclude, the rest of GetExcludes() follows from
+	// the included edges, so these and the includes are enough to rebuild the
+	// node
+	const std::vector<Edge>& GetBranchExcludes() const
+	{ return branch_excludes_; }
 	Path GetTSPPath() const;
 
+	// Greedily finish a tour from the included edges by always leaving the
+	// current fragment along the cheapest reduced cost, so zeros are taken
+	// first. Excluded edges are only used once nothing else is left, so this
+	// always gives a tour, though not necessarily one in this node's subtree.
+	Path CompleteGreedily() const;
+
 	// branching methods
 	bool HasExcludeBranch() const { return has_exclude_branch_; }
 	Edge GetNextEdge() const { return next_edge_; }
 
+	// numbers the node in a trace of its search, 0 if the search isn't traced
+	long long GetTraceId() const { return trace_id_; }
+	void SetTraceId(long long trace_id) { trace_id_ = trace_id; }
+
 	// calculate the lower bound and the next edge
 	// if true is returned, next_edge_ holds the next edge for the tree
 	// has_exclude_branch_ tells whether the tree can branch to the left
 	bool CalcLBAndNextEdge();
+	// same as above, but an exact leaf is only solved if its bound is below
+	// upper_bound, and only tours shorter than upper_bound are completed
+	bool CalcLBAndNextEdge(int upper_bound);
+
+	// the lower bound of the child that includes or excludes e, found by
+	// reducing its cost matrix without otherwise evaluating it
+	int CalcChildLowerBound(const Edge& e, bool include) const;
 
 	// ostream operator
 	friend std::ostream& operator<<(std::ostream& os, const TreeNode& p);
@@ -46,6 +81,11 @@ private:
 	// there are only two edges left to add.
 	bool HandleBaseCase(const std::vector<CostMatrixZero>& remaining_edges);
 
+	// Function to finish the tour with the exact leaf solver once the number
+	// of rows left is at most exact_leaf_size_. If no tour shorter than
+	// upper_bound can be made, the lower bound is set to infinity.
+	bool HandleExactLeaf(const CostMatrix& cost_matrix, int upper_bound);
+
 	// Helper method to calculate the lower bound from the edges included.
 	int CalculateLowerBound() const;
 
@@ -61,6 +101,7 @@ private:
 	std::vector<Edge> include_;
 	// not using bool because operator[] is slow, thanks Bjarne
 	Matrix<int> exclude_;
+	std::vector<Edge> branch_excludes_;
 
 	// keeping track for future TreeNodes
 	Edge next_edge_;  // set as (-1, -1) before it has been calculated
@@ -68,6 +109,21 @@ private:
 
 	// the node's lower bound
 	int lower_bound_;  // may not be updated until CalcLBAndNextEdge is called
+
+	// size at or below which the rest of the tour is found exactly
+	int exact_leaf_size_;
+
+	// chooses next_edge_ among the zeros of the reduced cost matrix
+	BranchingRule* branching_rule_;
+
+	long long trace_id_;
 };
 
+// Finds the zeros of a reduced cost matrix and the amount the lower bound would
+// rise by if each were excluded, sorted by decreasing penalty. Outside the base
+// case only the max_zeros highest are returned, or all of them if it is -1, and
+// if a zero can't be excluded, only that zero is.
+std::vector<CostMatrixZero> FindZerosAndPenalties(
+		const CostMatrix& cost_matrix, int max_zeros);
+
 #endif  // TSP_SOLVER_LITTLE_TSP_TREE_NODE_H
@@ -1,22 +1,31 @@
 #include "tree_node.hpp"
 
+#include <algorithm>
+#include <limits>
 #include <vector>
 
 #include "graph/edge_cost.hpp"
 #include "graph/mock.hpp"
 #include "matrix.hpp"
 #include "path.hpp"
+#include "statistics.hpp"
+#include "tsp_solver/little/branching_rule.hpp"
+#include "tsp_solver/little/cost_matrix.hpp"
 #include "util.hpp"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+using std::min;
+using std::numeric_limits;
 using std::vector;
 
 using ::testing::Const;
 using ::testing::Return;
 using ::testing::ReturnRef;
 
+const int infinity{numeric_limits<int>::max()};
+
 // cost matrix given in source paper (infinities on diagonals replaced by 0s)
 const Matrix<EdgeCost> graph_weights{MakeEdgeCosts({
 	0, 27, 43, 16, 30, 26,
@@ -89,6 +98,83 @@ TEST_F(TreeNodeTest, CalcLBAndNextEdgeExclude) {
 	TestExcludeBranch(level1, {5, 2}, 58);
 }
 
+TEST_F(TreeNodeTest, CalcChildLowerBound) {
+	TreeNode root{graph};
+	EXPECT_TRUE(root.CalcLBAndNextEdge());
+	EXPECT_EQ(49, root.CalcChildLowerBound({0, 3}, true));
+	EXPECT_EQ(58, root.CalcChildLowerBound({0, 3}, false));
+	// the node itself is left alone
+	EXPECT_EQ(48, root.GetLowerBound());
+}
+
+TEST_F(TreeNodeTest, StrongBranching) {
+	// with one candidate, strong branching takes the highest penalty zero
+	StrongBranchingRule one_candidate{1};
+	TreeNode penalty_root{graph, 0, &one_candidate};
+	EXPECT_TRUE(penalty_root.CalcLBAndNextEdge());
+	EXPECT_EQ(Edge(0, 3), penalty_root.GetNextEdge());
+
+	// with more, its weaker child is at least as good as (0, 3)'s
+	StrongBranchingRule all_candidates{36};
+	TreeNode root{graph, 0, &all_candidates};
+	EXPECT_TRUE(root.CalcLBAndNextEdge());
+	EXPECT_TRUE(root.HasExcludeBranch());
+	Edge chosen{root.GetNextEdge()};
+	EXPECT_LE(49, min(root.CalcChildLowerBound(chosen, true),
+				root.CalcChildLowerBound(chosen, false)));
+}
+
+TEST_F(TreeNodeTest, ReliabilityBranching) {
+	// with one candidate, the highest penalty zero is evaluated but left for
+	// the search to record
+	ReliabilityBranchingRule rule{6, 1, 2};
+	TreeNode root{graph, 0, &rule};
+	EXPECT_TRUE(root.CalcLBAndNextEdge());
+	const Edge chosen{root.GetNextEdge()};
+	EXPECT_EQ(Edge(0, 3), chosen);
+	EXPECT_EQ(0, rule.GetNumObservations(chosen));
+
+	// the chosen edge is observed once, when the search branches on it
+	rule.RecordBranch(chosen, root.GetLowerBound(),
+			root.CalcChildLowerBound(chosen, true),
+			root.CalcChildLowerBound(chosen, false));
+	EXPECT_EQ(1, rule.GetNumObservations(chosen));
+	EXPECT_TRUE(root.CalcLBAndNextEdge());
+	EXPECT_EQ(chosen, root.GetNextEdge());
+	Statistics statistics;
+	rule.RecordStatistics(statistics);
+	EXPECT_EQ(2, statistics.Get("strong_branching_evaluations"));
+
+	// the candidates the rule didn't choose are recorded right away
+	ReliabilityBranchingRule two_candidates{6, 2, 2};
+	TreeNode two_root{graph, 0, &two_candidates};
+	EXPECT_TRUE(two_root.CalcLBAndNextEdge());
+	CostMatrix cost_matrix{graph, {}, two_root.GetExcludes()};
+	cost_matrix.ReduceMatrix();
+	for (const CostMatrixZero& zero : FindZerosAndPenalties(cost_matrix, 2)) {
+		EXPECT_EQ(zero.edge == two_root.GetNextEdge() ? 0 : 1,
+				two_candidates.GetNumObservations(zero.edge));
+	}
+}
+
+TEST_F(TreeNodeTest, FindZerosAndPenalties) {
+	TreeNode root{graph};
+	CostMatrix cost_matrix{graph, {}, root.GetExcludes()};
+	cost_matrix.ReduceMatrix();
+	const vector<CostMatrixZero> all{FindZerosAndPenalties(cost_matrix, -1)};
+	ASSERT_LT(3u, all.size());
+	for (size_t i{1}; i < all.size(); ++i)
+	{ EXPECT_GE(all[i - 1].penalty, all[i].penalty); }
+
+	// fewer zeros are the first of them, however they were found
+	const vector<CostMatrixZero> highest{FindZerosAndPenalties(cost_matrix, 1)};
+	ASSERT_EQ(1u, highest.size());
+	EXPECT_EQ(all[0].edge, highest[0].edge);
+	const vector<CostMatrixZero> three{FindZerosAndPenalties(cost_matrix, 3)};
+	ASSERT_EQ(3u, three.size());
+	for (int i{0}; i < 3; ++i) { EXPECT_EQ(all[i].edge, three[i].edge); }
+}
+
 TEST_F(TreeNodeTest, CalcLBAndNextEdgeNoExclude) {
 	Matrix<EdgeCost> weights{
 		MakeEdgeCosts({-1, 1, 0, 0, -1, 2, 2, 0, -1}, 3)};
@@ -243,6 +329,54 @@ TEST_F(TreeNodeTest, CalcLBAndNextEdgeInclude) {
 	EXPECT_EQ(63, tsp_path.length);
 }
 
+TEST_F(TreeNodeTest, ExactLeaf) {
+	// the whole problem fits in the exact leaf solver, so the root is a leaf
+	TreeNode root{graph, 6};
+	EXPECT_FALSE(root.CalcLBAndNextEdge());
+	EXPECT_FALSE(root.HasExcludeBranch());
+	EXPECT_EQ(63, root.GetLowerBound());
+
+	Path tsp_path{root.GetTSPPath()};
+	const vector<int> expected_path{0, 3, 2, 4, 5, 1};
+	EXPECT_EQ(expected_path, tsp_path.vertices);
+	EXPECT_EQ(63, tsp_path.length);
+
+	// a leaf that can't beat the upper bound has no tour
+	TreeNode bounded{graph, 6};
+	EXPECT_FALSE(bounded.CalcLBAndNextEdge(63));
+	EXPECT_EQ(infinity, bounded.GetLowerBound());
+
+	// a leaf whose bound reaches the upper bound isn't solved at all
+	TreeNode pruned{graph, 6};
+	EXPECT_TRUE(pruned.CalcLBAndNextEdge(48));
+	EXPECT_EQ(48, pruned.GetLowerBound());
+}
+
+TEST_F(TreeNodeTest, ExactLeafBelowRoot) {
+	// the leaf solver takes over after the first include, excluded edges are
+	// respected when completing the tour
+	TreeNode root{graph, 5};
+	TreeNode level1{TestIncludeBranch(root, {0, 3}, 48)};
+	level1.AddExclude({2, 4});
+	EXPECT_FALSE(level1.CalcLBAndNextEdge());
+	Path tsp_path{level1.GetTSPPath()};
+	EXPECT_EQ(0, tsp_path.vertices[0]);
+	EXPECT_EQ(3, tsp_path.vertices[1]);
+	EXPECT_EQ(tsp_path.length, level1.GetLowerBound());
+	EXPECT_LT(63, tsp_path.length);
+}
+
+TEST_F(TreeNodeTest, CompleteGreedily) {
+	// keeps the included edges and otherwise takes the cheapest reduced cost
+	TreeNode root{graph};
+	root.AddInclude({1, 0});
+	root.AddInclude({2, 4});
+	Path tour{root.CompleteGreedily()};
+	const vector<int> expected_path{0, 3, 5, 2, 4, 1};
+	EXPECT_EQ(expected_path, tour.vertices);
+	EXPECT_EQ(97, tour.length);
+}
+
 TreeNode TreeNodeTest::TestIncludeBranch(TreeNode& parent, Edge e,
 		int lower_bound) {
 	EXPECT_TRUE(parent.CalcLBAndNextEdge());
@@ -0,0 +1,116 @@
+#include "tsp_solver/local_search.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+#include "graph/distance.hpp"
+#include "graph/edge_cost.hpp"
+#include "graph/graph.hpp"
+#include "graph/neighbors.hpp"
+#include "path.hpp"
+#include "tsp_solver/array_tour.hpp"
+#include "tsp_solver/neighbor_moves.hpp"
+#include "tsp_solver/two_level_tour.hpp"
+
+using std::deque;
+using std::reverse;
+using std::vector;
+
+// Improves the tour with NeighborMoves. Each vertex has a don't-look bit,
+// which is cleared when one of its edges changes. Only vertices with the bit
+// cleared are in the queue, and a vertex that has no improving move gets the
+// bit set again, so the search settles on the parts of the tour that are still
+// changing.
+template <typename Tour, typename Distance>
+static vector<int> RunNeighborSearch(const Distance& distance,
+		const vector<vector<int>>& neighbors, const vector<int>& vertices) {
+	Tour tour{vertices};
+	NeighborMoves<Distance, Tour> moves{distance, neighbors, tour};
+	deque<int> queue;
+	vector<char> queued(tour.size(), true);
+	for (int vertex : tour.GetVertices(0)) { queue.push_back(vertex); }
+	const auto changed = [&queue, &queued](int vertex) {
+		if (queued[vertex]) { return; }
+		queued[vertex] = true;
+		queue.push_back(vertex);
+	};
+
+	while (!queue.empty()) {
+		const int vertex{queue.front()};
+		queue.pop_front();
+		queued[vertex] = false;
+		// the vertex is queued again if it was improved, since it may have
+		// another improving move
+		if (moves.TryTwoOpt(vertex, changed) > 0) { continue; }
+		moves.TryOrOpt(vertex, changed);
+	}
+	return tour.GetVertices(vertices.front());
+}
+
+Path TwoOpt(const Graph& graph, Path path) {
+	vector<int>& tour{path.vertices};
+	const int size{int(tour.size())};
+	if (size < 4) { return path; }
+
+	// the lengths of the first k edges of the tour walked forwards and
+	// backwards, so the cost of walking a part of it the other way is known
+	// even when the graph is directed
+	vector<int> forward(size);
+	vector<int> backward(size);
+	const auto sum_edges = [&]() {
+		for (int k{1}; k < size; ++k) {
+			forward[k] = forward[k - 1] + graph(tour[k - 1], tour[k])();
+			backward[k] = backward[k - 1] + graph(tour[k], tour[k - 1])();
+		}
+	};
+	sum_edges();
+
+	bool improved{true};
+	while (improved) {
+		improved = false;
+		// replace edges (a, b) and (c, d) with (a, c) and (b, d) by reversing
+		// the part of the tour from b to c
+		for (int i{0}; i < size - 2; ++i) {
+			int a{tour[i]};
+			int b{tour[i + 1]};
+			// when i is 0, (c, d) can't be the edge back to the start
+			for (int j{i + 2}; j < (i == 0 ? size - 1 : size); ++j) {
+				int c{tour[j]};
+				int d{tour[(j + 1) % size]};
+				int reversed{backward[j] - backward[i + 1] - forward[j] +
+					forward[i + 1]};
+				int delta{graph(a, c)() + graph(b, d)() - graph(a, b)() -
+					graph(c, d)() + reversed};
+				if (delta < 0) {
+					reverse(tour.begin() + i + 1, tour.begin() + j + 1);
+					b = tour[i + 1];
+					sum_edges();
+					improved = true;
+				}
+			}
+		}
+	}
+
+	path.length = CalculatePathLength(graph, tour);
+	return path;
+}
+
+Path ImproveTour(const Graph& graph, Path path,
+		const vector<vector<int>>& neighbors) {
+	if (path.vertices.size() < 4) { return path; }
+
+	path.vertices = WithDistance(graph, [&](const auto& distance) {
+		if (int(path.vertices.size()) >= two_level_tour_size_c) {
+			return RunNeighborSearch<TwoLevelTour>(distance, neighbors,
+					path.vertices);
+		}
+		return RunNeighborSearch<ArrayTour>(distance, neighbors, path.vertices);
+	});
+	path.length = CalculatePathLength(graph, path.vertices);
+	return path;
+}
+
+Path ImproveTour(const Graph& graph, Path path, int neighbors) {
+	return ImproveTour(graph, path, NearestNeighbors(graph, neighbors));
+}
@@ -0,0 +1,26 @@
+#ifndef TSP_SOLVER_LOCAL_SEARCH_H
+#define TSP_SOLVER_LOCAL_SEARCH_H
+
+#include <vector>
+
+class Graph;
+struct Path;
+
+// Improves a tour with 2-opt moves until no move shortens it. The graph may be
+// directed, a move counts what walking the reversed part of the tour the
+// other way costs. The first vertex of the path stays first.
+Path TwoOpt(const Graph& graph, Path path);
+
+// Improves a tour with 2-opt moves and Or-opt moves, which move one to three
+// vertices in a row elsewhere, until none shortens it. Only moves that join a
+// vertex to one of its neighbors, as given by NearestNeighbors, are tried, and
+// only around vertices whose edges changed since they were last looked at, so
+// a pass takes close to linear time, unlike TwoOpt. This is meant for tours
+// from heuristics on large graphs, and unlike TwoOpt the graph is taken to be
+// undirected. The first vertex of the path stays first.
+Path ImproveTour(const Graph& graph, Path path,
+		const std::vector<std::vector<int>>& neighbors);
+// the same with the given number of nearest neighbors of each vertex
+Path ImproveTour(const Graph& graph, Path path, int neighbors);
+
+#endif  // TSP_SOLVER_LOCAL_SEARCH_H
@@ -0,0 +1,141 @@
+#include "tsp_solver/local_search.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include "graph/edge_cost.hpp"
+#include "graph/factory.hpp"
+#include "graph/graph.hpp"
+#include "graph/mock.hpp"
+#include "matrix.hpp"
+#include "path.hpp"
+#include "test_util.hpp"
+#include "tsp_solver/array_tour.hpp"
+#include "tsp_solver/two_level_tour.hpp"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using std::istringstream;
+using std::mt19937;
+using std::shuffle;
+using std::sort;
+using std::unique_ptr;
+using std::vector;
+
+using ::testing::Const;
+using ::testing::ReturnRef;
+
+// 16 points on a manhattan grid, the shortest tour has length 534
+const char* const graph_input{
+	"100 16 17 72 97 8 32 15 63 97 57 60 83 48 100 26 12 62 3 49 55 77 97 98 "
+	"0 89 57 34 92 29 75 13 40 3"};
+
+static vector<int> Sorted(vector<int> vertices) {
+	sort(vertices.begin(), vertices.end());
+	return vertices;
+}
+
+TEST(ArrayTourTest, TwoOptMove) {
+	ArrayTour tour{{0, 1, 2, 3, 4, 5}};
+	// replace (0, 1) and (3, 4) with (0, 3) and (1, 4)
+	tour.TwoOptMove(0, 1, 3, 4);
+	EXPECT_EQ((vector<int>{0, 3, 2, 1, 4, 5}), tour.GetVertices(0));
+	// the shorter side is reversed, so next may go the other way now
+	tour.TwoOptMove(4, 5, 0, 3);
+	const vector<int> vertices{tour.GetVertices(0)};
+	const bool forward{vertices[1] == 4};
+	EXPECT_EQ(forward ? (vector<int>{0, 4, 1, 2, 3, 5}) :
+			(vector<int>{0, 5, 3, 2, 1, 4}), vertices);
+}
+
+TEST(TwoLevelTourTest, MatchesArrayTour) {
+	vector<int> vertices;
+	for (int vertex{0}; vertex < 100; ++vertex) { vertices.push_back(vertex); }
+	mt19937 random{3};
+	shuffle(vertices.begin(), vertices.end(), random);
+	ArrayTour array_tour{vertices};
+	TwoLevelTour two_level_tour{vertices};
+	for (int move{0}; move < 1000; ++move) {
+		// the tours may go opposite ways, but must be the same cycle
+		const int a{int(random() % 100)};
+		const int c{int(random() % 100)};
+		const int b{array_tour.Next(a)};
+		const int d{array_tour.Next(c)};
+		if (a == c || b == c || d == a) { continue; }
+		array_tour.TwoOptMove(a, b, c, d);
+		two_level_tour.TwoOptMove(a, b, c, d);
+		for (int vertex{0}; vertex < 100; ++vertex) {
+			const int next{two_level_tour.Next(vertex)};
+			EXPECT_EQ(vertex, two_level_tour.Prev(next));
+			EXPECT_TRUE(next == array_tour.Next(vertex) ||
+					next == array_tour.Prev(vertex));
+		}
+	}
+	EXPECT_EQ(Sorted(vertices), Sorted(two_level_tour.GetVertices(0)));
+}
+
+TEST(TwoOptTest, DirectedGraph) {
+	// the cost matrix from Little's paper, where walking a part of a tour
+	// backwards changes its length
+	const Matrix<EdgeCost> weights{MakeEdgeCosts({
+		0, 27, 43, 16, 30, 26,
+		7, 0, 16, 1, 30, 25,
+		20, 13, 0, 35, 5, 0,
+		21, 16, 25, 0, 18, 18,
+		12, 46, 27, 48, 0, 5,
+		23, 5, 5, 9, 5, 0}, 6)};
+	MockGraph graph;
+	for (int i{0}; i < 6; ++i) {
+		for (int j{0}; j < 6; ++j) {
+			EXPECT_CALL(Const(graph), Predicate(i, j)).WillRepeatedly(
+					ReturnRef(weights(i, j)));
+		}
+	}
+
+	Path path;
+	path.vertices = {0, 1, 2, 3, 4, 5};
+	do {
+		path.length = CalculatePathLength(graph, path.vertices);
+		const Path improved{TwoOpt(graph, path)};
+		EXPECT_EQ(0, improved.vertices.front());
+		EXPECT_EQ(Sorted(path.vertices), Sorted(improved.vertices));
+		EXPECT_LE(improved.length, path.length);
+		// the shortest tour has length 63
+		EXPECT_GE(improved.length, 63);
+	} while (std::next_permutation(path.vertices.begin() + 1,
+			path.vertices.end()));
+}
+
+TEST(ImproveTourTest, NeverWorse) {
+	istringstream input{graph_input};
+	unique_ptr<Graph> graph{CreateGraph("manhattan", input)};
+	Path path;
+	path.vertices = {5, 0, 1, 2, 3, 4, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+	mt19937 random{1};
+	for (int i{0}; i < 20; ++i) {
+		shuffle(path.vertices.begin() + 1, path.vertices.end(), random);
+		path.length = CalculatePathLength(*graph, path.vertices);
+		const Path improved{ImproveTour(*graph, path, 5)};
+		EXPECT_EQ(5, improved.vertices.front());
+		EXPECT_TRUE(IsValidTour(*graph, improved));
+		EXPECT_LE(improved.length, path.length);
+		EXPECT_GE(improved.length, 534);
+	}
+}
+
+TEST(ImproveTourTest, RandomPoints) {
+	unique_ptr<Graph> graph{MakeRandomGraph(300, 1000, 2)};
+
+	Path path;
+	for (int vertex{0}; vertex < 300; ++vertex)
+	{ path.vertices.push_back(vertex); }
+	path.length = CalculatePathLength(*graph, path.vertices);
+	const Path improved{ImproveTour(*graph, path, 10)};
+	EXPECT_TRUE(IsValidTour(*graph, improved));
+	// a random order is far longer than a tour with no improving moves
+	EXPECT_LT(improved.length * 4, path.length);
+}
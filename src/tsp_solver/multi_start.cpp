@@ -0,0 +1,99 @@
+#include "tsp_solver/multi_start.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "graph/graph.hpp"
+#include "graph/neighbors.hpp"
+#include "path.hpp"
+#include "tsp_solver/cancellation.hpp"
+#include "tsp_solver/fast.hpp"
+#include "tsp_solver/local_search.hpp"
+#include "util.hpp"
+
+using std::atomic;
+using std::lock_guard;
+using std::mt19937;
+using std::mutex;
+using std::seed_seq;
+using std::thread;
+using std::uniform_int_distribution;
+using std::vector;
+
+MultiStartTSPSolver::MultiStartTSPSolver(const SolverOptions& options) :
+		TSPSolver{false}, options_{options} {
+	if (!IsValidInsertionType(options_.insertion))
+	{ throw Error{"Not a valid insertion type!"}; }
+}
+
+Path MultiStartTSPSolver::Solve(const Graph& graph) const {
+	statistics_.Clear();
+	const int num_vertices{graph.GetNumVertices()};
+	// catch the case with 0 vertices
+	if (num_vertices == 0) { return Path{}; }
+
+	// the neighbor lists are only found once, and shared by every start
+	const vector<vector<int>> neighbors{options_.neighbors > 0 ?
+		NearestNeighbors(graph, options_.neighbors) : vector<vector<int>>{}};
+
+	CancellationToken budget{options_.cancellation, options_.time_budget};
+	IncumbentReporter reporter{options_.incumbent};
+
+	// the next start to take, and the shortest tour and the start it came from,
+	// the earliest start among tours as short as each other
+	atomic<long long> next_start{0};
+	mutex best_mutex;
+	Path best;
+	long long best_start{-1};
+	long long starts{0};
+
+	auto run = [&] {
+		// each thread keeps its own generator, seeded anew for each start
+		mt19937 random;
+		uniform_int_distribution<int> pick_vertex{0, num_vertices - 1};
+		while (true) {
+			const long long start{next_start++};
+			if (options_.starts > 0 && start >= options_.starts) { return; }
+			// the first start always runs, so there is a tour to return
+			if (start > 0 && budget.IsCancelled()) { return; }
+
+			int first{0};
+			if (start > 0) {
+				seed_seq seed{options_.seed, unsigned(start)};
+				random.seed(seed);
+				first = pick_vertex(random);
+			}
+			Path tour{BuildInsertionTour(graph, options_.insertion, first)};
+			if (options_.neighbors > 0)
+			{ tour = ImproveTour(graph, tour, neighbors); }
+
+			{
+				lock_guard<mutex> lock{best_mutex};
+				++starts;
+				if (best_start != -1 && (tour.length > best.length ||
+						(tour.length == best.length && start > best_start)))
+				{ continue; }
+				best = tour;
+				best_start = start;
+			}
+			reporter(tour);
+			if (options_.shared_upper_bound) {
+				int current{options_.shared_upper_bound->load()};
+				while (tour.length < current &&
+						!options_.shared_upper_bound->compare_exchange_weak(
+							current, tour.length)) {}
+			}
+		}
+	};
+	vector<thread> threads;
+	for (int i{1}; i < options_.threads; ++i) { threads.emplace_back(run); }
+	run();
+	for (thread& t : threads) { t.join(); }
+
+	statistics_.Set("starts", starts);
+	statistics_.Set("best_start", best_start);
+	return best;
+}
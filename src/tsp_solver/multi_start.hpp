@@ -0,0 +1,29 @@
+#ifndef TSP_SOLVER_MULTI_START_H
+#define TSP_SOLVER_MULTI_START_H
+
+#include "tsp_solver/options.hpp"
+#include "tsp_solver/tsp_solver.hpp"
+
+/* Solves the TSP by building the fast solver's tour from many starting
+ * vertices and keeping the shortest, since insertion tours differ a lot with
+ * where they start. Each start builds an options.insertion tour from a random
+ * vertex and improves it with ImproveTour, unless options.neighbors is 0. The
+ * first start is from vertex 0, so the tour is never longer than the fast
+ * solver's. options.threads threads take starts until options.time_budget
+ * seconds have passed or options.starts starts are done, and each start is
+ * seeded with options.seed and its number, so a run limited only by
+ * options.starts makes the same tour with any number of threads. A start that
+ * is under way when the time runs out is finished.
+ */
+class MultiStartTSPSolver : public TSPSolver {
+public:
+	MultiStartTSPSolver() : MultiStartTSPSolver{SolverOptions{}} {}
+	explicit MultiStartTSPSolver(const SolverOptions& options);
+
+	Path Solve(const Graph&) const override;
+
+private:
+	SolverOptions options_;
+};
+
+#endif  // TSP_SOLVER_MULTI_START_H
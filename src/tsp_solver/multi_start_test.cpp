@@ -0,0 +1,29 @@
+#include "tsp_solver/multi_start.hpp"
+
+#include <memory>
+
+#include "graph/graph.hpp"
+#include "path.hpp"
+#include "test_util.hpp"
+#include "tsp_solver/fast.hpp"
+#include "tsp_solver/options.hpp"
+
+#include "gtest/gtest.h"
+
+using std::unique_ptr;
+
+TEST(MultiStartTest, RandomPoints) {
+	unique_ptr<Graph> graph{MakeRandomGraph(300, 1000, 8)};
+
+	// runs without a time budget, so they make the same tour every time
+	SolverOptions options;
+	options.time_budget = 0;
+	options.starts = 20;
+	const MultiStartTSPSolver solver{options};
+	const Path tour{solver.Solve(*graph)};
+	EXPECT_EQ(20, solver.GetStatistics().Get("starts"));
+	EXPECT_TRUE(IsValidTour(*graph, tour));
+	EXPECT_EQ(0, tour.vertices.front());
+	// the first start is the fast solver's tour
+	EXPECT_LE(tour.length, FastTSPSolver{}.Solve(*graph).length);
+}
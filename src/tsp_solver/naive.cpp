@@ -1,71 +1,213 @@
 #include "tsp_solver/naive.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <limits>
+#include <mutex>
+#include <thread>
 #include <vector>
 
-#include "graph/edge_cost.hpp"
 #include "graph/graph.hpp"
 #include "path.hpp"
+#include "tsp_solver/cancellation.hpp"
+#include "util.hpp"
 
-using std::vector;
+using std::atomic;
+using std::lock_guard;
+using std::min;
+using std::mutex;
 using std::numeric_limits;
+using std::thread;
+using std::uint64_t;
+using std::vector;
 
-static Path SolveHelper(const Graph& graph, Path soFar, vector<bool> visited);
+namespace {
+
+// the visited vertices are bits of one word
+const int max_vertices_c{64};
+// the tours starting with 0 and each choice of the next this many vertices are
+// searched as one task, so threads have enough tasks to share
+const int split_depth_c{2};
+// extensions between checks of the cancellation token, which may read the clock
+const int cancellation_interval_c{4096};
+
+// A depth first search over the tours that start with the prefix of a task,
+// which extends one path in place and takes the last vertex off on return.
+// Each thread has its own, and they share only the length of the shortest tour.
+class Search {
+public:
+	Search(const vector<int>& costs, int num_vertices, atomic<int>& shortest,
+			const CancellationToken* cancellation) :
+		costs_(costs), num_vertices_{num_vertices}, shortest_(shortest),
+		cancellation_{cancellation}, path_(num_vertices), visited_{0},
+		until_check_{cancellation_interval_c}, cancelled_{false} {
+		best.length = numeric_limits<int>::max();
+	}
 
-Path NaiveTSPSolver::Solve(const Graph& graph) const {
-	// if no vertices
-	if (!graph.GetNumVertices()) { return Path{}; }
+	// search the tours starting with the given vertices, where best is only
+	// replaced by a strictly shorter tour, so it is the first of the shortest
+	void Run(const vector<int>& prefix, long long task) {
+		visited_ = 0;
+		int length{0};
+		for (int i{0}; i < int(prefix.size()); ++i) {
+			path_[i] = prefix[i];
+			visited_ |= uint64_t{1} << prefix[i];
+			if (i > 0) { length += Cost(prefix[i - 1], prefix[i]); }
+		}
+		current_task_ = task;
+		if (length > Bound()) { ++pruned; return; }
+		Extend(int(prefix.size()), length);
+	}
 
-	// start at zero, recurse
-	Path start;
-	start.length = 0;
-	start.vertices.push_back(0);
+	bool IsCancelled() const { return cancelled_; }
 
-	// update the visited bitVector
-	vector<bool> visited(graph.GetNumVertices(), false);
-	visited[0] = true;
+	// the shortest tour this search found, and the task it came from
+	Path best;
+	long long best_task{-1};
+	long long tours{0};
+	long long pruned{0};
 
-	// recursive step
-	Path minPath{SolveHelper(graph, start, visited)};
-	return minPath;
-}
+private:
+	int Cost(int from, int to) const
+	{ return costs_[from * num_vertices_ + to]; }
 
-// implementation of optimal traveling salesperson methods
-Path SolveHelper(const Graph& graph, Path soFar, vector<bool> visited) {
-	Path minPath;
-	minPath.length = numeric_limits<int>::max();
-	bool openVertex{false};
+	// paths longer than the shortest tour any thread found can't be part of a
+	// shorter one, since costs aren't negative
+	int Bound() const
+	{ return min(best.length, shortest_.load(std::memory_order_relaxed)); }
 
-	// go to each unvisited vertex
-	for (int i{0}; i < graph.GetNumVertices(); ++i) {
-		if (!visited[i]) {
-			// copy the current path and update it based on the next vertex
-			Path add{soFar};
+	// try every unvisited vertex after the first depth vertices of path_
+	void Extend(int depth, int length) {
+		if (cancellation_ && --until_check_ == 0) {
+			until_check_ = cancellation_interval_c;
+			cancelled_ = cancellation_->IsCancelled();
+		}
+		if (cancelled_) { return; }
+
+		const int last{path_[depth - 1]};
+		if (depth == num_vertices_) {
+			++tours;
+			const int total{length + Cost(last, path_[0])};
+			if (total >= best.length) { return; }
+			best.vertices = path_;
+			best.length = total;
+			best_task = current_task_;
+			int current{shortest_.load()};
+			while (total < current &&
+					!shortest_.compare_exchange_weak(current, total)) {}
+			return;
+		}
 
-			// update add to contain the new vertex as part of the path
-			add.vertices.push_back(i);
-			add.length += graph(i, add.vertices[add.vertices.size() - 2])();
+		for (int next{1}; next < num_vertices_; ++next) {
+			const uint64_t bit{uint64_t{1} << next};
+			if (visited_ & bit) { continue; }
+			const int extended{length + Cost(last, next)};
+			// equal lengths are still searched, so the tour found doesn't
+			// depend on how the threads' tasks interleave
+			if (extended > Bound()) { ++pruned; continue; }
+			visited_ |= bit;
+			path_[depth] = next;
+			Extend(depth + 1, extended);
+			visited_ &= ~bit;
+		}
+	}
 
-			// update the visited bitvector
-			vector<bool> nextVisited{visited};
-			nextVisited[i] = true;
-			openVertex = true;
+	const vector<int>& costs_;
+	int num_vertices_;
+	atomic<int>& shortest_;
+	const CancellationToken* cancellation_;
+	vector<int> path_;
+	uint64_t visited_;
+	long long current_task_{-1};
+	int until_check_;
+	bool cancelled_;
+};
+
+// every path of the given length that starts at 0, in lexicographic order
+void MakePrefixes(int num_vertices, int length, vector<int>& prefix,
+		vector<vector<int>>& prefixes) {
+	if (int(prefix.size()) == length) {
+		prefixes.push_back(prefix);
+		return;
+	}
+	for (int next{1}; next < num_vertices; ++next) {
+		if (find(prefix.begin(), prefix.end(), next) != prefix.end())
+		{ continue; }
+		prefix.push_back(next);
+		MakePrefixes(num_vertices, length, prefix, prefixes);
+		prefix.pop_back();
+	}
+}
 
-			// recursive step
-			Path option{SolveHelper(graph, add, nextVisited)};
+}  // namespace
 
-			// update the minPath if appropriate
-			if (option.length < minPath.length) { minPath = option; }
-		}
-	}
+Path NaiveTSPSolver::Solve(const Graph& graph) const {
+	statistics_.Clear();
+	const int num_vertices{graph.GetNumVertices()};
 
-	// base case: level reached where all vertices are already part of the path
-	if (!openVertex) {
-		soFar.length += graph(soFar.vertices[soFar.vertices.size() - 1], 0)();
-		return soFar;
+	// if no vertices
+	if (!num_vertices) { return Path{}; }
+	if (num_vertices > max_vertices_c)
+	{ throw Error{"The naive solver handles at most 64 vertices!"}; }
+
+	// the costs are read far more often than in any other solver, so they are
+	// copied out of the graph once
+	vector<int> costs(num_vertices * num_vertices);
+	for (int from{0}; from < num_vertices; ++from) {
+		for (int to{0}; to < num_vertices; ++to)
+		{ costs[from * num_vertices + to] = graph.GetDistance(from, to); }
 	}
 
-	// at each level, once all possible path choices have been explored, return
-	// the one with the minimum weight
+	// the tours are split among the threads by the vertices they visit after 0
+	vector<vector<int>> prefixes;
+	vector<int> prefix{0};
+	MakePrefixes(num_vertices, min(num_vertices, split_depth_c + 1), prefix,
+			prefixes);
+
+	atomic<int> shortest{numeric_limits<int>::max()};
+	atomic<long long> next_task{0};
+	mutex best_mutex;
+	Path minPath;
+	long long best_task{-1};
+	long long tours{0}, pruned{0};
+	bool cancelled{false};
+
+	auto run = [&] {
+		Search search{costs, num_vertices, shortest, options_.cancellation};
+		while (!search.IsCancelled()) {
+			const long long task{next_task++};
+			if (task >= int(prefixes.size())) { break; }
+			search.Run(prefixes[task], task);
+		}
+
+		// ties go to the earliest task, so the tour is the first of the
+		// shortest in lexicographic order with any number of threads
+		lock_guard<mutex> lock{best_mutex};
+		tours += search.tours;
+		pruned += search.pruned;
+		cancelled = cancelled || search.IsCancelled();
+		if (search.best_task == -1) { return; }
+		if (best_task == -1 || search.best.length < minPath.length ||
+				(search.best.length == minPath.length &&
+				 search.best_task < best_task)) {
+			minPath = search.best;
+			best_task = search.best_task;
+		}
+	};
+	const int num_threads{min(options_.threads, int(prefixes.size()))};
+	vector<thread> threads;
+	for (int i{1}; i < num_threads; ++i) { threads.emplace_back(run); }
+	run();
+	for (thread& t : threads) { t.join(); }
+
+	statistics_.Set("tours", tours);
+	statistics_.Set("pruned", pruned);
+
+	// a cancelled search may not have reached a single full path
+	if (cancelled) {
+		statistics_.Set("cancelled", 1);
+		if (best_task == -1) { return Path{}; }
+	}
 	return minPath;
 }
@@ -1,14 +1,21 @@
 #ifndef TSP_SOLVER_NAIVE_H
 #define TSP_SOLVER_NAIVE_H
 
+#include "tsp_solver/options.hpp"
 #include "tsp_solver/tsp_solver.hpp"
 
-/* Solves the TSP using a naive optimal solution */
+/* Solves the TSP by trying every tour of at most 64 vertices, skipping paths
+ * longer than the shortest tour found so far */
 class NaiveTSPSolver : public TSPSolver {
 public:
-	NaiveTSPSolver() : TSPSolver{true} {}
+	NaiveTSPSolver() : NaiveTSPSolver{SolverOptions{}} {}
+	explicit NaiveTSPSolver(const SolverOptions& options) :
+		TSPSolver{true}, options_{options} {}
 
 	Path Solve(const Graph&) const override;
+
+private:
+	SolverOptions options_;
 };
 
 #endif  // TSP_SOLVER_NAIVE_H
@@ -0,0 +1,32 @@
+#include "tsp_solver/naive.hpp"
+
+#include <memory>
+
+#include "graph/graph.hpp"
+#include "path.hpp"
+#include "test_util.hpp"
+#include "tsp_solver/little/solver.hpp"
+
+#include "gtest/gtest.h"
+
+using std::unique_ptr;
+
+TEST(NaiveTest, MatchesLittle) {
+	for (int num_vertices{1}; num_vertices <= 9; ++num_vertices) {
+		unique_ptr<Graph> graph{MakeRandomGraph(num_vertices, 100,
+				unsigned(num_vertices))};
+		const Path tour{NaiveTSPSolver{}.Solve(*graph)};
+		EXPECT_TRUE(IsValidTour(*graph, tour));
+		EXPECT_EQ(0, tour.vertices.front());
+		EXPECT_EQ(LittleTSPSolver{}.Solve(*graph).length, tour.length);
+	}
+}
+
+TEST(NaiveTest, Prunes) {
+	unique_ptr<Graph> graph{MakeRandomGraph(10, 100, 11)};
+	const NaiveTSPSolver solver{};
+	solver.Solve(*graph);
+	// pruning leaves far fewer than the 9! tours through the other vertices
+	EXPECT_LT(solver.GetStatistics().Get("tours"), 362880);
+	EXPECT_GT(solver.GetStatistics().Get("pruned"), 0);
+}
@@ -0,0 +1,131 @@
+#ifndef TSP_SOLVER_NEIGHBOR_MOVES_H
+#define TSP_SOLVER_NEIGHBOR_MOVES_H
+
+#include <vector>
+
+/* 2-opt and Or-opt moves that join a vertex to one of its nearest neighbors, on
+ * an ArrayTour, a TwoLevelTour or anything else with their interface. Each Try
+ * function makes the first move around the vertex that shortens the tour,
+ * calls changed with each vertex whose edges it changed, and returns how much
+ * shorter the tour got, or 0 if no move did. The neighbors must be nearest
+ * first, as NearestNeighbors gives them, and the graph is taken to be
+ * undirected.
+ */
+template <typename Distance, typename Tour>
+class NeighborMoves {
+public:
+	NeighborMoves(const Distance& distance,
+			const std::vector<std::vector<int>>& neighbors, Tour& tour) :
+		distance_(distance), neighbors_(neighbors), tour_(tour) {}
+
+	// replace the edge from a to the vertex after or before it and the
+	// matching edge from one of a's neighbors with one joining a to the
+	// neighbor
+	template <typename Changed>
+	int TryTwoOpt(int a, Changed changed) {
+		for (bool forward : {true, false}) {
+			const int b{forward ? tour_.Next(a) : tour_.Prev(a)};
+			const int ab{distance_(a, b)};
+			for (int c : neighbors_[a]) {
+				const int ac{distance_(a, c)};
+				// the neighbors only get farther, so none of the rest can make
+				// up for the edge
+				if (ac >= ab) { break; }
+				const int d{forward ? tour_.Next(c) : tour_.Prev(c)};
+				if (d == a) { continue; }
+				const int gain{ab + distance_(c, d) - ac - distance_(b, d)};
+				if (gain > 0) {
+					tour_.TwoOptMove(a, b, c, d);
+					for (int vertex : {a, b, c, d}) { changed(vertex); }
+					return gain;
+				}
+			}
+		}
+		return 0;
+	}
+
+	// move a segment of at most max_segment_length vertices that a ends to
+	// between one of a's neighbors and the vertex next to it, joining a to the
+	// neighbor
+	template <typename Changed>
+	int TryOrOpt(int a, Changed changed) {
+		for (int length{1}; length <= max_segment_length; ++length) {
+			if (tour_.size() < length + 3) { return 0; }
+			for (bool forward : {true, false}) {
+				// a segment of one vertex is the same either way
+				if (length == 1 && !forward) { continue; }
+				int first{a};
+				int last{a};
+				for (int i{1}; i < length; ++i) {
+					if (forward) { last = tour_.Next(last); }
+					else { first = tour_.Prev(first); }
+				}
+				const int gain{TryMoveSegment(a, first, last, changed)};
+				if (gain > 0) { return gain; }
+			}
+		}
+		return 0;
+	}
+
+	static const int max_segment_length{3};
+
+	// move the segment from first to last between x and y, keeping first next
+	// to x if in_order, with two or three 2-opt moves
+	void MoveSegment(int first, int last, int x, int y, bool in_order) {
+		const int before{tour_.Prev(first)};
+		const int after{tour_.Next(last)};
+		// before first ... last after ... x y becomes
+		// before x ... after last ... first y
+		tour_.TwoOptMove(before, first, x, y);
+		// then before after ... x last ... first y
+		tour_.TwoOptMove(before, x, after, last);
+		// then before after ... x first ... last y
+		if (in_order) { tour_.TwoOptMove(x, last, first, y); }
+	}
+
+	// whether the vertex is in the segment from first to last, going forward
+	bool InSegment(int vertex, int first, int last) const {
+		for (int in_segment{first}; ; in_segment = tour_.Next(in_segment)) {
+			if (vertex == in_segment) { return true; }
+			if (in_segment == last) { return false; }
+		}
+	}
+
+private:
+	template <typename Changed>
+	int TryMoveSegment(int a, int first, int last, Changed changed) {
+		const int before{tour_.Prev(first)};
+		const int after{tour_.Next(last)};
+		const int other_end{a == first ? last : first};
+		const int removed{distance_(before, first) + distance_(last, after) -
+			distance_(before, after)};
+		for (int c : neighbors_[a]) {
+			const int ac{distance_(a, c)};
+			if (ac >= removed) { break; }
+			if (InSegment(c, first, last)) { continue; }
+			// the segment goes between x and the vertex y after it, one of
+			// which is c
+			for (int x : {c, tour_.Prev(c)}) {
+				const int y{tour_.Next(x)};
+				if (InSegment(x, first, last) || InSegment(y, first, last))
+				{ continue; }
+				const int o{x == c ? y : x};
+				const int gain{
+					removed + distance_(x, y) - ac - distance_(other_end, o)};
+				if (gain > 0) {
+					MoveSegment(first, last, x, y, (x == c) == (a == first));
+					for (int vertex : {before, after, first, last, x, y})
+					{ changed(vertex); }
+					return gain;
+				}
+			}
+		}
+		return 0;
+	}
+
+	const Distance& distance_;
+	const std::vector<std::vector<int>>& neighbors_;
+	Tour& tour_;
+};
+
+#endif  // TSP_SOLVER_NEIGHBOR_MOVES_H
@@ -0,0 +1,105 @@
+#ifndef TSP_SOLVER_OPTIONS_H
+#define TSP_SOLVER_OPTIONS_H
+
+#include <atomic>
+#include <string>
+
+#include "tsp_solver/progress.hpp"
+
+class CancellationToken;
+
+// Settings handed to solvers when they are created. Each solver reads only the
+// settings that apply to it, so the same options can be given to any solver.
+struct SolverOptions {
+	// Little's algorithm solves nodes with at most this many rows left exactly
+	// instead of branching on them, 0 turns this off
+	int exact_leaf_size{12};
+	// Little's algorithm greedily completes and 2-opts the tour of every
+	// dive_frequency-th node it expands to improve its upper bound, starting
+	// with the root, 0 turns this off
+	int dive_frequency{100};
+	// Little's algorithm excludes edges whose root reduced cost shows they
+	// can't be in a tour shorter than the upper bound, each time it drops
+	bool eliminate_edges{true};
+	// Little's algorithm prunes nodes that can't beat the upper bound by more
+	// than this fraction of it, so the tour it returns is at most 1 + gap times
+	// the optimum, 0 keeps it exact
+	double gap{0};
+	// how Little's algorithm chooses the edge to branch on: "penalty" (the
+	// original rule), "strong" or "reliability"
+	std::string branching{"penalty"};
+	// the strong and reliability rules evaluate the children of at most this
+	// many zeros per node
+	int branching_candidates{4};
+	// the reliability rule trusts an edge's pseudocosts after this many
+	// observations
+	int reliability_threshold{4};
+	// Little's algorithm writes its open nodes, shortest tour and statistics
+	// to this file every checkpoint_interval seconds and when it finishes,
+	// empty turns this off
+	std::string checkpoint_file;
+	int checkpoint_interval{60};
+	// Little's algorithm picks up the search saved in checkpoint_file instead
+	// of starting from the root
+	bool resume{false};
+	// Little's algorithm writes the events of every trace_sample-th node it
+	// makes and each shorter tour it finds to this file, up to trace_limit
+	// events, empty turns this off
+	std::string trace_file;
+	int trace_sample{1};
+	long long trace_limit{1000000};
+	// Little's algorithm splits its tree among this many processes
+	int processes{1};
+	// Little's algorithm splits its tree among this many threads, which share
+	// one address space, unlike processes, as do the naive solver its tours,
+	// the hilbert solver its sort, the multistart solver its starts and the
+	// anneal solver its replicas
+	int threads{1};
+	// if set, solvers prune with tour lengths other solvers store here and
+	// store the lengths of the tours they find, so concurrent solvers of the
+	// same graph can share their upper bound
+	std::atomic<int>* shared_upper_bound{nullptr};
+	// if set, exact solvers stop early once it is cancelled, returning the
+	// best tour they have and setting their "cancelled" statistic
+	const CancellationToken* cancellation{nullptr};
+	// if set, Little's algorithm calls this from the thread that called Solve
+	// about every progress_interval seconds
+	ProgressCallback progress;
+	double progress_interval{1};
+	// if set, Little's algorithm and the portfolio call this with each tour
+	// they find that is shorter than every one before it, one call at a time
+	IncumbentCallback incumbent;
+	// how the fast solver picks the vertex to insert next: "nearest",
+	// "farthest" or "cheapest"
+	std::string insertion{"farthest"};
+	// the fast, mst and multistart solvers improve their tours with 2-opt and
+	// Or-opt moves that join each vertex to one of its this many nearest
+	// neighbors, 0 turns this off, and the lk and anneal solvers only make
+	// moves to these neighbors
+	int neighbors{10};
+	// the hilbert solver only improves its tour the same way if this is set,
+	// since on the huge graphs it is for that takes far longer than the curve
+	bool improve_hilbert{false};
+	// the lk solver kicks its tour out of its local optimum and improves it
+	// again until time_budget seconds have passed or it has done so kicks
+	// times, 0 turns either limit off, and with both off it runs until it is
+	// cancelled
+	double time_budget{1};
+	int kicks{0};
+	// the multistart solver builds tours from new starting vertices until
+	// time_budget seconds have passed or it has built starts of them, with the
+	// same meaning of 0
+	int starts{0};
+	// the anneal solver anneals this many copies of its tour, each at its own
+	// temperature, until time_budget seconds have passed or it has done rounds
+	// rounds of moves on each, with the same meaning of 0
+	int replicas{4};
+	int rounds{0};
+	// seeds the random choices of heuristics, so runs with the same seed and
+	// no time limits make the same tour
+	unsigned seed{1};
+	// the solvers the portfolio solver races, see IsValidPortfolio
+	std::string portfolio{"fast,little,little:reliability"};
+};
+
+#endif  // TSP_SOLVER_OPTIONS_H
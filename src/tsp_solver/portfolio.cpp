@@ -0,0 +1,271 @@
+#include "tsp_solver/portfolio.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "graph/graph.hpp"
+#include "path.hpp"
+#include "statistics.hpp"
+#include "tsp_solver/cancellation.hpp"
+#include "tsp_solver/factory.hpp"
+#include "tsp_solver/fast.hpp"
+#include "tsp_solver/little/branching_rule.hpp"
+#include "tsp_solver/options.hpp"
+#include "tsp_solver/progress.hpp"
+#include "tsp_solver/tsp_solver.hpp"
+#include "util.hpp"
+
+using std::atomic;
+using std::chrono::duration;
+using std::chrono::duration_cast;
+using std::chrono::steady_clock;
+using std::condition_variable;
+using std::current_exception;
+using std::exception_ptr;
+using std::istringstream;
+using std::lock_guard;
+using std::max;
+using std::min;
+using std::mutex;
+using std::numeric_limits;
+using std::ref;
+using std::rethrow_exception;
+using std::string;
+using std::thread;
+using std::unique_lock;
+using std::unique_ptr;
+using std::vector;
+
+const int infinity{numeric_limits<int>::max()};
+
+const string portfolio_type_c{"portfolio"};
+const string little_type_c{"little"};
+const string fast_type_c{"fast"};
+
+static vector<string> SplitPortfolio(const string& portfolio);
+static bool IsExactPortfolio(const string& portfolio);
+
+bool IsValidPortfolio(const string& portfolio) {
+	vector<string> members{SplitPortfolio(portfolio)};
+	if (members.empty()) { return false; }
+	for (const string& member : members) {
+		string type{member.substr(0, member.find(':'))};
+		if (type == portfolio_type_c || !IsValidTSPSolverType(type))
+		{ return false; }
+		if (type == member) { continue; }
+		string variant{member.substr(type.size() + 1)};
+		if (type == little_type_c && IsValidBranchingRuleType(variant))
+		{ continue; }
+		if (type == fast_type_c && IsValidInsertionType(variant)) { continue; }
+		return false;
+	}
+	return true;
+}
+
+PortfolioTSPSolver::PortfolioTSPSolver(const SolverOptions& options) :
+		TSPSolver{IsExactPortfolio(options.portfolio)}, options_{options} {
+	if (!IsValidPortfolio(options_.portfolio))
+	{ throw Error{"Not a valid portfolio!"}; }
+	// Members run side by side in one process, so none of them may fork, and
+	// they would fight over checkpoint and trace files and progress reports
+	// if each had them. The portfolio never checkpoints or traces, and
+	// reports its members' progress combined from its own thread.
+	SolverOptions shared_options{options_};
+	shared_options.processes = 1;
+	shared_options.checkpoint_file.clear();
+	shared_options.trace_file.clear();
+	shared_options.resume = false;
+	shared_options.progress = nullptr;
+	for (const string& name : SplitPortfolio(options_.portfolio)) {
+		Member member{name, name.substr(0, name.find(':')), shared_options};
+		const string variant{name.substr(min(name.size(),
+					member.type.size() + 1))};
+		if (member.type == little_type_c && !variant.empty())
+		{ member.options.branching = variant; }
+		if (member.type == fast_type_c && !variant.empty())
+		{ member.options.insertion = variant; }
+		members_.push_back(member);
+	}
+}
+
+Path PortfolioTSPSolver::Solve(const Graph& graph) const
+{ return Solve(graph, infinity); }
+
+Path PortfolioTSPSolver::Solve(const Graph& graph, int upper_bound) const {
+	statistics_.Clear();
+	const steady_clock::time_point start{steady_clock::now()};
+	const int num_members{int(members_.size())};
+
+	// filled in by the members' threads
+	mutex results_mutex;
+	condition_variable finished;
+	vector<Path> tours(num_members);
+	vector<exception_ptr> errors(num_members);
+	int num_done{0};
+	int winner{-1};  // the first exact member to finish its search
+	// the latest progress of each member that reports it
+	vector<SolveProgress> progresses(num_members);
+	vector<bool> reported(num_members, false);
+
+	// every member prunes with and adds to the same upper bound, and stops
+	// when the portfolio, or whoever cancels it, is cancelled
+	atomic<int> shared_upper_bound{upper_bound};
+	if (options_.shared_upper_bound)
+	{ shared_upper_bound = options_.shared_upper_bound->load(); }
+	CancellationToken cancellation{options_.cancellation};
+	// only tours that beat every member's are passed on
+	IncumbentReporter incumbent{options_.incumbent};
+	vector<unique_ptr<TSPSolver>> solvers;
+	for (const Member& member : members_) {
+		SolverOptions member_options{member.options};
+		member_options.shared_upper_bound = &shared_upper_bound;
+		member_options.cancellation = &cancellation;
+		if (options_.incumbent) { member_options.incumbent = ref(incumbent); }
+		if (options_.progress) {
+			const int index{int(solvers.size())};
+			member_options.progress = [&, index](const SolveProgress& progress) {
+				lock_guard<mutex> lock{results_mutex};
+				progresses[index] = progress;
+				reported[index] = true;
+			};
+		}
+		solvers.push_back(CreateTSPSolver(member.type, member_options));
+	}
+
+	vector<thread> threads;
+	for (int index{0}; index < num_members; ++index) {
+		threads.emplace_back([&, index] {
+			// a member that fails still counts as done, and stops the others,
+			// since its error is rethrown once they are joined
+			Path tour;
+			try {
+				tour = solvers[index]->Solve(graph, shared_upper_bound.load());
+			} catch (...) {
+				lock_guard<mutex> lock{results_mutex};
+				errors[index] = current_exception();
+				++num_done;
+				cancellation.Cancel();
+				finished.notify_one();
+				return;
+			}
+
+			// heuristic members don't know about the shared bound or the
+			// incumbent callback, so share their tours here
+			if (!tour.vertices.empty()) {
+				int current{shared_upper_bound.load()};
+				while (tour.length < current &&
+						!shared_upper_bound.compare_exchange_weak(
+							current, tour.length)) {}
+				if (options_.incumbent) { incumbent(tour); }
+			}
+
+			lock_guard<mutex> lock{results_mutex};
+			tours[index] = tour;
+			++num_done;
+			const Statistics& statistics{solvers[index]->GetStatistics()};
+			if (winner == -1 && solvers[index]->is_optimal() &&
+					!statistics.Get("cancelled")) {
+				winner = index;
+				cancellation.Cancel();
+			}
+			finished.notify_one();
+		});
+	}
+
+	// wait for a proof or for every member to give up, combining the members'
+	// progress into one report every interval meanwhile
+	{
+		const auto all_done = [&] { return num_done == num_members; };
+		unique_lock<mutex> lock{results_mutex};
+		if (!options_.progress) { finished.wait(lock, all_done); }
+		const duration<double> interval{options_.progress_interval};
+		while (!all_done()) {
+			if (finished.wait_for(lock, interval, all_done)) { break; }
+			// the members' nodes add up, and each one's lower bound holds
+			SolveProgress progress;
+			progress.upper_bound = shared_upper_bound.load();
+			for (int index{0}; index < num_members; ++index) {
+				if (!reported[index]) { continue; }
+				progress.nodes_expanded += progresses[index].nodes_expanded;
+				progress.lower_bound =
+					max(progress.lower_bound, progresses[index].lower_bound);
+			}
+			progress.lower_bound = min(progress.lower_bound, progress.upper_bound);
+			progress.seconds =
+				duration_cast<duration<double>>(steady_clock::now() - start)
+				.count();
+			lock.unlock();
+			options_.progress(progress);
+			lock.lock();
+		}
+	}
+	for (thread& member_thread : threads) { member_thread.join(); }
+	for (const exception_ptr& error : errors)
+	{ if (error) { rethrow_exception(error); } }
+
+	// the winner may have proven another member's tour optimal, so take the
+	// shortest tour any member found
+	int best{-1};
+	for (int index{0}; index < num_members; ++index) {
+		if (tours[index].vertices.empty()) { continue; }
+		if (best == -1 || tours[index].length < tours[best].length)
+		{ best = index; }
+	}
+
+	for (int index{0}; index < num_members; ++index) {
+		for (const auto& counter : solvers[index]->GetStatistics().GetCounters())
+		{ statistics_.Set(members_[index].name + "." + counter.first,
+				counter.second); }
+	}
+	statistics_.Set("winner", winner);
+	// no exact member finished, so the tour isn't proven optimal
+	if (winner == -1 && is_optimal()) { statistics_.Set("cancelled", 1); }
+	if (options_.shared_upper_bound && best != -1) {
+		int current{options_.shared_upper_bound->load()};
+		while (tours[best].length < current &&
+				!options_.shared_upper_bound->compare_exchange_weak(
+					current, tours[best].length)) {}
+	}
+
+	// every member's lower bound holds, so the highest is the best
+	bool has_lower_bound{false};
+	long long lower_bound{0};
+	for (const unique_ptr<TSPSolver>& solver : solvers) {
+		const Statistics& statistics{solver->GetStatistics()};
+		if (!statistics.GetCounters().count("lower_bound")) { continue; }
+		has_lower_bound = true;
+		lower_bound = max(lower_bound, statistics.Get("lower_bound"));
+	}
+	if (has_lower_bound) { statistics_.Set("lower_bound", lower_bound); }
+
+	if (best == -1) { return Path{}; }
+	return tours[best];
+}
+
+vector<string> SplitPortfolio(const string& portfolio) {
+	vector<string> members;
+	istringstream stream{portfolio};
+	string member;
+	while (getline(stream, member, ',')) { members.push_back(member); }
+	return members;
+}
+
+bool IsExactPortfolio(const string& portfolio) {
+	if (!IsValidPortfolio(portfolio)) { return false; }
+	for (const string& member : SplitPortfolio(portfolio)) {
+		if (CreateTSPSolver(member.substr(0, member.find(':')))->is_optimal())
+		{ return true; }
+	}
+	return false;
+}
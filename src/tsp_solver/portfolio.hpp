@@ -0,0 +1,40 @@
+#ifndef TSP_SOLVER_PORTFOLIO_H
+#define TSP_SOLVER_PORTFOLIO_H
+
+#include <string>
+#include <vector>
+
+#include "tsp_solver/options.hpp"
+#include "tsp_solver/tsp_solver.hpp"
+
+// Whether every member in a comma separated portfolio, like
+// "fast,little,little:reliability", names a solver other than a portfolio.
+// A little member may name a branching rule after a colon, and a fast member
+// an insertion type.
+bool IsValidPortfolio(const std::string& portfolio);
+
+/* Races several solvers on the same graph, each on its own thread. They share
+ * one upper bound, so exact members prune with the tours of heuristic ones, and
+ * the first exact member to finish cancels the rest. The shortest tour any
+ * member found is returned, and is optimal once an exact member has finished.
+ */
+class PortfolioTSPSolver : public TSPSolver {
+public:
+	explicit PortfolioTSPSolver(const SolverOptions& options);
+
+	Path Solve(const Graph&) const override;
+	Path Solve(const Graph&, int upper_bound) const override;
+
+private:
+	// a solver type and the options it runs with
+	struct Member {
+		std::string name;
+		std::string type;
+		SolverOptions options;
+	};
+
+	SolverOptions options_;
+	std::vector<Member> members_;
+};
+
+#endif  // TSP_SOLVER_PORTFOLIO_H
@@ -0,0 +1,58 @@
+#include "tsp_solver/portfolio.hpp"
+
+#include <cstdio>
+
+#include <fstream>
+#include <memory>
+#include <vector>
+
+#include "graph/graph.hpp"
+#include "path.hpp"
+#include "test_util.hpp"
+#include "tsp_solver/options.hpp"
+#include "tsp_solver/progress.hpp"
+#include "util.hpp"
+
+#include "gtest/gtest.h"
+
+using std::ifstream;
+using std::unique_ptr;
+using std::vector;
+
+TEST(PortfolioTest, MemberErrorIsRethrown) {
+	// the naive solver can't take more than 64 vertices
+	unique_ptr<Graph> graph{MakeRandomGraph(70, 100, 13)};
+	SolverOptions options;
+	options.portfolio = "naive,fast";
+	EXPECT_THROW(PortfolioTSPSolver{options}.Solve(*graph), Error);
+}
+
+TEST(PortfolioTest, MembersDontCheckpoint) {
+	unique_ptr<Graph> graph{MakeRandomGraph(8, 100, 13)};
+	SolverOptions options;
+	options.portfolio = "little,little:reliability";
+	options.checkpoint_file = "portfolio_test.checkpoint";
+	options.processes = 2;
+	const Path tour{PortfolioTSPSolver{options}.Solve(*graph)};
+	EXPECT_EQ(8, int(tour.vertices.size()));
+	EXPECT_FALSE(ifstream{options.checkpoint_file}.good());
+	std::remove(options.checkpoint_file.c_str());
+}
+
+TEST(PortfolioTest, ReportsCombinedProgress) {
+	unique_ptr<Graph> graph{MakeRandomGraph(25, 100, 13)};
+	SolverOptions options;
+	options.portfolio = "little,little:reliability";
+	options.progress_interval = 0.001;
+	vector<SolveProgress> reports;
+	options.progress = [&reports](const SolveProgress& progress)
+	{ reports.push_back(progress); };
+	const Path tour{PortfolioTSPSolver{options}.Solve(*graph)};
+	EXPECT_FALSE(reports.empty());
+	for (const SolveProgress& progress : reports) {
+		EXPECT_LE(progress.lower_bound, tour.length);
+		EXPECT_GE(progress.upper_bound, tour.length);
+	}
+	for (size_t i{1}; i < reports.size(); ++i)
+	{ EXPECT_LE(reports[i - 1].seconds, reports[i].seconds); }
+}
@@ -0,0 +1,27 @@
+#include "tsp_solver/progress.hpp"
+
+#include <mutex>
+
+#include "path.hpp"
+#include "tsp_solver/options.hpp"
+
+using std::lock_guard;
+using std::mutex;
+
+void IncumbentReporter::operator()(const Path& tour) {
+	lock_guard<mutex> lock{mutex_};
+	if (!callback_ || tour.vertices.empty() || tour.length >= reported_)
+	{ return; }
+	reported_ = tour.length;
+	callback_(tour);
+}
+
+void ShareTour(const Path& tour, const SolverOptions& options) {
+	if (options.incumbent) { options.incumbent(tour); }
+	if (options.shared_upper_bound) {
+		int current{options.shared_upper_bound->load()};
+		while (tour.length < current &&
+				!options.shared_upper_bound->compare_exchange_weak(
+					current, tour.length)) {}
+	}
+}
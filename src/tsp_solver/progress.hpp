@@ -0,0 +1,50 @@
+#ifndef TSP_SOLVER_PROGRESS_H
+#define TSP_SOLVER_PROGRESS_H
+
+#include <functional>
+#include <limits>
+#include <mutex>
+
+struct Path;
+struct SolverOptions;
+
+// A snapshot of a running search, passed to SolverOptions::progress.
+struct SolveProgress {
+	// nodes of the search tree expanded so far
+	long long nodes_expanded{0};
+	// the length of the shortest tour found so far, or the upper bound the
+	// solve started with
+	int upper_bound{0};
+	// no tour is shorter than this
+	int lower_bound{0};
+	// since the solve started
+	double seconds{0};
+};
+
+using ProgressCallback = std::function<void(const SolveProgress&)>;
+
+// called with each tour a solver finds that is shorter than those before it
+using IncumbentCallback = std::function<void(const Path&)>;
+
+// Passes tours on to an incumbent callback one at a time, and only those
+// shorter than every tour passed on before, for solvers whose tours come from
+// several searches at once.
+class IncumbentReporter {
+public:
+	explicit IncumbentReporter(const IncumbentCallback& callback) :
+		callback_{callback}, reported_{std::numeric_limits<int>::max()} {}
+
+	void operator()(const Path& tour);
+
+private:
+	IncumbentCallback callback_;
+	std::mutex mutex_;
+	int reported_;  // the length of the last tour passed on
+};
+
+// Pass the tour to the options' incumbent callback and shared upper bound, so
+// whoever is waiting on a heuristic can use it before its time budget runs
+// out. Not safe to call from several threads at once unless the callback is.
+void ShareTour(const Path& tour, const SolverOptions& options);
+
+#endif  // TSP_SOLVER_PROGRESS_H
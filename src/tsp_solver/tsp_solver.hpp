@@ -1,6 +1,8 @@
 #ifndef TSP_SOLVER_TSP_SOLVER_H
 #define TSP_SOLVER_TSP_SOLVER_H
 
+#include "statistics.hpp"
+
 // forward declarations
 class Graph;
 struct Path;
@@ -11,18 +13,27 @@ struct Path;
 class TSPSolver {
 public:
 	TSPSolver(bool optimal) : optimal_{optimal} {}
-	~TSPSolver() {}
+	virtual ~TSPSolver() {}
 
 	// solve the TSP for the given graph
 	virtual Path Solve(const Graph&) const = 0;
 
 	// allows an upper bound to be passed in (useful for optimal solvers)
 	// by default, just calls the Solve member function
+	// A solver that finds no tour, because none is shorter than the upper
+	// bound or it was cancelled first, returns an empty path of length 0.
 	virtual Path Solve(const Graph&, int upper_bound) const;
 
 	// get information about the TSP solver
 	bool is_optimal() const { return optimal_; }
 
+	// counters describing the last call to Solve
+	const Statistics& GetStatistics() const { return statistics_; }
+
+protected:
+	// Solve is const, so solvers record their statistics in a mutable member
+	mutable Statistics statistics_;
+
 private:
 	bool optimal_;
 };
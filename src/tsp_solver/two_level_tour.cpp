@@ -0,0 +1,199 @@
+#include "tsp_solver/two_level_tour.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using std::abs;
+using std::max;
+using std::min;
+using std::sqrt;
+using std::swap;
+using std::vector;
+
+TwoLevelTour::TwoLevelTour(const vector<int>& vertices) :
+		positions_(vertices.size()), segment_of_(vertices.size()),
+		segment_size_{max(1, int(sqrt(double(vertices.size()))))} {
+	Rebuild(vertices);
+}
+
+int TwoLevelTour::Next(int vertex) const {
+	const Segment& segment{segments_[segment_of_[vertex]]};
+	const int position{positions_[vertex]};
+	if (!segment.reversed && position + 1 < segment.end)
+	{ return vertices_[position + 1]; }
+	if (segment.reversed && position > segment.begin)
+	{ return vertices_[position - 1]; }
+	const int rank{segment.rank + 1 == int(order_.size()) ? 0 :
+		segment.rank + 1};
+	return First(order_[rank]);
+}
+
+int TwoLevelTour::Prev(int vertex) const {
+	const Segment& segment{segments_[segment_of_[vertex]]};
+	const int position{positions_[vertex]};
+	if (!segment.reversed && position > segment.begin)
+	{ return vertices_[position - 1]; }
+	if (segment.reversed && position + 1 < segment.end)
+	{ return vertices_[position + 1]; }
+	const int rank{segment.rank == 0 ? int(order_.size()) - 1 :
+		segment.rank - 1};
+	return Last(order_[rank]);
+}
+
+void TwoLevelTour::TwoOptMove(int a, int b, int c, int) {
+	if (Next(a) == b) { Reverse(b, c); }
+	else { Reverse(c, b); }
+}
+
+vector<int> TwoLevelTour::GetVertices(int first) const {
+	vector<int> vertices{first};
+	for (int vertex{Next(first)}; vertex != first; vertex = Next(vertex))
+	{ vertices.push_back(vertex); }
+	return vertices;
+}
+
+int TwoLevelTour::First(int segment) const {
+	const Segment& s{segments_[segment]};
+	return vertices_[s.reversed ? s.end - 1 : s.begin];
+}
+
+int TwoLevelTour::Last(int segment) const {
+	const Segment& s{segments_[segment]};
+	return vertices_[s.reversed ? s.begin : s.end - 1];
+}
+
+void TwoLevelTour::Reverse(int first, int last) {
+	if (first == last) { return; }
+
+	// a short part of the tour, or a short rest of it, is reversed by moving
+	// its vertices, as in an ArrayTour
+	int length{ShortLength(first, last)};
+	if (length > 0) {
+		SwapReverse(first, last, length);
+		return;
+	}
+	const int rest_first{Next(last)};
+	const int rest_last{Prev(first)};
+	length = ShortLength(rest_first, rest_last);
+	if (length > 0) {
+		SwapReverse(rest_first, rest_last, length);
+		return;
+	}
+
+	SplitBefore(first);
+	SplitAfter(last);
+	const int num_segments{int(order_.size())};
+	int i{segments_[segment_of_[first]].rank};
+	int j{segments_[segment_of_[last]].rank};
+	int num_reversed{(j - i + num_segments) % num_segments + 1};
+	// reversing the other segments gives the same cycle
+	if (2 * num_reversed > num_segments) {
+		const int rest_rank{j + 1 == num_segments ? 0 : j + 1};
+		j = i == 0 ? num_segments - 1 : i - 1;
+		i = rest_rank;
+		num_reversed = num_segments - num_reversed;
+	}
+	// reverse the order of the segments, then flip each of them
+	for (int left{i}, right{j}, swaps{0}; swaps < num_reversed / 2; ++swaps) {
+		swap(order_[left], order_[right]);
+		left = left + 1 == num_segments ? 0 : left + 1;
+		right = right == 0 ? num_segments - 1 : right - 1;
+	}
+	for (int rank{i}, flipped{0}; flipped < num_reversed; ++flipped) {
+		Segment& flip{segments_[order_[rank]]};
+		flip.reversed = !flip.reversed;
+		flip.rank = rank;
+		rank = rank + 1 == num_segments ? 0 : rank + 1;
+	}
+
+	if (int(order_.size()) > 2 * (size() / segment_size_ + 1))
+	{ Rebuild(GetVertices(vertices_[0])); }
+}
+
+int TwoLevelTour::ShortLength(int first, int last) const {
+	const Segment& first_segment{segments_[segment_of_[first]]};
+	const Segment& last_segment{segments_[segment_of_[last]]};
+	const int first_position{positions_[first]};
+	const int last_position{positions_[last]};
+	if (&first_segment == &last_segment) {
+		if ((first_position <= last_position) == first_segment.reversed)
+		{ return 0; }
+		return abs(last_position - first_position) + 1;
+	}
+	const int next_rank{first_segment.rank + 1 == int(order_.size()) ? 0 :
+		first_segment.rank + 1};
+	if (last_segment.rank != next_rank) { return 0; }
+	// the rest of the first segment and the start of the next
+	return (first_segment.reversed ? first_position - first_segment.begin + 1 :
+			first_segment.end - first_position) +
+		(last_segment.reversed ? last_segment.end - last_position :
+			last_position - last_segment.begin + 1);
+}
+
+void TwoLevelTour::SwapReverse(int first, int last, int length) {
+	for (int swaps{0}; swaps < length / 2; ++swaps) {
+		const int next_first{Next(first)};
+		const int prev_last{Prev(last)};
+		// the two vertices trade places, and segments
+		swap(positions_[first], positions_[last]);
+		swap(segment_of_[first], segment_of_[last]);
+		vertices_[positions_[first]] = first;
+		vertices_[positions_[last]] = last;
+		first = next_first;
+		last = prev_last;
+	}
+}
+
+void TwoLevelTour::SplitBefore(int vertex) {
+	const int segment{segment_of_[vertex]};
+	if (First(segment) == vertex) { return; }
+	const int position{positions_[vertex]};
+	Split(segment, segments_[segment].reversed ? position + 1 : position);
+}
+
+void TwoLevelTour::SplitAfter(int vertex) {
+	const int segment{segment_of_[vertex]};
+	if (Last(segment) == vertex) { return; }
+	const int position{positions_[vertex]};
+	Split(segment, segments_[segment].reversed ? position : position + 1);
+}
+
+void TwoLevelTour::Split(int segment, int index) {
+	Segment kept{segments_[segment]};
+	// the smaller part becomes the new segment, so fewer vertices change
+	// segments
+	const bool low_moves{index - kept.begin < kept.end - index};
+	Segment added{low_moves ? kept.begin : index, low_moves ? index : kept.end,
+		kept.reversed, 0};
+	if (low_moves) { kept.begin = index; }
+	else { kept.end = index; }
+
+	const int added_segment{int(segments_.size())};
+	for (int position{added.begin}; position < added.end; ++position)
+	{ segment_of_[vertices_[position]] = added_segment; }
+	// the low part comes first in the tour unless the segment is reversed
+	const int rank{low_moves != kept.reversed ? kept.rank : kept.rank + 1};
+	order_.insert(order_.begin() + rank, added_segment);
+	segments_[segment] = kept;
+	segments_.push_back(added);
+	for (int i{rank}; i < int(order_.size()); ++i)
+	{ segments_[order_[i]].rank = i; }
+}
+
+void TwoLevelTour::Rebuild(const vector<int>& vertices) {
+	vertices_ = vertices;
+	segments_.clear();
+	order_.clear();
+	for (int begin{0}; begin < size(); begin += segment_size_) {
+		const int segment{int(segments_.size())};
+		segments_.push_back(Segment{begin,
+				min(begin + segment_size_, size()), false, segment});
+		order_.push_back(segment);
+	}
+	for (int position{0}; position < size(); ++position) {
+		positions_[vertices_[position]] = position;
+		segment_of_[vertices_[position]] = position / segment_size_;
+	}
+}
@@ -0,0 +1,73 @@
+#ifndef TSP_SOLVER_TWO_LEVEL_TOUR_H
+#define TSP_SOLVER_TWO_LEVEL_TOUR_H
+
+#include <vector>
+
+// tours with at least this many vertices change faster as a TwoLevelTour than
+// as an ArrayTour, by timing local search on random points
+const int two_level_tour_size_c{20000};
+
+/* A tour for local search on large graphs, with the same interface as
+ * ArrayTour. The array of vertices is cut into segments of about sqrt(N)
+ * vertices, kept in tour order in a second list, and each segment may be read
+ * backwards. Reversing a long part of the tour splits the segments at its ends
+ * and then reverses the order of the segments between them and flips each
+ * one, so it takes O(sqrt(N)) time however long the part is, where ArrayTour
+ * moves up to N / 2 vertices. Parts within two segments are reversed by
+ * swapping their vertices. Once splits have doubled the number of segments, the
+ * array is rewritten in tour order and cut evenly again.
+ */
+class TwoLevelTour {
+public:
+	explicit TwoLevelTour(const std::vector<int>& vertices);
+
+	int Next(int vertex) const;
+	int Prev(int vertex) const;
+	int size() const { return int(vertices_.size()); }
+
+	// remove the edges (a, b) and (c, d) and add (a, c) and (b, d), where b
+	// follows a if and only if d follows c
+	void TwoOptMove(int a, int b, int c, int d);
+
+	// the vertices in tour order, starting with the given one
+	std::vector<int> GetVertices(int first) const;
+
+private:
+	// a range of vertices_, read from end to begin if reversed
+	struct Segment {
+		int begin;
+		int end;
+		bool reversed;
+		int rank;  // its index in order_
+	};
+
+	int First(int segment) const;
+	int Last(int segment) const;
+
+	// reverse the vertices from first to last, going forward
+	void Reverse(int first, int last);
+	// the number of vertices from first to last, going forward, if they are in
+	// the same segment or the next one, 0 if not
+	int ShortLength(int first, int last) const;
+	// reverse the given number of vertices from first to last, going forward,
+	// by swapping the vertices at either end
+	void SwapReverse(int first, int last, int length);
+	// make the vertex the first or last of its segment
+	void SplitBefore(int vertex);
+	void SplitAfter(int vertex);
+	// cut the segment in two at the given index of vertices_
+	void Split(int segment, int index);
+	// lay out vertices_ in tour order, cut into even segments
+	void Rebuild(const std::vector<int>& vertices);
+
+	std::vector<int> vertices_;
+	// for each vertex, its index in vertices_ and its segment
+	std::vector<int> positions_;
+	std::vector<int> segment_of_;
+	std::vector<Segment> segments_;
+	// the segments in tour order
+	std::vector<int> order_;
+	int segment_size_;
+};
+
+#endif  // TSP_SOLVER_TWO_LEVEL_TOUR_H
@@ -0,0 +1,192 @@
+////////////////////////////////////////////////////////////////////////////////
+// Generator of random instances for littletsp
+////////////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "graph/generator.hpp"
+#include "graph/instance.hpp"
+#include "util.hpp"
+
+#include <gflags/gflags.h>
+
+using std::atomic;
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::lock_guard;
+using std::mutex;
+using std::ofstream;
+using std::seed_seq;
+using std::string;
+using std::thread;
+using std::vector;
+
+static bool ValidateDistribution(const char* flag_name, const string& value);
+static bool ValidateFormat(const char* flag_name, const string& value);
+static bool ValidatePositive(const char* flag_name, int value);
+static bool ValidateNonNegative(const char* flag_name, int value);
+static bool ValidateFraction(const char* flag_name, double value);
+
+DEFINE_string(distribution, InstanceSpec{}.distribution,
+		"How the points are spread: uniform, clustered, grid or duplicates");
+DEFINE_int32(points, InstanceSpec{}.num_points, "Points in each instance");
+DEFINE_int32(max_points, 0,
+		"If more than --points, each case has from --points to this many");
+DEFINE_int32(world_size, InstanceSpec{}.world_size,
+		"Largest x or y coordinate of a point");
+DEFINE_int32(clusters, InstanceSpec{}.clusters,
+		"Centers clustered points are spread around");
+DEFINE_double(spread, InstanceSpec{}.spread,
+		"Standard deviation of clustered points as a fraction of the world");
+DEFINE_double(jitter, InstanceSpec{}.jitter,
+		"Fraction of a grid cell grid points are moved by");
+DEFINE_double(duplicate_fraction, InstanceSpec{}.duplicate_fraction,
+		"Probability a duplicates point repeats an earlier one");
+DEFINE_uint64(seed, InstanceSpec{}.seed, "Seed for the instances");
+DEFINE_string(format, "text", "Format to write instances in: text or binary");
+DEFINE_string(output_dir, "",
+		"Directory to write --cases instances to instead of stdout");
+DEFINE_int32(cases, 1, "Instances to write to --output_dir");
+DEFINE_int32(threads, 1, "Threads to write the instances with");
+
+const bool distribution_validated{gflags::RegisterFlagValidator(
+		&FLAGS_distribution, &ValidateDistribution)};
+const bool points_validated{gflags::RegisterFlagValidator(
+		&FLAGS_points, &ValidateNonNegative)};
+const bool max_points_validated{gflags::RegisterFlagValidator(
+		&FLAGS_max_points, &ValidateNonNegative)};
+const bool world_size_validated{gflags::RegisterFlagValidator(
+		&FLAGS_world_size, &ValidatePositive)};
+const bool clusters_validated{gflags::RegisterFlagValidator(
+		&FLAGS_clusters, &ValidatePositive)};
+const bool jitter_validated{gflags::RegisterFlagValidator(
+		&FLAGS_jitter, &ValidateFraction)};
+const bool duplicate_fraction_validated{gflags::RegisterFlagValidator(
+		&FLAGS_duplicate_fraction, &ValidateFraction)};
+const bool format_validated{gflags::RegisterFlagValidator(
+		&FLAGS_format, &ValidateFormat)};
+const bool cases_validated{gflags::RegisterFlagValidator(
+		&FLAGS_cases, &ValidatePositive)};
+const bool threads_validated{gflags::RegisterFlagValidator(
+		&FLAGS_threads, &ValidatePositive)};
+
+// The description of a case. Each case has a seed of its own, made from --seed
+// and the case's number, so a case is the same however many there are and
+// whichever thread writes it.
+static InstanceSpec MakeSpec(int case_num) {
+	InstanceSpec spec;
+	spec.distribution = FLAGS_distribution;
+	spec.world_size = FLAGS_world_size;
+	spec.clusters = FLAGS_clusters;
+	spec.spread = FLAGS_spread;
+	spec.jitter = FLAGS_jitter;
+	spec.duplicate_fraction = FLAGS_duplicate_fraction;
+	seed_seq seeds{unsigned(FLAGS_seed), unsigned(FLAGS_seed >> 32),
+		unsigned(case_num)};
+	unsigned seed[2];
+	seeds.generate(seed, seed + 2);
+	spec.seed = seed[0];
+	spec.num_points = FLAGS_points;
+	if (FLAGS_max_points > FLAGS_points)
+	{ spec.num_points += int(seed[1] % (FLAGS_max_points - FLAGS_points + 1)); }
+	return spec;
+}
+
+// named like the cases test/utility.py writes, so its scripts can run them
+static string MakeCaseName(int case_num) {
+	char name[64];
+	std::snprintf(name, sizeof(name), "/generated-case-%03d.%s", case_num,
+			FLAGS_format == "binary" ? "bin" : "txt");
+	return FLAGS_output_dir + name;
+}
+
+int main(int argc, char** argv) {
+	gflags::SetUsageMessage(
+			"Writes random instances for littletsp.\n"
+			"Usage:\n"
+			"\t--distribution\t\tHow the points are spread (Default: uniform, "
+			"options: uniform, clustered, grid, duplicates)\n"
+			"\t--points\t\tPoints in each instance (Default: 10)\n"
+			"\t--max_points\t\tGive each case from --points to this many "
+			"points (Default: 0, off)\n"
+			"\t--world_size\t\tLargest x or y coordinate (Default: 100)\n"
+			"\t--clusters\t\tCenters of clustered points (Default: 8)\n"
+			"\t--spread\t\tStandard deviation of clustered points as a "
+			"fraction of the world size (Default: 0.05)\n"
+			"\t--jitter\t\tFraction of a cell grid points are moved by "
+			"(Default: 0.25)\n"
+			"\t--duplicate_fraction\tProbability a point repeats an earlier "
+			"one in duplicates (Default: 0.5)\n"
+			"\t--seed\t\t\tSeed for the instances (Default: 1)\n"
+			"\t--format\t\tWrite text or binary instances (Default: text)\n"
+			"\t--output_dir\t\tWrite --cases instances to this directory "
+			"instead of one to stdout\n"
+			"\t--cases\t\t\tInstances to write to --output_dir (Default: 1)\n"
+			"\t--threads\t\tThreads to write the instances with "
+			"(Default: 1)\n"
+			"\n"
+			"Example:\n"
+			"\ttspgen --distribution=clustered --points=1000000 > big.txt\n"
+			"\ttspgen --output_dir=test --cases=100 --points=14 "
+			"--max_points=16 --threads=8\n");
+	gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+	try {
+		if (FLAGS_output_dir.empty()) {
+			WriteInstance(cout, MakeSpec(0), FLAGS_format);
+			return 0;
+		}
+
+		// threads take the cases in turn, and the first error stops them all
+		atomic<int> next_case{0};
+		mutex error_mutex;
+		// every Error's message is a literal, so the pointer outlives it
+		const char* error{nullptr};
+		auto run = [&] {
+			for (int case_num{next_case++}; case_num < FLAGS_cases;
+					case_num = next_case++) {
+				try {
+					const string name{MakeCaseName(case_num)};
+					ofstream output{name, std::ios::binary};
+					if (!output) { throw Error{"Couldn't open a case file!"}; }
+					WriteInstance(output, MakeSpec(case_num), FLAGS_format);
+				} catch (Error& e) {
+					lock_guard<mutex> lock{error_mutex};
+					error = e.what();
+					next_case = FLAGS_cases;
+				}
+			}
+		};
+		vector<thread> threads;
+		for (int i{1}; i < FLAGS_threads; ++i) { threads.emplace_back(run); }
+		run();
+		for (thread& t : threads) { t.join(); }
+		if (error) { throw Error{error}; }
+	} catch (Error& e) {
+		cerr << "Error: " << e.what() << endl;
+		return 1;
+	}
+	return 0;
+}
+
+bool ValidateDistribution(const char*, const string& value)
+{ return IsValidDistribution(value); }
+
+bool ValidateFormat(const char*, const string& value)
+{ return IsValidInstanceFormat(value); }
+
+bool ValidatePositive(const char*, int value) { return value > 0; }
+
+bool ValidateNonNegative(const char*, int value) { return value >= 0; }
+
+bool ValidateFraction(const char*, double value)
+{ return value >= 0 && value <= 1; }
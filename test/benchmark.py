@@ -1,7 +1,8 @@
 #! /usr/bin/env python3
 
 """
-Benchmarking script to output times for the current build of little-tsp
+Benchmarking script to output times for the current build of little-tsp, and
+to compare the times of two builds
 """
 
 __author__ = "karepker@gmail.com (Kar Epker)"
@@ -9,16 +10,248 @@ __copyright__ = "2014 Kar Epker (karepker@gmail.com)"
 
 
 import argparse
+import json
+import math
+import os
+import statistics
+import sys
 
 import utility
 
 DEFAULT_NUM_CASES = 100
 DEFAULT_NUM_POINTS = (14, 16)
 DEFAULT_MAP_SIZE = 100
+DEFAULT_SOLVER = 'little'
+DEFAULT_WARMUP = 1
+DEFAULT_REPETITIONS = 10
+DEFAULT_ALPHA = 0.01
+DEFAULT_THRESHOLD = 0.05
+
+
+def percentile(times, fraction):
+    """
+    Find a percentile of some times, interpolating between the closest two
+
+    Args:
+        times (list of floats): The times, sorted
+        fraction (float): How far through the times the percentile is, from 0
+            to 1
+
+    Returns:
+        The time at that percentile
+    """
+    position = fraction * (len(times) - 1)
+    lower = int(math.floor(position))
+    upper = min(lower + 1, len(times) - 1)
+    return times[lower] + (times[upper] - times[lower]) * (position - lower)
+
+
+def summarize(times):
+    """
+    Summarize the times of the runs of some cases
+
+    Args:
+        times (list of floats): The times of the runs
+
+    Returns:
+        A dict of the median, 95th and 99th percentiles, mean and variance
+    """
+    times = sorted(times)
+    return {
+        'runs': len(times),
+        'median': percentile(times, 0.5),
+        'p95': percentile(times, 0.95),
+        'p99': percentile(times, 0.99),
+        'mean': statistics.mean(times),
+        'variance': statistics.variance(times) if len(times) > 1 else 0.0,
+    }
+
+
+def mann_whitney_u(first, second):
+    """
+    Test whether two samples of times come from the same distribution with the
+    Mann-Whitney U test, which doesn't assume times are normally distributed.
+    The p-value comes from the normal approximation with a correction for ties,
+    which is close enough from about 8 runs per sample.
+
+    Args:
+        first (list of floats): The times of one build
+        second (list of floats): The times of the other build
+
+    Returns:
+        The two-sided p-value
+    """
+    # rank both samples together, giving ties the average of their ranks
+    pooled = sorted([(time, 0) for time in first] +
+                    [(time, 1) for time in second])
+    ranks = [0.0] * len(pooled)
+    tie_correction = 0.0
+    start = 0
+    while start < len(pooled):
+        end = start
+        while end + 1 < len(pooled) and pooled[end + 1][0] == pooled[start][0]:
+            end += 1
+        for index in range(start, end + 1):
+            ranks[index] = (start + end) / 2.0 + 1
+        tied = end - start + 1
+        tie_correction += tied ** 3 - tied
+        start = end + 1
+
+    num_first, num_second = len(first), len(second)
+    total = num_first + num_second
+    rank_sum = sum(rank for rank, (_, sample) in zip(ranks, pooled)
+                   if sample == 0)
+    u_statistic = rank_sum - num_first * (num_first + 1) / 2.0
+    mean = num_first * num_second / 2.0
+    variance = num_first * num_second / 12.0 * (
+            total + 1 - tie_correction / (total * (total - 1)))
+    if variance <= 0:
+        return 1.0
+    z_score = (abs(u_statistic - mean) - 0.5) / math.sqrt(variance)
+    return min(1.0, math.erfc(max(z_score, 0.0) / math.sqrt(2)))
+
+
+def choose_cpus(cpus):
+    """
+    Choose the cores to pin the binary to
+
+    Args:
+        cpus (string): Comma separated core numbers, or empty to choose the
+            highest numbered core this process may run on
+
+    Returns:
+        A set of core numbers, or None if this platform can't pin processes
+    """
+    if not hasattr(os, 'sched_getaffinity'):
+        return None
+    if cpus:
+        return set(int(cpu) for cpu in cpus.split(','))
+    # the highest numbered core is the least likely to be handling interrupts
+    return {max(os.sched_getaffinity(0))}
+
+
+def run_benchmarks(args):
+    """
+    Run the binary on every case, grouping the times by number of points
+
+    Args:
+        args: The parsed command line arguments
+
+    Returns:
+        A dict of the settings, the runs of each case and a summary for each
+        number of points
+    """
+    command = [args.binary, '--solver=' + args.solver, '--stats'] + args.flags
+    cpus = choose_cpus(args.cpus)
+    cases = {}
+    for case_filename in utility.iterate_cases():
+        # the first runs warm up the page cache and the CPU's clock
+        for _ in range(args.warmup):
+            utility.run_solution(command, case_filename, cpus=cpus)
+        times = []
+        for _ in range(args.repetitions):
+            elapsed, output, error = utility.run_solution(
+                    command, case_filename, cpus=cpus)
+            times.append(elapsed)
+        cases[os.path.basename(case_filename)] = {
+            'points': utility.read_num_points(case_filename),
+            'times': times,
+            'length': int(output.split()[0]),
+            'statistics': utility.parse_statistics(error),
+        }
+        print('{}: median {:.4f}s'.format(
+                os.path.basename(case_filename), statistics.median(times)),
+              file=sys.stderr)
+
+    by_points = {}
+    for case in cases.values():
+        by_points.setdefault(case['points'], []).extend(case['times'])
+    return {
+        'command': command,
+        'cpus': sorted(cpus) if cpus is not None else None,
+        'warmup': args.warmup,
+        'repetitions': args.repetitions,
+        'cases': cases,
+        'summary': {str(points): summarize(times)
+                    for points, times in sorted(by_points.items())},
+    }
+
+
+def print_summary(results):
+    """
+    Print a table of the times for each number of points
+
+    Args:
+        results (dict): The results run_benchmarks returned
+    """
+    header_format = '{:>6} | {:>6} | {:>10} | {:>10} | {:>10} | {:>12}'
+    print(header_format.format(
+            'Points', 'Runs', 'Median (s)', 'p95 (s)', 'p99 (s)', 'Variance'))
+    print('{:->6}-+-{:->6}-+-{:->10}-+-{:->10}-+-{:->10}-+-{:->12}'.format(
+            '', '', '', '', '', ''))
+    for points, summary in results['summary'].items():
+        print('{:>6} | {:>6} | {:>10.4f} | {:>10.4f} | {:>10.4f} | '
+              '{:>12.3e}'.format(points, summary['runs'], summary['median'],
+                                 summary['p95'], summary['p99'],
+                                 summary['variance']))
+
+
+def compare(base, new, alpha, threshold):
+    """
+    Compare the times of the cases two result files share. A case regressed if
+    its median time rose by more than the threshold and the rise is
+    significant.
+
+    Args:
+        base (dict): The results of the build compared against
+        new (dict): The results of the build being checked
+        alpha (float): The p-value below which a change is significant
+        threshold (float): The fraction of the base median a change must
+            exceed to count
+
+    Returns:
+        The number of cases that regressed
+    """
+    row_format = '{:<28} | {:>6} | {:>10} | {:>10} | {:>8} | {:>8} | {}'
+    print(row_format.format('Case', 'Points', 'Base (s)', 'New (s)', 'Change',
+                            'p-value', ''))
+    regressions = 0
+    ratios_by_points = {}
+    for name in sorted(set(base['cases']) & set(new['cases'])):
+        base_case, new_case = base['cases'][name], new['cases'][name]
+        base_median = statistics.median(base_case['times'])
+        new_median = statistics.median(new_case['times'])
+        change = new_median / base_median - 1 if base_median else 0.0
+        p_value = mann_whitney_u(base_case['times'], new_case['times'])
+        significant = p_value < alpha and abs(change) > threshold
+        verdict = ''
+        if significant:
+            verdict = 'REGRESSION' if change > 0 else 'improvement'
+            regressions += change > 0
+        if base_case['length'] != new_case['length']:
+            verdict += ' (length {} -> {})'.format(
+                    base_case['length'], new_case['length'])
+        ratios_by_points.setdefault(base_case['points'], []).append(
+                1 + change)
+        print(row_format.format(
+                name, base_case['points'], '{:.4f}'.format(base_median),
+                '{:.4f}'.format(new_median), '{:+.1%}'.format(change),
+                '{:.4f}'.format(p_value), verdict))
+
+    # the geometric mean weighs speedups and slowdowns of each case evenly
+    print()
+    for points, ratios in sorted(ratios_by_points.items()):
+        mean_ratio = math.exp(statistics.mean(
+                math.log(ratio) for ratio in ratios if ratio > 0))
+        print('{} points: new build takes {:.3f}x the time'.format(
+                points, mean_ratio))
+    return regressions
+
 
 if __name__ == '__main__':
     PARSER = argparse.ArgumentParser(
-            description='Benchmark the little-tsp binary')
+            description='Benchmark the little-tsp binary, or compare two '
+            'benchmark result files')
     PARSER.add_argument(
             '--generate', dest='generate', action='store_true',
             help='Whether to generate new cases or not')
@@ -26,15 +259,60 @@ if __name__ == '__main__':
             '--no-generate', dest='generate', action='store_false',
             help='Whether to generate new cases or not')
     PARSER.set_defaults(generate=False)
+    PARSER.add_argument(
+            '--binary', default=utility.PROJECT_BINARY,
+            help='The littletsp binary to benchmark')
+    PARSER.add_argument(
+            '--solver', default=DEFAULT_SOLVER,
+            help='The solver to benchmark')
+    PARSER.add_argument(
+            '--flag', dest='flags', action='append', default=[],
+            help='A flag to pass on to the binary, may be repeated')
+    PARSER.add_argument(
+            '--warmup', type=int, default=DEFAULT_WARMUP,
+            help='Untimed runs of each case before the timed ones')
+    PARSER.add_argument(
+            '--repetitions', type=int, default=DEFAULT_REPETITIONS,
+            help='Timed runs of each case')
+    PARSER.add_argument(
+            '--cpus', default='',
+            help='Comma separated cores to pin the binary to (default: the '
+            'highest numbered one available)')
+    PARSER.add_argument(
+            '--output', help='File to write the results to as JSON')
+    PARSER.add_argument(
+            '--compare', nargs=2, metavar=('BASE', 'NEW'),
+            help='Compare two result files instead of running the binary')
+    PARSER.add_argument(
+            '--alpha', type=float, default=DEFAULT_ALPHA,
+            help='p-value below which a change in time is significant')
+    PARSER.add_argument(
+            '--threshold', type=float, default=DEFAULT_THRESHOLD,
+            help='Fraction of the base time a change must exceed to count')
 
     ARGS = PARSER.parse_args()
 
+    # compare two earlier runs, failing if the new one regressed
+    if ARGS.compare:
+        with open(ARGS.compare[0], 'r') as base_file, \
+                open(ARGS.compare[1], 'r') as new_file:
+            NUM_REGRESSIONS = compare(json.load(base_file),
+                                      json.load(new_file), ARGS.alpha,
+                                      ARGS.threshold)
+        if NUM_REGRESSIONS:
+            print('{} cases regressed'.format(NUM_REGRESSIONS))
+            sys.exit(1)
+        sys.exit(0)
+
     # generate cases if necessary
     if ARGS.generate:
         utility.write_cases(
                 DEFAULT_NUM_CASES, DEFAULT_NUM_POINTS, DEFAULT_MAP_SIZE,
                 overwrite=True)
 
-    # run the binary on all the cases, print the time it takes
-    for case_filename in utility.iterate_cases():
-        print(utility.benchmark_solution(utility.PROJECT_BINARY, case_filename))
+    # run the binary on all the cases, print the times for each size
+    RESULTS = run_benchmarks(ARGS)
+    print_summary(RESULTS)
+    if ARGS.output:
+        with open(ARGS.output, 'w') as output_file:
+            json.dump(RESULTS, output_file, indent=1)
@@ -36,12 +36,12 @@ if __name__ == '__main__':
         with open(case_filename, 'r') as case_file, open(NAIVE_FILENAME,
                 'w') as naive_file:
                 naive_process = subprocess.Popen([utility.PROJECT_BINARY,
-                    '-m', 'NAIVETSP'], stdin=case_file, stdout=naive_file)
+                    '--solver=naive'], stdin=case_file, stdout=naive_file)
 
         with open(case_filename, 'r') as case_file, open(
                 OPT_FILENAME, 'w') as opt_file:
                 opt_process = subprocess.Popen([utility.PROJECT_BINARY,
-                    '-m', 'OPTTSP'], stdin=case_file, stdout=opt_file)
+                    '--solver=little'], stdin=case_file, stdout=opt_file)
 
         # wait for the processes to finish before reading output
         opt_process.wait()
@@ -50,10 +50,10 @@ if __name__ == '__main__':
     for case_filename in utility.iterate_cases():
 
         # benchmark naive and optimal solutions
-        naive_time = utility.benchmark_solution([utility.PROJECT_BINARY, '-m',
-            'NAIVETSP'], case_filename)
-        opt_time = utility.benchmark_solution([utility.PROJECT_BINARY, '-m',
-            'OPTTSP'], case_filename)
+        naive_time = utility.benchmark_solution([utility.PROJECT_BINARY,
+            '--solver=naive'], case_filename)
+        opt_time = utility.benchmark_solution([utility.PROJECT_BINARY,
+            '--solver=little'], case_filename)
 
         # calculate and print statistics
         diff = naive_time - opt_time
@@ -24,24 +24,84 @@ PROJECT_DIR = os.path.abspath(os.path.join(SCRIPT_DIR, os.pardir))
 BUILD_DIR = os.path.abspath(os.path.join(PROJECT_DIR, BUILD_DIR_NAME))
 PROJECT_BINARY = os.path.join(BUILD_DIR, 'src', 'littletsp')
 
-def benchmark_solution(command, case_filename):
+def benchmark_solution(command, case_filename, cpus=None):
     """
     Benchmark the command by seeing how long it takes to execute
 
     Args:
         command (list of strings): List of strings forming a system command
         case_filename: The filename of the case to pass input
+        cpus (set of ints): The cores to pin the command to, or None to let it
+            run anywhere (default None)
 
     Returns:
         The time it took to run the command
     """
+    return run_solution(command, case_filename, cpus=cpus)[0]
+
+
+def run_solution(command, case_filename, cpus=None):
+    """
+    Run the command on a case, timing it and keeping its output
+
+    Args:
+        command (list of strings): List of strings forming a system command
+        case_filename: The filename of the case to pass input
+        cpus (set of ints): The cores to pin the command to, or None to let it
+            run anywhere (default None)
+
+    Returns:
+        A tuple of the time it took to run the command, its standard output
+        and its standard error
+    """
+    def pin():
+        if cpus is not None and hasattr(os, 'sched_setaffinity'):
+            os.sched_setaffinity(0, cpus)
+
     with open(case_filename, 'r') as case_file:
         start_time = time.perf_counter()
         solution = subprocess.Popen(
-                command, stdin=case_file, stdout=subprocess.DEVNULL)
-        solution.wait()
+                command, stdin=case_file, stdout=subprocess.PIPE,
+                stderr=subprocess.PIPE, universal_newlines=True,
+                preexec_fn=pin)
+        output, error = solution.communicate()
         elapsed_time = time.perf_counter() - start_time
-    return elapsed_time
+    if solution.returncode != 0:
+        raise RuntimeError('{} failed on {}: {}'.format(
+                ' '.join(command), case_filename, error.strip()))
+    return elapsed_time, output, error
+
+
+def parse_statistics(error):
+    """
+    Parse the counters littletsp prints to standard error with --stats
+
+    Args:
+        error (string): The standard error of littletsp
+
+    Returns:
+        A dict from counter name to its integer value
+    """
+    statistics = {}
+    for line in error.splitlines():
+        match = re.match(r'^(?P<name>[\w.:]+): (?P<value>-?\d+)$', line)
+        if match:
+            statistics[match.group('name')] = int(match.group('value'))
+    return statistics
+
+
+def read_num_points(case_filename):
+    """
+    Read the number of points in a case
+
+    Args:
+        case_filename (string): The filename of the case
+
+    Returns:
+        The number of points the case has
+    """
+    with open(case_filename, 'r') as case_file:
+        return int(case_file.read().split()[1])
 
 
 def build_project():